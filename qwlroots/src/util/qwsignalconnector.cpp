@@ -0,0 +1,134 @@
+// Copyright (C) 2026 UnionTech Software Technology Co., Ltd.
+// SPDX-License-Identifier: Apache-2.0 OR LGPL-3.0-only OR GPL-2.0-only OR GPL-3.0-only
+
+#include "qwsignalconnector.h"
+
+#include <QMutex>
+
+#include <new>
+
+QW_BEGIN_NAMESPACE
+
+namespace {
+
+// The listeners are allocated from the slabs of SlabSize bytes, every slab
+// has its own free list. A slab is released once all its listeners are
+// returned, except the last one with free listeners, to not allocate a new
+// slab for every connect and disconnect.
+//
+// The pool is shared by all threads: a listener can be released on another
+// thread than where it's allocated, and it always goes back to its own slab.
+template <typename T>
+class Q_DECL_HIDDEN ListenerPool
+{
+    static constexpr std::size_t SlabSize = 4096;
+
+    union Node {
+        Node *next;
+        alignas(T) unsigned char storage[sizeof(T)];
+    };
+
+    // The header of the slab, the nodes follow it
+    struct Slab {
+        // The links in the list of the slabs with free listeners
+        Slab *prev;
+        Slab *next;
+        Node *freeList;
+        int used;
+    };
+
+    static constexpr std::size_t NodesOffset =
+        (sizeof(Slab) + alignof(Node) - 1) / alignof(Node) * alignof(Node);
+    static constexpr int NodesPerSlab = int((SlabSize - NodesOffset) / sizeof(Node));
+    static_assert(NodesPerSlab > 1);
+
+public:
+    T *allocate() {
+        QMutexLocker locker(&mutex);
+        if (!available)
+            link(createSlab());
+
+        Slab *slab = available;
+        Node *node = slab->freeList;
+        slab->freeList = node->next;
+        ++slab->used;
+        if (!slab->freeList)
+            unlink(slab);
+
+        return reinterpret_cast<T *>(node->storage);
+    }
+
+    void deallocate(T *p) {
+        Node *node = reinterpret_cast<Node *>(p);
+        // The slabs are aligned to their size
+        Slab *slab = reinterpret_cast<Slab *>(reinterpret_cast<quintptr>(node) & ~quintptr(SlabSize - 1));
+
+        QMutexLocker locker(&mutex);
+        if (!slab->freeList)
+            link(slab);
+        node->next = slab->freeList;
+        slab->freeList = node;
+
+        if (--slab->used == 0 && (slab->prev || slab->next)) {
+            unlink(slab);
+            ::operator delete(slab, std::align_val_t(SlabSize));
+        }
+    }
+
+private:
+    static Slab *createSlab() {
+        auto slab = static_cast<Slab *>(::operator new(SlabSize, std::align_val_t(SlabSize)));
+        slab->prev = nullptr;
+        slab->next = nullptr;
+        slab->freeList = nullptr;
+        slab->used = 0;
+        auto nodes = reinterpret_cast<Node *>(reinterpret_cast<char *>(slab) + NodesOffset);
+        for (int i = NodesPerSlab - 1; i >= 0; --i) {
+            nodes[i].next = slab->freeList;
+            slab->freeList = &nodes[i];
+        }
+        return slab;
+    }
+
+    void link(Slab *slab) {
+        slab->prev = nullptr;
+        slab->next = available;
+        if (available)
+            available->prev = slab;
+        available = slab;
+    }
+
+    void unlink(Slab *slab) {
+        if (slab->prev)
+            slab->prev->next = slab->next;
+        else
+            available = slab->next;
+        if (slab->next)
+            slab->next->prev = slab->prev;
+        slab->prev = nullptr;
+        slab->next = nullptr;
+    }
+
+    QBasicMutex mutex;
+    Slab *available = nullptr;
+};
+
+} // namespace
+
+// Trivially destructible, the listeners may be released by the static
+// objects destroyed after this pool
+template <typename T>
+Q_CONSTINIT static ListenerPool<T> listenerPool;
+
+qw_signal_connector::qw_signal_listener *qw_signal_connector::allocate()
+{
+    static_assert(std::is_trivially_destructible_v<qw_signal_listener>);
+    return listenerPool<qw_signal_listener>.allocate();
+}
+
+void qw_signal_connector::deallocate(qw_signal_listener *l)
+{
+    listenerPool<qw_signal_listener>.deallocate(l);
+}
+
+QW_END_NAMESPACE
@@ -4,84 +4,55 @@
 #pragma once
 
 #include <qwglobal.h>
-#include <QVector>
 
 #include <wayland-server-core.h>
-#include <functional>
+#include <cstring>
+#include <type_traits>
 
 QW_BEGIN_NAMESPACE
 
-class qw_signal_connector
+class QW_EXPORT qw_signal_connector
 {
+    // The listeners are linked to the address of the listeners list
+    Q_DISABLE_COPY_MOVE(qw_signal_connector)
+
     using SlotFun0 = void (*)(void *obj);
     using SlotFun1 = void (*)(void *obj, void *signalData);
     using SlotFun2 = void (*)(void *obj, void *signalData, void *data);
 
     struct qw_signal_listener {
-        wl_signal *signal;
         wl_listener l;
+        // the link in qw_signal_connector::listeners
+        wl_list link;
+        wl_signal *signal;
         void *object;
-        union {
-            SlotFun0 slot0;
-            SlotFun1 slot1;
-            SlotFun2 slot2;
-        };
-        void *data = nullptr;
-        // Non-null only for member-function-pointer connects.
-        // Heap-allocated to keep qw_signal_listener standard-layout so that
-        // wl_container_of (which uses offsetof) remains well-defined.
-        // Receives (wl signal data, user extra data); both may be null.
-        std::function<void(void *, void *)> *mfp_fn = nullptr;
-
-        ~qw_signal_listener() { delete mfp_fn; }
+        void *data;
+        // A function pointer or a member function pointer, stored as bytes to
+        // keep qw_signal_listener standard-layout so that wl_container_of
+        // (which uses offsetof) remains well-defined.
+        alignas(void*) unsigned char slot[2 * sizeof(void*)];
     };
 
 public:
     qw_signal_connector() {
-        listenerList.reserve(1);
+        wl_list_init(&listeners);
     }
 
     ~qw_signal_connector() {
         invalidate();
     }
 
-
     qw_signal_listener *connect(wl_signal *signal, void *object, SlotFun0 slot) {
-        qw_signal_listener *l = new qw_signal_listener;
-        listenerList.push_back(l);
-
-        l->signal = signal;
-        l->l.notify = callSlot0;
-        l->object = object;
-        l->slot0 = slot;
-        wl_signal_add(signal, &l->l);
-        return l;
+        return add(signal, object, nullptr, slot, callSlot0);
     }
 
     qw_signal_listener *connect(wl_signal *signal, void *object, SlotFun1 slot) {
-        qw_signal_listener *l = new qw_signal_listener;
-        listenerList.push_back(l);
-
-        l->signal = signal;
-        l->l.notify = callSlot1;
-        l->object = object;
-        l->slot1 = slot;
-        wl_signal_add(signal, &l->l);
-        return l;
+        return add(signal, object, nullptr, slot, callSlot1);
     }
 
     qw_signal_listener *connect(wl_signal *signal, void *object, SlotFun2 slot, void *data) {
         Q_ASSERT(data);
-        qw_signal_listener *l = new qw_signal_listener;
-        listenerList.push_back(l);
-
-        l->signal = signal;
-        l->l.notify = callSlot2;
-        l->object = object;
-        l->slot2 = slot;
-        l->data = data;
-        wl_signal_add(signal, &l->l);
-        return l;
+        return add(signal, object, data, slot, callSlot2);
     }
     template <typename T>
     inline qw_signal_listener *connect(wl_signal *signal, T *object, void (*slot)(T*)) {
@@ -110,103 +81,126 @@ public:
     // They are therefore semantically incompatible with free function pointers,
     // and any cast between the two types is undefined behavior.
     //
-    // Instead we capture the object pointer and MFP in a std::function lambda.
-    // The lambda is stored in qw_signal_listener::mfp_fn and invoked by the
-    // shared callMfp notify callback.  No type-punning involved.
+    // Instead the MFP is copied into qw_signal_listener::slot, and the notify
+    // callback is instantiated for the type of the MFP to call it on the object
+    // converted to TSlot.  No type-punning involved.
     template <typename T, typename TSlot>
     inline qw_signal_listener *connect(wl_signal *signal, T *object, void (TSlot::*slot)())
         requires ( std::is_base_of_v<TSlot,T> ) {
-        auto *typed_obj = static_cast<TSlot *>(object);
-        qw_signal_listener *l = new qw_signal_listener;
-        listenerList.push_back(l);
-        l->signal = signal;
-        l->l.notify = callMfp;
-        l->mfp_fn = new std::function<void(void *, void *)>([typed_obj, slot](void *, void *) {
-            (typed_obj->*slot)();
-        });
-        wl_signal_add(signal, &l->l);
-        return l;
+        return add(signal, static_cast<TSlot *>(object), nullptr, slot, callMfp0<TSlot>);
     }
     template <typename T, typename T1, typename TSlot>
     inline qw_signal_listener *connect(wl_signal *signal, T *object, void (TSlot::*slot)(T1*))
         requires ( std::is_base_of_v<TSlot,T> ) {
-        auto *typed_obj = static_cast<TSlot *>(object);
-        qw_signal_listener *l = new qw_signal_listener;
-        listenerList.push_back(l);
-        l->signal = signal;
-        l->l.notify = callMfp;
-        l->mfp_fn = new std::function<void(void *, void *)>([typed_obj, slot](void *sigdata, void *) {
-            (typed_obj->*slot)(static_cast<T1 *>(sigdata));
-        });
-        wl_signal_add(signal, &l->l);
-        return l;
+        return add(signal, static_cast<TSlot *>(object), nullptr, slot, callMfp1<TSlot, T1>);
     }
     template <typename T, typename T1, typename T2, typename T3, typename TSlot>
     inline qw_signal_listener *connect(wl_signal *signal, T *object, void (TSlot::*slot)(T1*, T2*), T3 *data)
         requires ( std::is_base_of_v<TSlot,T> ) {
-        auto *typed_obj = static_cast<TSlot *>(object);
-        qw_signal_listener *l = new qw_signal_listener;
-        listenerList.push_back(l);
-        l->signal = signal;
-        l->l.notify = callMfp;
-        l->data = static_cast<void *>(data);
-        l->mfp_fn = new std::function<void(void *, void *)>([typed_obj, slot](void *sigdata, void *extra) {
-            (typed_obj->*slot)(static_cast<T1 *>(sigdata), static_cast<T2 *>(extra));
-        });
-        wl_signal_add(signal, &l->l);
-        return l;
+        return add(signal, static_cast<TSlot *>(object), static_cast<void *>(data), slot,
+                   callMfp2<TSlot, T1, T2>);
     }
     void disconnect(qw_signal_listener *l) {
-        Q_ASSERT(listenerList.contains(l));
-        wl_list_remove(&l->l.link);
-        delete l;
-        listenerList.removeOne(l);
+        Q_ASSERT(contains(l));
+        release(l);
     }
     void disconnect(wl_signal *signal) {
-        auto tmpList = listenerList;
-        auto begin = tmpList.constBegin();
-        while (begin != tmpList.constEnd()) {
-            qw_signal_listener *l = *begin;
-            ++begin;
-
+        qw_signal_listener *l, *tmp;
+        wl_list_for_each_safe(l, tmp, &listeners, link) {
             if (signal == l->signal)
-                disconnect(l);
+                release(l);
         }
     }
     void invalidate() {
-        QVector<qw_signal_listener*> tmpList;
-        tmpList.swap(listenerList);
-        auto begin = tmpList.constBegin();
-        while (begin != tmpList.constEnd()) {
-            qw_signal_listener *l = *begin;
-            wl_list_remove(&l->l.link);
-            ++begin;
-            delete l;
+        qw_signal_listener *l, *tmp;
+        wl_list_for_each_safe(l, tmp, &listeners, link) {
+            release(l);
         }
     }
 
 private:
+    // The listeners are allocated from a process wide pool of slabs and
+    // recycled, the empty slabs are released.
+    static qw_signal_listener *allocate();
+    static void deallocate(qw_signal_listener *l);
+
+    template <typename Slot>
+    inline qw_signal_listener *add(wl_signal *signal, void *object, void *data,
+                                   Slot slot, wl_notify_func_t notify) {
+        static_assert(sizeof(Slot) <= sizeof(qw_signal_listener::slot),
+                      "The slot doesn't fit in qw_signal_listener");
+        qw_signal_listener *l = allocate();
+        wl_list_insert(listeners.prev, &l->link);
+
+        l->signal = signal;
+        l->l.notify = notify;
+        l->object = object;
+        l->data = data;
+        std::memcpy(l->slot, &slot, sizeof(Slot));
+        wl_signal_add(signal, &l->l);
+        return l;
+    }
+
+    inline void release(qw_signal_listener *l) {
+        wl_list_remove(&l->l.link);
+        wl_list_remove(&l->link);
+        deallocate(l);
+    }
+
+    bool contains(qw_signal_listener *listener) const {
+        qw_signal_listener *l;
+        wl_list_for_each(l, &listeners, link) {
+            if (l == listener)
+                return true;
+        }
+        return false;
+    }
+
+    template <typename Slot>
+    static inline Slot slotOf(const qw_signal_listener *listener) {
+        Slot slot;
+        std::memcpy(&slot, listener->slot, sizeof(Slot));
+        return slot;
+    }
+
     static void callSlot0(wl_listener *wl_listener, void *) {
         qw_signal_listener *listener = wl_container_of(wl_listener, listener, l);
-        listener->slot0(listener->object);
+        slotOf<SlotFun0>(listener)(listener->object);
     }
 
     static void callSlot1(wl_listener *wl_listener, void *data) {
         qw_signal_listener *listener = wl_container_of(wl_listener, listener, l);
-        listener->slot1(listener->object, data);
+        slotOf<SlotFun1>(listener)(listener->object, data);
     }
 
     static void callSlot2(wl_listener *wl_listener, void *data) {
         qw_signal_listener *listener = wl_container_of(wl_listener, listener, l);
-        listener->slot2(listener->object, data, listener->data);
+        slotOf<SlotFun2>(listener)(listener->object, data, listener->data);
+    }
+
+    template <typename TSlot>
+    static void callMfp0(wl_listener *wl_listener, void *) {
+        qw_signal_listener *listener = wl_container_of(wl_listener, listener, l);
+        const auto slot = slotOf<void (TSlot::*)()>(listener);
+        (static_cast<TSlot *>(listener->object)->*slot)();
+    }
+
+    template <typename TSlot, typename T1>
+    static void callMfp1(wl_listener *wl_listener, void *data) {
+        qw_signal_listener *listener = wl_container_of(wl_listener, listener, l);
+        const auto slot = slotOf<void (TSlot::*)(T1*)>(listener);
+        (static_cast<TSlot *>(listener->object)->*slot)(static_cast<T1 *>(data));
     }
 
-    static void callMfp(wl_listener *wl_listener, void *data) {
+    template <typename TSlot, typename T1, typename T2>
+    static void callMfp2(wl_listener *wl_listener, void *data) {
         qw_signal_listener *listener = wl_container_of(wl_listener, listener, l);
-        (*listener->mfp_fn)(data, listener->data);
+        const auto slot = slotOf<void (TSlot::*)(T1*, T2*)>(listener);
+        (static_cast<TSlot *>(listener->object)->*slot)(static_cast<T1 *>(data),
+                                                        static_cast<T2 *>(listener->data));
     }
 
-    QVector<qw_signal_listener*> listenerList;
+    wl_list listeners;
 };
 
 QW_END_NAMESPACE
@@ -0,0 +1,87 @@
+// Copyright (C) 2026 UnionTech Software Technology Co., Ltd.
+// SPDX-License-Identifier: Apache-2.0 OR LGPL-3.0-only OR GPL-2.0-only OR GPL-3.0-only
+
+#include "surfaceclient.h"
+
+#include <wayland-client.h>
+
+#include <cstring>
+
+#include <poll.h>
+
+static void handleGlobal(void *data, wl_registry *registry, uint32_t name,
+                         const char *interface, uint32_t)
+{
+    if (std::strcmp(interface, wl_compositor_interface.name) != 0)
+        return;
+    auto compositor = static_cast<wl_compositor **>(data);
+    *compositor = static_cast<wl_compositor *>(
+        wl_registry_bind(registry, name, &wl_compositor_interface, 4));
+}
+
+static void handleGlobalRemove(void *, wl_registry *, uint32_t)
+{
+}
+
+static const wl_registry_listener registryListener = {
+    .global = handleGlobal,
+    .global_remove = handleGlobalRemove,
+};
+
+SurfaceClient::SurfaceClient(int fd)
+    : m_display(wl_display_connect_to_fd(fd))
+{
+    if (!m_display)
+        return;
+    m_registry = wl_display_get_registry(m_display);
+    wl_registry_add_listener(m_registry, &registryListener, &m_compositor);
+}
+
+SurfaceClient::~SurfaceClient()
+{
+    if (!m_display)
+        return;
+    destroySurface();
+    if (m_compositor)
+        wl_compositor_destroy(m_compositor);
+    wl_registry_destroy(m_registry);
+    wl_display_disconnect(m_display);
+}
+
+bool SurfaceClient::isConnected() const
+{
+    return m_display && wl_display_get_error(m_display) == 0;
+}
+
+bool SurfaceClient::hasCompositor() const
+{
+    return m_compositor;
+}
+
+void SurfaceClient::createSurface()
+{
+    m_surface = wl_compositor_create_surface(m_compositor);
+    wl_surface_commit(m_surface);
+}
+
+void SurfaceClient::destroySurface()
+{
+    if (!m_surface)
+        return;
+    wl_surface_destroy(m_surface);
+    m_surface = nullptr;
+}
+
+void SurfaceClient::dispatch()
+{
+    wl_display_flush(m_display);
+    while (wl_display_prepare_read(m_display) != 0)
+        wl_display_dispatch_pending(m_display);
+
+    pollfd pfd = { wl_display_get_fd(m_display), POLLIN, 0 };
+    if (poll(&pfd, 1, 0) > 0)
+        wl_display_read_events(m_display);
+    else
+        wl_display_cancel_read(m_display);
+    wl_display_dispatch_pending(m_display);
+}
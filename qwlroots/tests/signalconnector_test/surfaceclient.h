@@ -0,0 +1,32 @@
+// Copyright (C) 2026 UnionTech Software Technology Co., Ltd.
+// SPDX-License-Identifier: Apache-2.0 OR LGPL-3.0-only OR GPL-2.0-only OR GPL-3.0-only
+
+#pragma once
+
+struct wl_display;
+struct wl_registry;
+struct wl_compositor;
+struct wl_surface;
+
+// A wayland client creating and destroying a wl_surface, kept out of the test
+// because the client and the server protocol headers can't be included together
+class SurfaceClient
+{
+public:
+    explicit SurfaceClient(int fd);
+    ~SurfaceClient();
+
+    bool isConnected() const;
+    bool hasCompositor() const;
+
+    void createSurface();
+    void destroySurface();
+    // Sends the requests and handles the events received, never blocks
+    void dispatch();
+
+private:
+    wl_display *m_display = nullptr;
+    wl_registry *m_registry = nullptr;
+    wl_compositor *m_compositor = nullptr;
+    wl_surface *m_surface = nullptr;
+};
@@ -0,0 +1,307 @@
+// Copyright (C) 2026 UnionTech Software Technology Co., Ltd.
+// SPDX-License-Identifier: Apache-2.0 OR LGPL-3.0-only OR GPL-2.0-only OR GPL-3.0-only
+
+#include "surfaceclient.h"
+
+#include <qwsignalconnector.h>
+#include <qwdisplay.h>
+#include <qwcompositor.h>
+
+#include <QtTest>
+
+#include <atomic>
+#include <cstdlib>
+#include <new>
+#include <thread>
+
+#include <sys/socket.h>
+
+QW_USE_NAMESPACE
+
+// Count the heap allocations and deallocations while countAllocations is set
+static bool countAllocations = false;
+static std::atomic<int> allocations = 0;
+static std::atomic<int> deallocations = 0;
+
+void *operator new(std::size_t size)
+{
+    if (countAllocations)
+        ++allocations;
+    if (void *p = std::malloc(size ? size : 1))
+        return p;
+    throw std::bad_alloc();
+}
+
+void operator delete(void *p) noexcept
+{
+    if (p && countAllocations)
+        ++deallocations;
+    std::free(p);
+}
+
+void operator delete(void *p, std::size_t) noexcept
+{
+    if (p && countAllocations)
+        ++deallocations;
+    std::free(p);
+}
+
+void *operator new(std::size_t size, std::align_val_t alignment)
+{
+    if (countAllocations)
+        ++allocations;
+    if (void *p = std::aligned_alloc(std::size_t(alignment), size))
+        return p;
+    throw std::bad_alloc();
+}
+
+void operator delete(void *p, std::align_val_t) noexcept
+{
+    if (p && countAllocations)
+        ++deallocations;
+    std::free(p);
+}
+
+class Q_DECL_HIDDEN Receiver
+{
+public:
+    void onNotify0() { ++count0; }
+    void onNotify1(int *value) { sum += *value; }
+    void onNotify2(int *value, int *factor) { sum += *value * *factor; }
+
+    static void staticNotify(Receiver *self) { ++self->count0; }
+
+    int count0 = 0;
+    int sum = 0;
+};
+
+class Q_DECL_HIDDEN testSignalConnector : public QObject
+{
+    Q_OBJECT
+public:
+    testSignalConnector() = default;
+    ~testSignalConnector() override = default;
+
+private Q_SLOTS:
+    void testConnect();
+    void testDisconnect();
+    void testDisconnectInSlot();
+    void testAllocations();
+    void testSurfaceAllocations();
+    void testReleaseOnOtherThread();
+    void benchmarkConnect();
+};
+
+void testSignalConnector::testConnect()
+{
+    wl_signal signal;
+    wl_signal_init(&signal);
+    Receiver r;
+    int factor = 10;
+    qw_signal_connector sc;
+    sc.connect(&signal, &r, &Receiver::onNotify0);
+    sc.connect(&signal, &r, &Receiver::onNotify1);
+    sc.connect(&signal, &r, &Receiver::onNotify2, &factor);
+    sc.connect(&signal, &r, &Receiver::staticNotify);
+
+    int value = 2;
+    wl_signal_emit_mutable(&signal, &value);
+    QCOMPARE(r.count0, 2);
+    QCOMPARE(r.sum, 22);
+
+    sc.invalidate();
+    QVERIFY(wl_list_empty(&signal.listener_list));
+    wl_signal_emit_mutable(&signal, &value);
+    QCOMPARE(r.count0, 2);
+}
+
+void testSignalConnector::testDisconnect()
+{
+    wl_signal signal1, signal2;
+    wl_signal_init(&signal1);
+    wl_signal_init(&signal2);
+    Receiver r;
+    int value = 1;
+    {
+        qw_signal_connector sc;
+        auto l = sc.connect(&signal1, &r, &Receiver::onNotify0);
+        sc.connect(&signal1, &r, &Receiver::onNotify1);
+        sc.connect(&signal2, &r, &Receiver::onNotify0);
+        sc.connect(&signal2, &r, &Receiver::onNotify1);
+
+        sc.disconnect(l);
+        wl_signal_emit_mutable(&signal1, &value);
+        QCOMPARE(r.count0, 0);
+        QCOMPARE(r.sum, 1);
+
+        sc.disconnect(&signal1);
+        QVERIFY(wl_list_empty(&signal1.listener_list));
+        wl_signal_emit_mutable(&signal2, &value);
+        QCOMPARE(r.count0, 1);
+        QCOMPARE(r.sum, 2);
+    }
+    // Disconnected by the destructor
+    QVERIFY(wl_list_empty(&signal2.listener_list));
+}
+
+void testSignalConnector::testDisconnectInSlot()
+{
+    struct Context {
+        qw_signal_connector sc;
+        wl_signal signal;
+        int count = 0;
+
+        void onNotify() {
+            ++count;
+            sc.disconnect(&signal);
+        }
+    } context;
+    wl_signal_init(&context.signal);
+    context.sc.connect(&context.signal, &context, &Context::onNotify);
+    context.sc.connect(&context.signal, &context, &Context::onNotify);
+
+    wl_signal_emit_mutable(&context.signal, nullptr);
+    QCOMPARE(context.count, 1);
+    QVERIFY(wl_list_empty(&context.signal.listener_list));
+}
+
+void testSignalConnector::testAllocations()
+{
+    constexpr int Signals = 16;
+    wl_signal signals[Signals];
+    for (auto &signal : signals)
+        wl_signal_init(&signal);
+    Receiver r;
+    int factor = 1;
+
+    const auto connectAll = [&] {
+        auto sc = std::make_unique<qw_signal_connector>();
+        for (auto &signal : signals) {
+            sc->connect(&signal, &r, &Receiver::onNotify0);
+            sc->connect(&signal, &r, &Receiver::onNotify1);
+            sc->connect(&signal, &r, &Receiver::onNotify2, &factor);
+        }
+        sc.reset();
+    };
+
+    // Fill the pool of this thread
+    connectAll();
+
+    allocations = 0;
+    countAllocations = true;
+    for (int i = 0; i < 100; ++i)
+        connectAll();
+    countAllocations = false;
+
+    qInfo() << "Allocations per connector of" << Signals * 3 << "listeners:"
+            << allocations / 100.0;
+    // Only the connector itself
+    QCOMPARE(allocations.load(), 100);
+}
+
+// The listeners of a surface, its qw_surface and the connectors are all
+// released after the surface is destroyed
+void testSignalConnector::testSurfaceAllocations()
+{
+    qw_display display;
+    auto compositor = qw_compositor::create(display, 4, nullptr);
+    QVERIFY(compositor);
+    auto loop = display.get_event_loop();
+
+    int fds[2];
+    QCOMPARE(socketpair(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0, fds), 0);
+    QVERIFY(wl_client_create(display, fds[0]));
+    SurfaceClient client(fds[1]);
+
+    int surfaces = 0;
+    QObject::connect(compositor, &qw_compositor::new_surface, [&surfaces](wlr_surface *surface) {
+        // The wrapper is created as waylib does for every new surface
+        qw_surface::from(surface);
+        ++surfaces;
+    });
+
+    const auto roundtrip = [&] {
+        for (int i = 0; i < 4; ++i) {
+            client.dispatch();
+            wl_event_loop_dispatch(loop, 0);
+            display.flush_clients();
+        }
+        // qw_surface is deleted by deleteLater() after its wlr_surface is destroyed
+        QCoreApplication::sendPostedEvents(nullptr, QEvent::DeferredDelete);
+    };
+    const auto surfaceLifecycle = [&] {
+        client.createSurface();
+        roundtrip();
+        client.destroySurface();
+        roundtrip();
+    };
+
+    roundtrip();
+    QVERIFY(client.isConnected());
+    QVERIFY(client.hasCompositor());
+
+    // Fill the pool of this thread and the caches of Qt
+    surfaceLifecycle();
+    QCOMPARE(surfaces, 1);
+
+    allocations = 0;
+    deallocations = 0;
+    countAllocations = true;
+    for (int i = 0; i < 10; ++i)
+        surfaceLifecycle();
+    countAllocations = false;
+
+    QCOMPARE(surfaces, 11);
+    QVERIFY(client.isConnected());
+    qInfo() << "Allocations per surface:" << allocations / 10.0;
+    // Nothing is left after the surfaces are destroyed
+    QCOMPARE(allocations.load(), deallocations.load());
+}
+
+// The listeners connected on a finished thread are released on this thread,
+// and the slabs are freed when they are empty
+void testSignalConnector::testReleaseOnOtherThread()
+{
+    constexpr int Listeners = 1000;
+    wl_signal signal;
+    wl_signal_init(&signal);
+    Receiver r;
+    qw_signal_connector sc;
+
+    allocations = 0;
+    deallocations = 0;
+    countAllocations = true;
+    std::thread thread([&] {
+        for (int i = 0; i < Listeners; ++i)
+            sc.connect(&signal, &r, &Receiver::onNotify0);
+    });
+    thread.join();
+
+    wl_signal_emit(&signal, nullptr);
+    QCOMPARE(r.count0, Listeners);
+
+    sc.invalidate();
+    countAllocations = false;
+
+    QVERIFY(allocations > 1);
+    // Only one empty slab is kept for the next connections
+    QVERIFY(allocations - deallocations <= 1);
+}
+
+void testSignalConnector::benchmarkConnect()
+{
+    wl_signal signal;
+    wl_signal_init(&signal);
+    Receiver r;
+
+    QBENCHMARK {
+        qw_signal_connector sc;
+        for (int i = 0; i < 32; ++i)
+            sc.connect(&signal, &r, &Receiver::onNotify1);
+        sc.invalidate();
+    }
+}
+
+QTEST_GUILESS_MAIN(testSignalConnector)
+
+#include "test_signalconnector.moc"
@@ -99,6 +99,8 @@ OutputItem {
 
         anchors.centerIn: parent
         depends: [primaryScreenViewport]
+        // The content is rendered only if the source's buffer can't be shown
+        mirrorSource: primaryScreenViewport
         devicePixelRatio: outputItem.devicePixelRatio
         input: content
         output: outputItem.output
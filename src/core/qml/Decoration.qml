@@ -18,7 +18,8 @@ Item {
     height: shadow.boundingRect.height
 
     MouseArea {
-        enabled: surface.type !== SurfaceWrapper.Type.XdgPopup
+        enabled: surface
+                    && surface.type !== SurfaceWrapper.Type.XdgPopup
                     && surface.type !== SurfaceWrapper.Type.Layer
                     && surface.type !== SurfaceWrapper.Type.SplashScreen
         property int edges: 0
@@ -66,17 +67,18 @@ Item {
 
     XdgShadow {
         id: shadow
-        width: surface.width
-        height: surface.height
-        cornerRadius: surface.radius
+        // The surface is null when the decoration is in the recycle pool
+        width: surface ? surface.width : 0
+        height: surface ? surface.height : 0
+        cornerRadius: surface ? surface.radius : 0
         anchors.centerIn: parent
     }
 
     Border {
-        visible: surface.visibleDecoration
-        parent: surface.surfaceItem ? surface.surfaceItem : surface.prelaunchSplash
+        visible: surface && surface.visibleDecoration
+        parent: surface ? (surface.surfaceItem ? surface.surfaceItem : surface.prelaunchSplash) : root
         z: SurfaceItem.ZOrder.ContentItem + 1
         anchors.fill: parent
-        radius: surface.radius
+        radius: surface ? surface.radius : 0
     }
 }
@@ -520,6 +520,9 @@ Item {
                 live: true
                 hideSource: false
                 smooth: true
+                // Not a full size texture of the window, sampled by mipmap
+                mipmap: true
+                textureSize: Qt.size(Math.ceil(width) * 2, Math.ceil(height) * 2)
                 sourceItem: wrapper
             }
         }
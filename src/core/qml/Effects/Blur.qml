@@ -10,9 +10,11 @@ import Treeland
 RenderBufferBlitter {
     property real radius: 0
     property bool radiusEnabled: radius > 0
-    property alias blurMax: blur.blurMax
-    property alias blurEnabled: blur.blurEnabled
-    property alias multiplier: blur.blurMultiplier
+    property int blurMax: 64
+    property bool blurEnabled: true
+    property real multiplier: 0
+    // MultiEffect has no software renderer path, blur on the CPU instead
+    readonly property bool softwareBlur: GraphicsInfo.api === GraphicsInfo.Software
 
     id: blitter
     z: parent.z ? parent.z - 1 : -1
@@ -20,21 +22,33 @@ RenderBufferBlitter {
     MultiEffect {
         id: blur
         anchors.fill: parent
-        layer.enabled: blitter.radiusEnabled
+        visible: !blitter.softwareBlur
+        layer.enabled: blitter.radiusEnabled && visible
         smooth: blitter.radiusEnabled
         opacity: blitter.radiusEnabled ? 0 : parent.opacity
         source: blitter.content
         autoPaddingEnabled: false
-        blurEnabled: true
+        blurEnabled: blitter.blurEnabled && visible
         blur: 1.0
-        blurMax: 64
+        blurMax: blitter.blurMax
+        blurMultiplier: blitter.multiplier
         saturation: 0.2
     }
 
+    TBlurEffect {
+        anchors.fill: parent
+        visible: blitter.softwareBlur
+        sourceItem: blitter.softwareBlur ? blitter.content : null
+        hideSource: true
+        blurRadius: blitter.blurEnabled ? blitter.blurMax * (1 + blitter.multiplier) : 0
+        radius: blitter.radiusEnabled ? blitter.radius : 0
+        antialiasing: true
+    }
+
     Loader {
         x: blur.x
         y: blur.y
-        active: blitter.radiusEnabled
+        active: blitter.radiusEnabled && !blitter.softwareBlur
         sourceComponent: Shape {
             anchors.fill: parent
             preferredRendererType: Shape.CurveRenderer
@@ -37,8 +37,8 @@ Item {
 
     Rectangle {
         id: fpsDisplay
-        width: Math.max(200 * scaleFactor, 180)
-        height: Math.max(80 * scaleFactor, 70)
+        width: Math.max(260 * scaleFactor, 240)
+        height: Math.max(120 * scaleFactor, 100)
         color: "transparent"
         radius: 8 * scaleFactor
         border.color: "transparent"
@@ -87,6 +87,33 @@ Item {
                 style: Text.Raised
                 styleColor: "#FFFFFF"
             }
+
+            Text {
+                id: timingLabel
+                text: fpsManager ? qsTr("Sync %1 / Render %2 / Commit %3 ms")
+                                   .arg(fpsManager.syncTime.toFixed(1))
+                                   .arg(fpsManager.renderTime.toFixed(1))
+                                   .arg(fpsManager.commitTime.toFixed(1)) : ""
+                color: "#000000"
+                font.pixelSize: Math.max(12 * scaleFactor, 10)
+                font.family: "monospace"
+                horizontalAlignment: Text.AlignHCenter
+                anchors.horizontalCenter: parent.horizontalCenter
+                style: Text.Raised
+                styleColor: "#FFFFFF"
+            }
+
+            Text {
+                id: droppedLabel
+                text: qsTr("Dropped: %1").arg(fpsManager ? fpsManager.droppedFrames : 0)
+                color: "#000000"
+                font.pixelSize: Math.max(12 * scaleFactor, 10)
+                font.family: "monospace"
+                horizontalAlignment: Text.AlignHCenter
+                anchors.horizontalCenter: parent.horizontalCenter
+                style: Text.Raised
+                styleColor: "#FFFFFF"
+            }
         }
     }
 }
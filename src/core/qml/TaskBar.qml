@@ -28,6 +28,7 @@ ListView {
         SurfaceProxy {
             id: proxy
             live: true
+            thumbnail: true
             surface: parent.surface
             maxSize: Qt.size(250, 150)
         }
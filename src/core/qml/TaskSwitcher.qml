@@ -18,7 +18,7 @@ Item {
     readonly property QtObject model: Helper.workspace.currentFilter
 
     // control all switch item
-    property bool enableBlur: GraphicsInfo.api !== GraphicsInfo.Software
+    property bool enableBlur: true
     property bool enableBorders: true
     property bool enableShadows: GraphicsInfo.api !== GraphicsInfo.Software
     property bool enableRadius: true
@@ -11,8 +11,8 @@ D.BoxShadow {
                                              width + 2 * shadow.shadowBlur,
                                              height + 2 * shadow.shadowBlur)
 
-    width: parent.width
-    height: parent.height
+    width: parent ? parent.width : 0
+    height: parent ? parent.height : 0
     shadowColor: Qt.rgba(0, 0, 0, 0.4)
     shadowOffsetY: 10
     shadowBlur: 40
@@ -13,10 +13,139 @@
 #include <woutput.h>
 #include <woutputitem.h>
 
+#include <private/qqmlproperty_p.h>
+
+#include <QQmlIncubationController>
+#include <QQmlIncubator>
 #include <QQuickItem>
+#include <QQuickWindow>
+#include <QTimer>
 
 Q_LOGGING_CATEGORY(qLcQmlEngine, "treeland.qmlEngine")
 
+// The released decorations and shadows are kept for the next windows
+static constexpr qsizetype MaxPoolSize = 8;
+
+static int incubationBudget()
+{
+    bool ok = false;
+    const int budget = qEnvironmentVariableIntValue("TREELAND_QML_INCUBATION_BUDGET", &ok);
+    return ok && budget > 0 ? budget : 4;
+}
+
+// Incubate the asynchronous components in every frame of the render window, at most
+// the budget milliseconds in a frame, the timer keeps it going when nothing is rendering.
+class Q_DECL_HIDDEN IncubationController : public QObject, public QQmlIncubationController
+{
+public:
+    explicit IncubationController(QObject *parent)
+        : QObject(parent)
+        , m_budget(incubationBudget())
+    {
+        m_fallbackTimer.setSingleShot(true);
+        m_fallbackTimer.setInterval(100);
+        connect(&m_fallbackTimer, &QTimer::timeout, this, &IncubationController::incubate);
+    }
+
+    void setWindow(QQuickWindow *window)
+    {
+        if (m_window)
+            m_window->disconnect(this);
+        m_window = window;
+        if (m_window) {
+            connect(m_window,
+                    &QQuickWindow::afterAnimating,
+                    this,
+                    &IncubationController::incubate);
+        }
+    }
+
+protected:
+    void incubatingObjectCountChanged(int count) override
+    {
+        if (count > 0)
+            scheduleIncubate();
+        else
+            m_fallbackTimer.stop();
+    }
+
+private:
+    void scheduleIncubate()
+    {
+        if (m_window)
+            m_window->update();
+        m_fallbackTimer.start();
+    }
+
+    void incubate()
+    {
+        if (incubatingObjectCount() == 0)
+            return;
+        incubateFor(m_budget);
+        if (incubatingObjectCount() > 0)
+            scheduleIncubate();
+    }
+
+    const int m_budget;
+    QPointer<QQuickWindow> m_window;
+    QTimer m_fallbackTimer;
+};
+
+class Q_DECL_HIDDEN ItemIncubator : public QQmlIncubator
+{
+public:
+    ItemIncubator(QmlEngine *engine,
+                  QQuickItem *parent,
+                  const QVariantMap &properties,
+                  std::function<void(QQuickItem *)> callback)
+        : QQmlIncubator(QQmlIncubator::Asynchronous)
+        , m_engine(engine)
+        , m_parent(parent)
+        , m_callback(std::move(callback))
+    {
+        if (!properties.isEmpty())
+            setInitialProperties(properties);
+    }
+
+protected:
+    void statusChanged(Status status) override
+    {
+        if (status == Loading)
+            return;
+
+        if (status == Ready) {
+            auto item = qobject_cast<QQuickItem *>(object());
+            if (!item) {
+                qCCritical(qLcQmlEngine) << "The incubated object isn't a QQuickItem:" << object();
+                delete object();
+            } else if (!m_parent) {
+                // The parent was destroyed while incubating
+                delete item;
+            } else {
+                QQmlEngine::setObjectOwnership(item, QQmlEngine::objectOwnership(m_parent));
+                item->setParent(m_parent);
+                item->setParentItem(m_parent);
+                m_callback(item);
+            }
+        } else if (status == Error) {
+            qCCritical(qLcQmlEngine) << "Can't incubate component:" << errors();
+        }
+
+        // Not safe to delete self in the incubating
+        QMetaObject::invokeMethod(
+            m_engine,
+            [this] {
+                delete this;
+            },
+            Qt::QueuedConnection);
+    }
+
+private:
+    QmlEngine *m_engine;
+    QPointer<QQuickItem> m_parent;
+    std::function<void(QQuickItem *)> m_callback;
+};
+
 QmlEngine::QmlEngine(QObject *parent)
     : QQmlApplicationEngine(parent)
     , titleBarComponent(this, "Treeland", "TitleBar")
@@ -45,6 +174,8 @@ QmlEngine::QmlEngine(QObject *parent)
     , fpsDisplayComponent(this, "Treeland", "FpsDisplay")
     , prelaunchSplashComponent(this, "Treeland", "PrelaunchSplash")
 {
+    incubationController = new IncubationController(this);
+    setIncubationController(incubationController);
 }
 
 QQuickItem *QmlEngine::createComponent(QQmlComponent &component,
@@ -68,6 +199,48 @@ QQuickItem *QmlEngine::createComponent(QQmlComponent &component,
     return item;
 }
 
+void QmlEngine::createComponentAsync(QQmlComponent &component,
+                                     QQuickItem *parent,
+                                     const QVariantMap &properties,
+                                     std::function<void(QQuickItem *)> callback)
+{
+    auto incubator = new ItemIncubator(this, parent, properties, std::move(callback));
+    component.create(*incubator, qmlContext(parent));
+}
+
+void QmlEngine::setIncubationWindow(QQuickWindow *window)
+{
+    incubationController->setWindow(window);
+}
+
+QQuickItem *QmlEngine::takeFromPool(QList<QPointer<QQuickItem>> &pool, QQuickItem *parent)
+{
+    while (!pool.isEmpty()) {
+        QQuickItem *item = pool.takeLast();
+        if (!item)
+            continue;
+        QQmlEngine::setObjectOwnership(item, QQmlEngine::objectOwnership(parent));
+        item->setParent(parent);
+        item->setParentItem(parent);
+        return item;
+    }
+
+    return nullptr;
+}
+
+void QmlEngine::releaseToPool(QList<QPointer<QQuickItem>> &pool, QQuickItem *item)
+{
+    if (pool.size() >= MaxPoolSize) {
+        item->deleteLater();
+        return;
+    }
+
+    QQmlEngine::setObjectOwnership(item, QQmlEngine::CppOwnership);
+    item->setParentItem(nullptr);
+    item->setParent(this);
+    pool.append(item);
+}
+
 QQuickItem *QmlEngine::createTitleBar(SurfaceWrapper *surface, QQuickItem *parent)
 {
     return createComponent(titleBarComponent,
@@ -77,11 +250,54 @@ QQuickItem *QmlEngine::createTitleBar(SurfaceWrapper *surface, QQuickItem *paren
 
 QQuickItem *QmlEngine::createDecoration(SurfaceWrapper *surface, QQuickItem *parent)
 {
+    if (auto decoration = takeFromPool(decorationPool, parent)) {
+        decoration->setProperty("surface", QVariant::fromValue(surface));
+        return decoration;
+    }
+
     return createComponent(decorationComponent,
                            parent,
                            { { "surface", QVariant::fromValue(surface) } });
 }
 
+void QmlEngine::createDecorationAsync(SurfaceWrapper *surface,
+                                      QQuickItem *parent,
+                                      std::function<void(QQuickItem *)> callback)
+{
+    if (auto decoration = takeFromPool(decorationPool, parent)) {
+        decoration->setProperty("surface", QVariant::fromValue(surface));
+        callback(decoration);
+        return;
+    }
+
+    // The initial properties are applied in a later incubation step, the
+    // surface may be destroyed by then, set it after the decoration is ready
+    createComponentAsync(decorationComponent,
+                         parent,
+                         { { "surface", QVariant::fromValue<SurfaceWrapper *>(nullptr) } },
+                         [this, surface = QPointer<SurfaceWrapper>(surface),
+                          callback = std::move(callback)](QQuickItem *decoration) {
+                             if (!surface) {
+                                 releaseDecoration(decoration);
+                                 return;
+                             }
+                             decoration->setProperty("surface", QVariant::fromValue(surface.get()));
+                             callback(decoration);
+                         });
+}
+
+void QmlEngine::releaseDecoration(QQuickItem *decoration)
+{
+    // The visible binding is broken by the prelaunch splash, can't be reused
+    if (!QQmlPropertyPrivate::binding(QQmlProperty(decoration, "visible"))) {
+        decoration->deleteLater();
+        return;
+    }
+
+    decoration->setProperty("surface", QVariant::fromValue<SurfaceWrapper *>(nullptr));
+    releaseToPool(decorationPool, decoration);
+}
+
 QObject *QmlEngine::createWindowMenu(QObject *parent)
 {
     auto context = qmlContext(parent);
@@ -109,9 +325,25 @@ QQuickItem *QmlEngine::createTaskBar(Output *output, QQuickItem *parent)
 
 QQuickItem *QmlEngine::createXdgShadow(QQuickItem *parent)
 {
+    // The size is bound to the parent item, follows the new parent
+    if (auto shadow = takeFromPool(xdgShadowPool, parent))
+        return shadow;
+
     return createComponent(xdgShadowComponent, parent);
 }
 
+void QmlEngine::releaseXdgShadow(QQuickItem *shadow)
+{
+    // The size doesn't follow the next parent if its binding is broken
+    if (!QQmlPropertyPrivate::binding(QQmlProperty(shadow, "width"))
+        || !QQmlPropertyPrivate::binding(QQmlProperty(shadow, "height"))) {
+        shadow->deleteLater();
+        return;
+    }
+
+    releaseToPool(xdgShadowPool, shadow);
+}
+
 QQuickItem *QmlEngine::createTaskSwitcher(Output *output, QQuickItem *parent)
 {
     return createComponent(taskSwitchComponent,
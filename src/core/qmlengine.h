@@ -8,11 +8,15 @@
 #include <qwglobal.h>
 
 #include <QColor>
+#include <QPointer>
 #include <QQmlApplicationEngine>
 #include <QQmlComponent>
 
+#include <functional>
+
 QT_BEGIN_NAMESPACE
 class QQuickItem;
+class QQuickWindow;
 QT_END_NAMESPACE
 
 WAYLIB_SERVER_BEGIN_NAMESPACE
@@ -30,6 +34,8 @@ QW_BEGIN_NAMESPACE
 class qw_buffer;
 QW_END_NAMESPACE
 
+class IncubationController;
+
 class QmlEngine : public QQmlApplicationEngine
 {
     Q_OBJECT
@@ -39,12 +45,23 @@ public:
     QQuickItem *createComponent(QQmlComponent &component,
                                 QQuickItem *parent,
                                 const QVariantMap &properties = QVariantMap());
+    void createComponentAsync(QQmlComponent &component,
+                              QQuickItem *parent,
+                              const QVariantMap &properties,
+                              std::function<void(QQuickItem *)> callback);
+    void setIncubationWindow(QQuickWindow *window);
+
     QQuickItem *createTitleBar(SurfaceWrapper *surface, QQuickItem *parent);
     QQuickItem *createDecoration(SurfaceWrapper *surface, QQuickItem *parent);
+    void createDecorationAsync(SurfaceWrapper *surface,
+                               QQuickItem *parent,
+                               std::function<void(QQuickItem *)> callback);
+    void releaseDecoration(QQuickItem *decoration);
     QObject *createWindowMenu(QObject *parent);
     QQuickItem *createBorder(SurfaceWrapper *surface, QQuickItem *parent);
     QQuickItem *createTaskBar(Output *output, QQuickItem *parent);
     QQuickItem *createXdgShadow(QQuickItem *parent);
+    void releaseXdgShadow(QQuickItem *shadow);
     QQuickItem *createTaskSwitcher(Output *output, QQuickItem *parent);
     QQuickItem *createGeometryAnimation(SurfaceWrapper *surface,
                                         const QRectF &startGeo,
@@ -83,6 +100,13 @@ public:
     }
 
 private:
+    QQuickItem *takeFromPool(QList<QPointer<QQuickItem>> &pool, QQuickItem *parent);
+    void releaseToPool(QList<QPointer<QQuickItem>> &pool, QQuickItem *item);
+
+    IncubationController *incubationController;
+    QList<QPointer<QQuickItem>> decorationPool;
+    QList<QPointer<QQuickItem>> xdgShadowPool;
+
     QQmlComponent titleBarComponent;
     QQmlComponent decorationComponent;
     QQmlComponent windowMenuComponent;
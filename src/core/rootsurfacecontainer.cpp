@@ -18,6 +18,7 @@
 #include <wseat.h>
 #include <winputdevice.h>
 
+#include <qwcompositor.h>
 #include <qwoutputlayout.h>
 
 #include <QQuickWindow>
@@ -35,6 +36,9 @@ RootSurfaceContainer::RootSurfaceContainer(QQuickItem *parent)
     , m_cursor(new WCursor(this))
 {
     m_cursor->setEventWindow(window());
+
+    connect(this, &SurfaceContainer::surfaceAdded, this, &RootSurfaceContainer::registerSurface);
+    connect(this, &SurfaceContainer::surfaceRemoved, this, &RootSurfaceContainer::unregisterSurface);
 }
 
 RootSurfaceContainer::~RootSurfaceContainer()
@@ -91,22 +95,45 @@ void RootSurfaceContainer::init(WServer *server)
 
 SurfaceWrapper *RootSurfaceContainer::getSurface(WSurface *surface) const
 {
-    const auto surfaces = this->surfaces();
-    for (const auto &wrapper : surfaces) {
-        if (wrapper->surface() == surface)
-            return wrapper;
-    }
-    return nullptr;
+    return surface ? m_surfaceRegistry.get(surface) : nullptr;
 }
 
 SurfaceWrapper *RootSurfaceContainer::getSurface(WToplevelSurface *surface) const
 {
-    const auto surfaces = this->surfaces();
-    for (const auto &wrapper : surfaces) {
-        if (wrapper->shellSurface() == surface)
-            return wrapper;
+    return surface ? m_surfaceRegistry.get(surface) : nullptr;
+}
+
+SurfaceWrapper *RootSurfaceContainer::getSurface(wlr_surface *surface) const
+{
+    return surface ? m_surfaceRegistry.get(surface) : nullptr;
+}
+
+void RootSurfaceContainer::registerSurface(SurfaceWrapper *surface)
+{
+    auto shellSurface = surface->shellSurface();
+    if (!shellSurface) {
+        // The prelaunch splash gets its shell surface later
+        connect(surface, &SurfaceWrapper::surfaceItemCreated, this, [this, surface] {
+            registerSurface(surface);
+        }, Qt::SingleShotConnection);
+        return;
     }
-    return nullptr;
+
+    m_surfaceRegistry.insert(shellSurface, surface);
+    if (auto wsurface = shellSurface->surface()) {
+        m_surfaceRegistry.insert(wsurface, surface);
+        m_surfaceRegistry.insert(wsurface->handle()->handle(), surface);
+    }
+    connect(surface, &SurfaceWrapper::aboutToBeInvalidated, this, [this, surface] {
+        m_surfaceRegistry.remove(surface);
+    }, Qt::SingleShotConnection);
+}
+
+void RootSurfaceContainer::unregisterSurface(SurfaceWrapper *surface)
+{
+    m_surfaceRegistry.remove(surface);
+    disconnect(surface, &SurfaceWrapper::surfaceItemCreated, this, nullptr);
+    disconnect(surface, &SurfaceWrapper::aboutToBeInvalidated, this, nullptr);
 }
 
 void RootSurfaceContainer::destroyForSurface(SurfaceWrapper *wrapper)
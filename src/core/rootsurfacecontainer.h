@@ -4,6 +4,7 @@
 
 #include "surface/surfacecontainer.h"
 #include "surface/seatsurfacemanager.h"
+#include "utils/handleregistry.h"
 
 #include <wglobal.h>
 
@@ -19,6 +20,8 @@ class WSeat;
 class WInputDevice;
 WAYLIB_SERVER_END_NAMESPACE
 
+struct wlr_surface;
+
 WAYLIB_SERVER_USE_NAMESPACE
 
 class OutputListModel : public ObjectListModel<Output>
@@ -61,6 +64,7 @@ public:
 
     SurfaceWrapper *getSurface(WSurface *surface) const;
     SurfaceWrapper *getSurface(WToplevelSurface *surface) const;
+    SurfaceWrapper *getSurface(wlr_surface *surface) const;
     void destroyForSurface(SurfaceWrapper *wrapper);
 
     SeatSurfaceManager *getSeatContainer(WSeat *seat) const;
@@ -123,6 +127,9 @@ private:
                                   [[maybe_unused]] SurfaceWrapper::State newState,
                                   [[maybe_unused]] SurfaceWrapper::State oldState) override;
 
+    void registerSurface(SurfaceWrapper *surface);
+    void unregisterSurface(SurfaceWrapper *surface);
+
     void ensureCursorVisible();
     void updateSurfaceOutputs(SurfaceWrapper *surface);
 
@@ -140,6 +147,9 @@ private:
 
     // Per-seat state management
     QMap<WSeat*, SeatSurfaceManager*> m_seatContainers;
+
+    // The surfaces in this container by their wlr_surface, WSurface and WToplevelSurface
+    HandleRegistry<SurfaceWrapper> m_surfaceRegistry;
 };
 
 Q_DECLARE_OPAQUE_POINTER(WAYLIB_SERVER_NAMESPACE::WOutputLayout *)
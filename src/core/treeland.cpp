@@ -19,6 +19,7 @@
 #include "interfaces/lockscreeninterface.h"
 #endif
 
+#include <woutputrenderwindow.h>
 #include <wsocket.h>
 #include <wxwayland.h>
 
@@ -28,11 +29,21 @@
 #include <QDBusConnectionInterface>
 #include <QDBusMessage>
 #include <QDebug>
+#include <QDir>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QFileInfo>
+#include <QJsonObject>
 #include <QLocalSocket>
 #include <QLoggingCategory>
 #include <QMetaMethod>
+#include <QPluginLoader>
+#include <QThreadPool>
+#include <QTimer>
 #include <QTranslator>
 
+#include <algorithm>
+#include <functional>
 #include <memory>
 #include <pwd.h>
 #include <sys/socket.h>
@@ -42,6 +53,29 @@ DCORE_USE_NAMESPACE
 
 namespace Treeland {
 
+#ifndef DISABLE_DDM
+// QTranslator doesn't copy the data of load(const uchar *, ...), keep it here
+class DataTranslator : public QTranslator
+{
+public:
+    DataTranslator(const QByteArray &data, QObject *parent)
+        : QTranslator(parent)
+        , m_data(data)
+    {
+    }
+
+    bool load()
+    {
+        return !m_data.isEmpty()
+            && QTranslator::load(reinterpret_cast<const uchar *>(m_data.constData()),
+                                 int(m_data.size()));
+    }
+
+private:
+    QByteArray m_data;
+};
+#endif
+
 class TreelandPrivate : public QObject
 {
     Q_OBJECT
@@ -54,6 +88,8 @@ public:
         , socket(new QLocalSocket(this))
 #endif
     {
+        startupTimer.start();
+        translatorPool.setMaxThreadCount(1);
     }
 
     void init()
@@ -91,6 +127,8 @@ public:
 
     ~TreelandPrivate()
     {
+        translatorPool.waitForDone();
+
         for (auto plugin : plugins) {
             plugin->shutdown();
             delete plugin;
@@ -123,22 +161,19 @@ public:
         auto locale = user->locale();
         qCInfo(treelandDBus) << "current locale:" << locale.language();
 
-        do {
-            auto *newTrans = new QTranslator{ this };
-            if (newTrans
-                    ->load(locale, "treeland", ".", TREELAND_COMPONENTS_TRANSLATION_DIR, ".qm")) {
-                if (lastTrans) {
-                    QCoreApplication::removeTranslator(lastTrans);
-                    lastTrans->deleteLater();
-                }
-                lastTrans = newTrans;
-                QCoreApplication::installTranslator(lastTrans);
-                qmlEngine->retranslate();
-                break;
+        loadTranslator(locale, "treeland", [this](QTranslator *newTrans) {
+            if (!newTrans) {
+                qCWarning(treelandDBus) << "failed to load new translator";
+                return;
             }
-            newTrans->deleteLater();
-            qCWarning(treelandDBus) << "failed to load new translator";
-        } while (false);
+            if (lastTrans) {
+                QCoreApplication::removeTranslator(lastTrans);
+                lastTrans->deleteLater();
+            }
+            lastTrans = newTrans;
+            QCoreApplication::installTranslator(lastTrans);
+            qmlEngine->retranslate();
+        });
     }
 
     void updatePluginTs(PluginInterface *plugin, const QString &scope)
@@ -152,30 +187,82 @@ public:
 
         auto locale = userModel->currentUser()->locale();
         qCInfo(treelandDBus) << "current locale:" << locale.language();
-        QTranslator *newTrans = new QTranslator;
 
-        if (newTrans->load(locale, scope, ".", TREELAND_COMPONENTS_TRANSLATION_DIR, ".qm")) {
-            for (auto it = pluginTs.begin(); it != pluginTs.end(); ++it) {
-                if (it->first == plugin) {
-                    QCoreApplication::removeTranslator(it->second);
-                    pluginTs.erase(it);
-                    break;
-                }
+        loadTranslator(locale, scope, [this, plugin, scope](QTranslator *newTrans) {
+            if (!newTrans) {
+                qCWarning(treelandDBus) << "failed to load plugin translator: " << scope;
+                return;
+            }
+
+            // The plugin is unloaded while loading the translator
+            if (std::find(plugins.begin(), plugins.end(), plugin) == plugins.end()) {
+                newTrans->deleteLater();
+                return;
+            }
+
+            auto it = pluginTs.find(plugin);
+            if (it != pluginTs.end()) {
+                QCoreApplication::removeTranslator(it->second);
+                it->second->deleteLater();
+                pluginTs.erase(it);
             }
 
             pluginTs[plugin] = newTrans;
-            QCoreApplication::installTranslator(pluginTs[plugin]);
+            QCoreApplication::installTranslator(newTrans);
             qmlEngine->retranslate();
-        } else {
-            qCWarning(treelandDBus) << "failed to load plugin translator: " << scope;
+        });
+    }
+
+    // Read the .qm file in the thread pool, the translator is created and loaded
+    // in the main thread, the callback is called with nullptr if failed.
+    void loadTranslator(const QLocale &locale,
+                        const QString &scope,
+                        std::function<void(QTranslator *)> callback)
+    {
+        translatorPool.start([this, locale, scope, callback = std::move(callback)] {
+            QByteArray data;
+            QFile file(findTranslation(locale, scope));
+            if (file.open(QIODevice::ReadOnly))
+                data = file.readAll();
+            QMetaObject::invokeMethod(
+                this,
+                [this, data, callback] {
+                    auto *newTrans = new DataTranslator(data, this);
+                    if (newTrans->load()) {
+                        callback(newTrans);
+                    } else {
+                        delete newTrans;
+                        callback(nullptr);
+                    }
+                },
+                Qt::QueuedConnection);
+        });
+    }
+
+    // Same as the lookup of QTranslator::load(locale, ...), e.g. treeland.zh_CN.qm,
+    // then treeland.zh.qm for the ui language zh-CN.
+    static QString findTranslation(const QLocale &locale, const QString &scope)
+    {
+        const QDir dir(QStringLiteral(TREELAND_COMPONENTS_TRANSLATION_DIR));
+        for (QString name : locale.uiLanguages()) {
+            name.replace(u'-', u'_');
+            while (!name.isEmpty()) {
+                const QString fileName = dir.filePath(scope + u'.' + name + QStringLiteral(".qm"));
+                if (QFileInfo::exists(fileName))
+                    return fileName;
+                const int separator = name.lastIndexOf(u'_');
+                if (separator < 0)
+                    break;
+                name.truncate(separator);
+            }
         }
+        return {};
     }
 #endif
 
-    void loadPlugin(const QString &path)
+    // Only read the metadata of the plugins here, the libraries are loaded by loadPlugin
+    void scanPlugins(const QString &path)
     {
-        Q_Q(Treeland);
-
         QDir pluginsDir(path);
 
         if (!pluginsDir.exists()) {
@@ -185,65 +272,149 @@ public:
         const QStringList pluginFiles = pluginsDir.entryList(QDir::Files | QDir::NoDotAndDotDot);
         for (const QString &pluginFile : pluginFiles) {
             QString filePath = pluginsDir.absoluteFilePath(pluginFile);
-            qCDebug(treelandPlugin) << "Attempting to load plugin:" << filePath;
-
             QPluginLoader loader(filePath);
-            QObject *pluginInstance = loader.instance();
+            const QJsonObject metaData = loader.metaData();
+            const QString iid = metaData.value("IID").toString();
 
-            if (!pluginInstance) {
-                qCWarning(treelandPlugin) << "Failed to load plugin:" << loader.errorString();
+            if (!iid.startsWith(PluginIIDPrefix)) {
+                qCWarning(treelandPlugin) << "Skip the file without Treeland plugin metadata:"
+                                          << filePath;
                 continue;
             }
 
-            PluginInterface *plugin = qobject_cast<PluginInterface *>(pluginInstance);
-            if (!plugin) {
-                qCWarning(treelandPlugin) << "Plugin does not implement PluginInterface.";
-            }
+            PluginInfo info;
+            info.filePath = filePath;
+            info.type = iid.mid(PluginIIDPrefix.size()).section('/', 0, 0);
+            info.scope = metaData.value("MetaData").toObject().value("translate").toString();
+            qCDebug(treelandPlugin) << "Found plugin:" << info.type << "at" << filePath
+                                    << ", metadata:" << metaData;
+            pendingPlugins.push_back(info);
+        }
+    }
 
-            qCDebug(treelandPlugin) << "Loaded plugin: " << plugin->name()
-                             << ", enabled: " << plugin->enabled()
-                             << ", metadata: " << loader.metaData();
-            // TODO: use scheduler to run
-            plugin->initialize(q);
-            plugins.push_back(plugin);
+    void startLoadPlugins()
+    {
+        // The greeter is showing the lock screen from the first frame
+        if (CmdLine::ref().useLockScreen())
+            loadPlugin(QStringLiteral("lockscreen"));
+
+        // Locking before the plugin is loaded in background, e.g. by DDM or ext-session-lock
+        helper->setLockScreenLoader([this] {
+            loadPlugin(QStringLiteral("lockscreen"));
+        });
+
+        helper->setMultitaskViewLoader([this] {
+            loadPlugin(QStringLiteral("multitaskview"));
+        });
+
+        connect(
+            helper->window(),
+            &WOutputRenderWindow::renderEnd,
+            this,
+            [this] {
+                qCInfo(treelandPlugin)
+                    << "The first frame is rendered after" << startupTimer.elapsed() << "ms";
+                loadNextPlugin();
+            },
+            Qt::SingleShotConnection);
+    }
+
+    // One plugin in an event loop iteration, not to block the rendering for long
+    void loadNextPlugin()
+    {
+        if (pendingPlugins.empty())
+            return;
+
+        loadPlugin(pendingPlugins.front().type);
+        QTimer::singleShot(0, this, &TreelandPrivate::loadNextPlugin);
+    }
+
+    void loadPlugin(const QString &type)
+    {
+        Q_Q(Treeland);
+
+        auto info = std::find_if(pendingPlugins.begin(),
+                                 pendingPlugins.end(),
+                                 [&type](const PluginInfo &info) {
+                                     return info.type == type;
+                                 });
+        if (info == pendingPlugins.end())
+            return;
+
+        const QString filePath = info->filePath;
+        const QString scope = info->scope;
+        pendingPlugins.erase(info);
+
+        qCDebug(treelandPlugin) << "Attempting to load plugin:" << filePath;
+
+        QElapsedTimer timer;
+        timer.start();
+        QPluginLoader loader(filePath);
+        QObject *pluginInstance = loader.instance();
+
+        if (!pluginInstance) {
+            qCWarning(treelandPlugin) << "Failed to load plugin:" << loader.errorString();
+            return;
+        }
 
-            const QString scope{
-                loader.metaData().value("MetaData").toObject().value("translate").toString()
-            };
-            qCDebug(treelandPlugin) << "Plugin translate scope:" << scope;
+        PluginInterface *plugin = qobject_cast<PluginInterface *>(pluginInstance);
+        if (!plugin) {
+            qCWarning(treelandPlugin) << "Plugin does not implement PluginInterface.";
+            return;
+        }
+
+        const qint64 instanceTime = timer.restart();
+        qCDebug(treelandPlugin) << "Loaded plugin: " << plugin->name()
+                                << ", enabled: " << plugin->enabled();
+        plugin->initialize(q);
+        plugins.push_back(plugin);
+        qCInfo(treelandPlugin) << "Plugin" << plugin->name() << "is loaded at"
+                               << startupTimer.elapsed() << "ms, instance:" << instanceTime
+                               << "ms, initialize:" << timer.elapsed() << "ms";
+
+        qCDebug(treelandPlugin) << "Plugin translate scope:" << scope;
 
 #ifndef DISABLE_DDM
-            connect(helper->qmlEngine()->singletonInstance<UserModel *>("Treeland", "UserModel"),
-                    &UserModel::currentUserNameChanged,
-                    pluginInstance,
-                    [this, plugin, scope] {
-                        updatePluginTs(plugin, scope);
-                    });
-
-            updatePluginTs(plugin, scope);
+        connect(helper->qmlEngine()->singletonInstance<UserModel *>("Treeland", "UserModel"),
+                &UserModel::currentUserNameChanged,
+                pluginInstance,
+                [this, plugin, scope] {
+                    updatePluginTs(plugin, scope);
+                });
+
+        updatePluginTs(plugin, scope);
 #endif
 
-            if (auto *multitaskview = qobject_cast<IMultitaskView *>(pluginInstance)) {
-                qCDebug(treelandPlugin) << "Get MultitaskView Instance.";
-                connect(pluginInstance, &QObject::destroyed, this, [this] {
-                    helper->setMultitaskViewImpl(nullptr);
-                });
-                helper->setMultitaskViewImpl(multitaskview);
-            }
+        if (auto *multitaskview = qobject_cast<IMultitaskView *>(pluginInstance)) {
+            qCDebug(treelandPlugin) << "Get MultitaskView Instance.";
+            connect(pluginInstance, &QObject::destroyed, this, [this] {
+                helper->setMultitaskViewImpl(nullptr);
+            });
+            helper->setMultitaskViewImpl(multitaskview);
+        }
 
 #if !defined(DISABLE_DDM) || defined(EXT_SESSION_LOCK_V1)
-            if (auto *lockscreen = qobject_cast<ILockScreen *>(pluginInstance)) {
-                qCDebug(treelandPlugin) << "Get LockScreen Instance.";
-                connect(pluginInstance, &QObject::destroyed, this, [this] {
-                    helper->setLockScreenImpl(nullptr);
-                });
-                helper->setLockScreenImpl(lockscreen);
-            }
-#endif
+        if (auto *lockscreen = qobject_cast<ILockScreen *>(pluginInstance)) {
+            qCDebug(treelandPlugin) << "Get LockScreen Instance.";
+            connect(pluginInstance, &QObject::destroyed, this, [this] {
+                helper->setLockScreenImpl(nullptr);
+            });
+            helper->setLockScreenImpl(lockscreen);
         }
+#endif
     }
 
 private:
+    struct PluginInfo
+    {
+        QString filePath;
+        // The name in the IID, e.g. "lockscreen" of org.deepin.treeland.plugin.lockscreen/1.0
+        QString type;
+        QString scope;
+    };
+
+    static inline const QString PluginIIDPrefix = QStringLiteral("org.deepin.treeland.plugin.");
+
     Treeland *q_ptr;
 #ifndef DISABLE_DDM
     Dtk::Accounts::DAccountsManager manager;
@@ -257,6 +428,9 @@ private:
     QMap<QString, std::shared_ptr<QDBusUnixFileDescriptor>> userDisplayFds;
     std::vector<QAction *> shortcuts;
     std::map<PluginInterface *, QTranslator *> pluginTs;
+    QElapsedTimer startupTimer;
+    std::vector<PluginInfo> pendingPlugins;
+    QThreadPool translatorPool;
 };
 
 
@@ -365,15 +539,16 @@ Treeland::Treeland()
 #ifdef QT_DEBUG
     QDir dir(QStringLiteral(TREELAND_PLUGINS_OUTPUT_PATH));
     if (dir.exists() && dir.isReadable()) {
-        d->loadPlugin(QStringLiteral(TREELAND_PLUGINS_OUTPUT_PATH));
+        d->scanPlugins(QStringLiteral(TREELAND_PLUGINS_OUTPUT_PATH));
     } else {
         qCInfo(treelandPlugin) << "The Treeland plugin build directory is inaccessible, "
                                    "falling back to the installation directory";
-        d->loadPlugin(QStringLiteral(TREELAND_PLUGINS_INSTALL_PATH));
+        d->scanPlugins(QStringLiteral(TREELAND_PLUGINS_INSTALL_PATH));
     }
 #else
-    d->loadPlugin(QStringLiteral(TREELAND_PLUGINS_INSTALL_PATH));
+    d->scanPlugins(QStringLiteral(TREELAND_PLUGINS_INSTALL_PATH));
 #endif
+    d->startLoadPlugins();
 }
 
 Treeland::~Treeland()
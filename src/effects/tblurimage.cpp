@@ -0,0 +1,341 @@
+// Copyright (C) 2026 UnionTech Software Technology Co., Ltd.
+// SPDX-License-Identifier: Apache-2.0 OR LGPL-3.0-only OR GPL-2.0-only OR GPL-3.0-only
+
+#include "tblurimage.h"
+
+#include <QPainter>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#elif defined(__ARM_NEON)
+#include <arm_neon.h>
+#endif
+
+#include <cstring>
+
+// The sums of the four channels of the pixels in the box
+#if defined(__SSE2__)
+using Sum = __m128i;
+
+static inline Sum loadSum(uint pixel)
+{
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i v = _mm_unpacklo_epi8(_mm_cvtsi32_si128(int(pixel)), zero);
+    return _mm_unpacklo_epi16(v, zero);
+}
+
+static inline Sum addSum(Sum a, Sum b)
+{
+    return _mm_add_epi32(a, b);
+}
+
+static inline Sum subSum(Sum a, Sum b)
+{
+    return _mm_sub_epi32(a, b);
+}
+
+static inline uint storeSum(Sum sum, float scale)
+{
+    // Round half up as the other paths, _mm_cvtps_epi32 rounds half to even
+    const __m128 f = _mm_mul_ps(_mm_cvtepi32_ps(sum), _mm_set1_ps(scale));
+    __m128i v = _mm_cvttps_epi32(_mm_add_ps(f, _mm_set1_ps(0.5f)));
+    v = _mm_packs_epi32(v, v);
+    return uint(_mm_cvtsi128_si32(_mm_packus_epi16(v, v)));
+}
+#elif defined(__ARM_NEON)
+using Sum = uint32x4_t;
+
+static inline Sum loadSum(uint pixel)
+{
+    const uint16x8_t v = vmovl_u8(vreinterpret_u8_u32(vdup_n_u32(pixel)));
+    return vmovl_u16(vget_low_u16(v));
+}
+
+static inline Sum addSum(Sum a, Sum b)
+{
+    return vaddq_u32(a, b);
+}
+
+static inline Sum subSum(Sum a, Sum b)
+{
+    return vsubq_u32(a, b);
+}
+
+static inline uint storeSum(Sum sum, float scale)
+{
+    const float32x4_t v = vmlaq_n_f32(vdupq_n_f32(0.5f), vcvtq_f32_u32(sum), scale);
+    const uint16x4_t n = vmovn_u32(vcvtq_u32_f32(v));
+    return vget_lane_u32(vreinterpret_u32_u8(vmovn_u16(vcombine_u16(n, n))), 0);
+}
+#else
+struct Sum
+{
+    uint v[4];
+};
+
+static inline Sum loadSum(uint pixel)
+{
+    return { { pixel & 0xff, (pixel >> 8) & 0xff, (pixel >> 16) & 0xff, pixel >> 24 } };
+}
+
+static inline Sum addSum(Sum a, const Sum &b)
+{
+    for (int i = 0; i < 4; ++i)
+        a.v[i] += b.v[i];
+    return a;
+}
+
+static inline Sum subSum(Sum a, const Sum &b)
+{
+    for (int i = 0; i < 4; ++i)
+        a.v[i] -= b.v[i];
+    return a;
+}
+
+static inline uint storeSum(const Sum &sum, float scale)
+{
+    uint pixel = 0;
+    for (int i = 0; i < 4; ++i)
+        pixel |= qMin(uint(sum.v[i] * scale + 0.5f), 255u) << (i * 8);
+    return pixel;
+}
+#endif
+
+static inline uint average4(uint a, uint b, uint c, uint d)
+{
+    const uint rb = ((a & 0xff00ff) + (b & 0xff00ff) + (c & 0xff00ff) + (d & 0xff00ff) + 0x20002)
+        >> 2;
+    const uint ag = (((a >> 8) & 0xff00ff) + ((b >> 8) & 0xff00ff) + ((c >> 8) & 0xff00ff)
+                     + ((d >> 8) & 0xff00ff) + 0x20002)
+        >> 2;
+    return (rb & 0xff00ff) | ((ag & 0xff00ff) << 8);
+}
+
+static void ensureImage(QImage *image, const QSize &size)
+{
+    if (image->size() != size || image->format() != QImage::Format_ARGB32_Premultiplied)
+        *image = QImage(size, QImage::Format_ARGB32_Premultiplied);
+}
+
+// Downscale to the half size, every pixel is the average of a 2x2 block. Only
+// the pixels of the target in the rect are updated.
+static void halve(const QImage &source, QImage *target, const QRect &rect)
+{
+    const int width = source.width();
+    const int height = source.height();
+    const int end = rect.right() + 1;
+
+    for (int y = rect.top(); y <= rect.bottom(); ++y) {
+        auto r0 = reinterpret_cast<const uint *>(source.constScanLine(y * 2));
+        auto r1 = reinterpret_cast<const uint *>(source.constScanLine(qMin(y * 2 + 1, height - 1)));
+        auto out = reinterpret_cast<uint *>(target->scanLine(y));
+
+        int x = rect.left();
+#if defined(__SSE2__)
+        for (; x + 2 <= end && x * 2 + 4 <= width; x += 2) {
+            const __m128i v =
+                _mm_avg_epu8(_mm_loadu_si128(reinterpret_cast<const __m128i *>(r0 + x * 2)),
+                             _mm_loadu_si128(reinterpret_cast<const __m128i *>(r1 + x * 2)));
+            const __m128i even = _mm_shuffle_epi32(v, _MM_SHUFFLE(2, 0, 2, 0));
+            const __m128i odd = _mm_shuffle_epi32(v, _MM_SHUFFLE(3, 1, 3, 1));
+            _mm_storel_epi64(reinterpret_cast<__m128i *>(out + x), _mm_avg_epu8(even, odd));
+        }
+#elif defined(__ARM_NEON)
+        for (; x + 2 <= end && x * 2 + 4 <= width; x += 2) {
+            const uint32x4_t v =
+                vreinterpretq_u32_u8(vrhaddq_u8(vld1q_u8(reinterpret_cast<const uint8_t *>(r0 + x * 2)),
+                                                vld1q_u8(reinterpret_cast<const uint8_t *>(r1 + x * 2))));
+            const uint32x2x2_t pairs = vuzp_u32(vget_low_u32(v), vget_high_u32(v));
+            vst1_u8(reinterpret_cast<uint8_t *>(out + x),
+                    vrhadd_u8(vreinterpret_u8_u32(pairs.val[0]), vreinterpret_u8_u32(pairs.val[1])));
+        }
+#endif
+        for (; x < end; ++x) {
+            const int x0 = x * 2;
+            const int x1 = qMin(x0 + 1, width - 1);
+            out[x] = average4(r0[x0], r0[x1], r1[x0], r1[x1]);
+        }
+    }
+}
+
+static void copyRect(const QImage &source, QImage *target, const QRect &rect)
+{
+    for (int y = rect.top(); y <= rect.bottom(); ++y) {
+        std::memcpy(target->scanLine(y) + rect.left() * sizeof(uint),
+                    source.constScanLine(y) + rect.left() * sizeof(uint),
+                    rect.width() * sizeof(uint));
+    }
+}
+
+static void blurHorizontal(QImage *image, int radius, std::vector<uint> *line)
+{
+    const int width = image->width();
+    const float scale = 1.0f / (radius * 2 + 1);
+    line->resize(width);
+
+    for (int y = 0; y < image->height(); ++y) {
+        auto row = reinterpret_cast<uint *>(image->scanLine(y));
+        std::memcpy(line->data(), row, width * sizeof(uint));
+        const uint *in = line->data();
+
+        // The pixels out of the image are the same as the edge
+        Sum sum = loadSum(in[0]);
+        for (int i = 1; i <= radius; ++i)
+            sum = addSum(sum, addSum(loadSum(in[0]), loadSum(in[qMin(i, width - 1)])));
+
+        for (int x = 0; x < width; ++x) {
+            row[x] = storeSum(sum, scale);
+            sum = addSum(sum, loadSum(in[qMin(x + radius + 1, width - 1)]));
+            sum = subSum(sum, loadSum(in[qMax(x - radius, 0)]));
+        }
+    }
+}
+
+// The sums of the columns go down row by row, the memory is accessed in order
+static void blurVertical(const QImage &source, QImage *target, int radius)
+{
+    const int width = source.width();
+    const int height = source.height();
+    const float scale = 1.0f / (radius * 2 + 1);
+    const auto row = [&source, height](int y) {
+        return reinterpret_cast<const uint *>(source.constScanLine(qBound(0, y, height - 1)));
+    };
+
+    std::vector<Sum> sums(width);
+    const uint *first = row(0);
+    for (int x = 0; x < width; ++x)
+        sums[x] = loadSum(first[x]);
+    for (int i = 1; i <= radius; ++i) {
+        const uint *in = row(i);
+        for (int x = 0; x < width; ++x)
+            sums[x] = addSum(sums[x], addSum(loadSum(first[x]), loadSum(in[x])));
+    }
+
+    for (int y = 0; y < height; ++y) {
+        auto out = reinterpret_cast<uint *>(target->scanLine(y));
+        const uint *add = row(y + radius + 1);
+        const uint *sub = row(y - radius);
+        for (int x = 0; x < width; ++x) {
+            out[x] = storeSum(sums[x], scale);
+            sums[x] = subSum(addSum(sums[x], loadSum(add[x])), loadSum(sub[x]));
+        }
+    }
+}
+
+int TBlurImage::radius() const
+{
+    return m_radius;
+}
+
+void TBlurImage::setRadius(int radius)
+{
+    radius = qMax(0, radius);
+    if (m_radius == radius)
+        return;
+
+    m_radius = radius;
+    // Downscale until the radius is less than 16 pixels, three box passes
+    // of the half radius are close to the gaussian blur
+    m_levels = 0;
+    while (m_levels < 3 && (radius >> m_levels) >= 16)
+        ++m_levels;
+    m_boxRadius = qMax(1, (radius >> m_levels) / 2);
+    reset();
+}
+
+QRect TBlurImage::update(const QImage &image, const QRegion &changed)
+{
+    if (image.isNull()) {
+        reset();
+        return {};
+    }
+
+    QImage source = image;
+    if (source.format() != QImage::Format_ARGB32_Premultiplied
+        && source.format() != QImage::Format_RGB32) {
+        source.convertTo(QImage::Format_ARGB32_Premultiplied);
+    }
+
+    const bool sizeChanged = m_result.size() != source.size();
+    const QRect sourceDirty = sizeChanged ? source.rect() : changed.boundingRect() & source.rect();
+    if (sourceDirty.isEmpty())
+        return {};
+
+    if (sizeChanged)
+        m_result = QImage(source.size(), QImage::Format_ARGB32_Premultiplied);
+
+    if (m_radius <= 0) {
+        // The source may not own its pixels, only keep a copy of the changed area
+        copyRect(source, &m_result, sourceDirty);
+        return sourceDirty;
+    }
+
+    if (sizeChanged) {
+        QSize size = source.size();
+        m_levelImages.resize(qMax(0, m_levels - 1));
+        for (auto &levelImage : m_levelImages) {
+            size = QSize((size.width() + 1) / 2, (size.height() + 1) / 2);
+            ensureImage(&levelImage, size);
+        }
+        if (m_levels > 0)
+            size = QSize((size.width() + 1) / 2, (size.height() + 1) / 2);
+        ensureImage(&m_small, size);
+        m_blurred = QImage(m_small.size(), QImage::Format_ARGB32_Premultiplied);
+    }
+
+    // Downscale only the changed area, every level halves the rect
+    QRect dirty = sourceDirty;
+    const QImage *level = &source;
+    for (int i = 0; i < m_levels; ++i) {
+        QImage *target = i + 1 < m_levels ? &m_levelImages[i] : &m_small;
+        dirty = QRect(QPoint(dirty.left() / 2, dirty.top() / 2),
+                      QPoint(dirty.right() / 2, dirty.bottom() / 2));
+        halve(*level, target, dirty);
+        level = target;
+    }
+    if (m_levels == 0)
+        copyRect(source, &m_small, dirty);
+
+    // The three passes spread the changes by three box radius, and the pixels
+    // there need three more box radius of the input to be correct
+    const int r = m_boxRadius;
+    const QRect blurred = dirty.adjusted(-3 * r, -3 * r, 3 * r, 3 * r) & m_small.rect();
+    const QRect input = dirty.adjusted(-6 * r, -6 * r, 6 * r, 6 * r) & m_small.rect();
+
+    QImage work = m_small.copy(input);
+    QImage temp(work.size(), QImage::Format_ARGB32_Premultiplied);
+    for (int i = 0; i < 3; ++i) {
+        blurHorizontal(&work, r, &m_line);
+        blurVertical(work, &temp, r);
+        work.swap(temp);
+    }
+
+    for (int y = blurred.top(); y <= blurred.bottom(); ++y) {
+        std::memcpy(m_blurred.scanLine(y) + blurred.left() * sizeof(uint),
+                    work.constScanLine(y - input.top()) + (blurred.left() - input.left()) * sizeof(uint),
+                    blurred.width() * sizeof(uint));
+    }
+
+    // Upscale the changed area, with the margin of the bilinear filtering
+    const int scale = 1 << m_levels;
+    const QRect resultRect =
+        QRect(blurred.topLeft() * scale, blurred.size() * scale).adjusted(-scale, -scale, scale, scale)
+        & m_result.rect();
+
+    QPainter painter(&m_result);
+    painter.setCompositionMode(QPainter::CompositionMode_Source);
+    painter.setRenderHint(QPainter::SmoothPixmapTransform, m_levels > 0);
+    painter.setClipRect(resultRect);
+    painter.drawImage(QRectF(0, 0, m_blurred.width() * scale, m_blurred.height() * scale), m_blurred);
+    painter.end();
+
+    return resultRect;
+}
+
+void TBlurImage::reset()
+{
+    m_levelImages.clear();
+    m_small = QImage();
+    m_blurred = QImage();
+    m_result = QImage();
+}
@@ -0,0 +1,48 @@
+// Copyright (C) 2026 UnionTech Software Technology Co., Ltd.
+// SPDX-License-Identifier: Apache-2.0 OR LGPL-3.0-only OR GPL-2.0-only OR GPL-3.0-only
+
+#pragma once
+
+#include <QImage>
+#include <QRect>
+#include <QRegion>
+
+#include <vector>
+
+// Blur the 32 bits premultiplied images on the CPU. The source is downscaled
+// before the three box blur passes, and only the area changed since the
+// previous update is downscaled and blurred again.
+class TBlurImage
+{
+public:
+    TBlurImage() = default;
+
+    int radius() const;
+    // The blur radius in the pixels of the source
+    void setRadius(int radius);
+
+    // The changed area of the source since the previous update is given by
+    // its producer, e.g. the repainted area of the software WRenderBufferNode.
+    // Returns the area of the result changed by this update, both are in the
+    // pixels of the source.
+    QRect update(const QImage &source, const QRegion &changed);
+    void reset();
+
+    inline const QImage &result() const
+    {
+        return m_result;
+    }
+
+private:
+    int m_radius = 0;
+    // The source is downscaled by 2^m_levels
+    int m_levels = 0;
+    int m_boxRadius = 0;
+
+    std::vector<QImage> m_levelImages;
+    // The downscaled source
+    QImage m_small;
+    QImage m_blurred;
+    QImage m_result;
+    std::vector<uint> m_line;
+};
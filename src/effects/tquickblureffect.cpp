@@ -0,0 +1,65 @@
+// Copyright (C) 2026 UnionTech Software Technology Co., Ltd.
+// SPDX-License-Identifier: Apache-2.0 OR LGPL-3.0-only OR GPL-2.0-only OR GPL-3.0-only
+
+#include "tquickblureffect.h"
+
+#include "tquickradiuseffect_p.h"
+#include "tsgblursoftwarenode.h"
+
+class Q_DECL_HIDDEN TQuickBlurEffectPrivate : public TQuickRadiusEffectPrivate
+{
+    Q_DECLARE_PUBLIC(TQuickBlurEffect)
+
+public:
+    qreal blurRadius = 64;
+};
+
+TQuickBlurEffect::TQuickBlurEffect(QQuickItem *parent)
+    : TQuickRadiusEffect(*(new TQuickBlurEffectPrivate), parent)
+{
+    setFlag(ItemHasContents);
+}
+
+TQuickBlurEffect::~TQuickBlurEffect() = default;
+
+qreal TQuickBlurEffect::blurRadius() const
+{
+    Q_D(const TQuickBlurEffect);
+    return d->blurRadius;
+}
+
+void TQuickBlurEffect::setBlurRadius(qreal radius)
+{
+    Q_D(TQuickBlurEffect);
+
+    if (d->blurRadius == radius)
+        return;
+
+    d->blurRadius = radius;
+    update();
+    Q_EMIT blurRadiusChanged();
+}
+
+QSGNode *TQuickBlurEffect::updatePaintNode(QSGNode *oldNode, UpdatePaintNodeData *data)
+{
+    Q_D(TQuickBlurEffect);
+
+    auto sgRendererInterface = d->window->rendererInterface();
+    if (!sgRendererInterface
+        || sgRendererInterface->graphicsApi() != QSGRendererInterface::Software) {
+        delete oldNode;
+        return nullptr;
+    }
+
+    auto node = static_cast<TSGBlurSoftwareNode *>(oldNode);
+    if (Q_LIKELY(!node)) {
+        node = new TSGBlurSoftwareNode(window());
+    }
+
+    // The radius effect deletes the node if the source is invalid
+    if (!TQuickRadiusEffect::updatePaintNode(node, data))
+        return nullptr;
+
+    node->setBlurRadius(d->blurRadius);
+    return node;
+}
@@ -0,0 +1,33 @@
+// Copyright (C) 2026 UnionTech Software Technology Co., Ltd.
+// SPDX-License-Identifier: Apache-2.0 OR LGPL-3.0-only OR GPL-2.0-only OR GPL-3.0-only
+
+#pragma once
+
+#include "tquickradiuseffect.h"
+
+class TQuickBlurEffectPrivate;
+
+// The blur of the software renderer, the hardware renderers should use MultiEffect
+class TQuickBlurEffect : public TQuickRadiusEffect
+{
+    Q_OBJECT
+    Q_PROPERTY(qreal blurRadius READ blurRadius WRITE setBlurRadius NOTIFY blurRadiusChanged FINAL)
+    QML_NAMED_ELEMENT(TBlurEffect)
+
+public:
+    explicit TQuickBlurEffect(QQuickItem *parent = nullptr);
+    ~TQuickBlurEffect() override;
+
+    qreal blurRadius() const;
+    void setBlurRadius(qreal radius);
+
+Q_SIGNALS:
+    void blurRadiusChanged();
+
+protected:
+    QSGNode *updatePaintNode(QSGNode *, UpdatePaintNodeData *) override;
+
+private:
+    Q_DISABLE_COPY(TQuickBlurEffect)
+    Q_DECLARE_PRIVATE(TQuickBlurEffect)
+};
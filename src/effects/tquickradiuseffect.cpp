@@ -5,6 +5,7 @@
 
 #include "tquickradiuseffect_p.h"
 #include "tsgradiusimagenode.h"
+#include "tsgradiussoftwarenode.h"
 #include "common/treelandlogging.h"
 
 void TQuickRadiusEffectPrivate::maybeSetImplicitAntialiasing()
@@ -356,8 +357,28 @@ QSGNode *TQuickRadiusEffect::updatePaintNode(QSGNode *oldNode, UpdatePaintNodeDa
     auto sgRendererInterface = d->window->rendererInterface();
     if (sgRendererInterface
         && sgRendererInterface->graphicsApi() == QSGRendererInterface::Software) {
-        // TODO: Software is not currently supported
-        return nullptr;
+        TSGRadiusSoftwareNode *node = static_cast<TSGRadiusSoftwareNode *>(oldNode);
+        if (Q_LIKELY(!node)) {
+            node = new TSGRadiusSoftwareNode(window());
+        }
+        node->setTextureProvider(d->sourceItem->textureProvider());
+        node->setRect(boundingRect());
+        node->setRadius(d->radius);
+        if (Q_LIKELY(d->extraRadius.isAllocated())) {
+            node->setTopLeftRadius(d->extraRadius.value().topLeftRadius);
+            node->setTopRightRadius(d->extraRadius.value().topRightRadius);
+            node->setBottomLeftRadius(d->extraRadius.value().bottomLeftRadius);
+            node->setBottomRightRadius(d->extraRadius.value().bottomRightRadius);
+        } else {
+            node->setTopLeftRadius(-1.);
+            node->setTopRightRadius(-1.);
+            node->setBottomLeftRadius(-1.);
+            node->setBottomRightRadius(-1.);
+        }
+        node->setAntialiasing(antialiasing());
+        node->setSmooth(smooth());
+
+        return node;
     } else {
         TSGRadiusImageNode *node = static_cast<TSGRadiusImageNode *>(oldNode);
         if (Q_LIKELY(!node)) {
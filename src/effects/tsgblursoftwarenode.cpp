@@ -0,0 +1,76 @@
+// Copyright (C) 2026 UnionTech Software Technology Co., Ltd.
+// SPDX-License-Identifier: Apache-2.0 OR LGPL-3.0-only OR GPL-2.0-only OR GPL-3.0-only
+
+#include "tsgblursoftwarenode.h"
+
+#include <wrenderbuffernode_p.h>
+
+WAYLIB_SERVER_USE_NAMESPACE
+
+TSGBlurSoftwareNode::TSGBlurSoftwareNode(QQuickWindow *window)
+    : TSGRadiusSoftwareNode(window)
+{
+}
+
+void TSGBlurSoftwareNode::setBlurRadius(qreal radius)
+{
+    if (m_blurRadius == radius)
+        return;
+
+    m_blurRadius = radius;
+    markDirty(DirtyMaterial);
+}
+
+QImage TSGBlurSoftwareNode::sourceImage(QRectF *sourceRect)
+{
+    QRectF rect;
+    const QImage image = TSGRadiusSoftwareNode::sourceImage(&rect);
+    const QRect pixelRect = rect.toAlignedRect() & image.rect();
+    if (image.isNull() || pixelRect.isEmpty() || this->rect().isEmpty()) {
+        m_blur.reset();
+        m_sourceTexture = nullptr;
+        return {};
+    }
+
+    // Not copy the pixels, the view lives shorter than the image
+    QImage source = image;
+    if (pixelRect != image.rect()) {
+        source = QImage(image.constScanLine(pixelRect.top()) + pixelRect.left() * (image.depth() / 8),
+                        pixelRect.width(),
+                        pixelRect.height(),
+                        image.bytesPerLine(),
+                        image.format());
+    }
+
+    m_blur.setRadius(qRound(m_blurRadius * pixelRect.width() / this->rect().width()));
+    m_blur.update(source, changedRegion(image, pixelRect));
+
+    *sourceRect = m_blur.result().rect();
+    return m_blur.result();
+}
+
+// Returns the area of the source changed since the previous update, in the
+// pixels of the pixelRect
+QRegion TSGBlurSoftwareNode::changedRegion(const QImage &image, const QRect &pixelRect)
+{
+    const QSGTexture *texture = sourceTexture();
+    const bool sameSource = texture == m_sourceTexture && pixelRect == m_sourcePixelRect;
+    m_sourceTexture = texture;
+    m_sourcePixelRect = pixelRect;
+
+    QRegion changed = QRect(QPoint(0, 0), pixelRect.size());
+    if (auto t = qobject_cast<const WRenderBufferImageTexture *>(texture)) {
+        // The software WRenderBufferNode knows its repainted area, it's
+        // unknown if the updates of some serials are missed
+        if (sameSource && t->serial() == m_sourceSerial)
+            changed = QRegion();
+        else if (sameSource && t->serial() == m_sourceSerial + 1)
+            changed = (t->changedRegion() & pixelRect).translated(-pixelRect.topLeft());
+        m_sourceSerial = t->serial();
+    } else if (sameSource && image.cacheKey() == m_sourceKey) {
+        changed = QRegion();
+    }
+    m_sourceKey = image.cacheKey();
+
+    return changed;
+}
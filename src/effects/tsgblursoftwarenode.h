@@ -0,0 +1,32 @@
+// Copyright (C) 2026 UnionTech Software Technology Co., Ltd.
+// SPDX-License-Identifier: Apache-2.0 OR LGPL-3.0-only OR GPL-2.0-only OR GPL-3.0-only
+
+#pragma once
+
+#include "tblurimage.h"
+#include "tsgradiussoftwarenode.h"
+
+// The blurred source is painted with the rounded corners of the radius node
+class TSGBlurSoftwareNode : public TSGRadiusSoftwareNode
+{
+    Q_OBJECT
+public:
+    explicit TSGBlurSoftwareNode(QQuickWindow *window);
+
+    void setBlurRadius(qreal radius);
+
+protected:
+    QImage sourceImage(QRectF *sourceRect) override;
+
+private:
+    QRegion changedRegion(const QImage &image, const QRect &pixelRect);
+
+    qreal m_blurRadius = 0;
+    TBlurImage m_blur;
+
+    // The source of the last update, to know the area changed since then
+    const QSGTexture *m_sourceTexture = nullptr;
+    quint64 m_sourceSerial = 0;
+    qint64 m_sourceKey = 0;
+    QRect m_sourcePixelRect;
+};
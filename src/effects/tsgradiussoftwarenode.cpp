@@ -0,0 +1,388 @@
+// Copyright (C) 2026 UnionTech Software Technology Co., Ltd.
+// SPDX-License-Identifier: Apache-2.0 OR LGPL-3.0-only OR GPL-2.0-only OR GPL-3.0-only
+
+#include "tsgradiussoftwarenode.h"
+
+#include <private/qsgadaptationlayer_p.h>
+#include <private/qsgsoftwarepixmaptexture_p.h>
+#include <private/qsgtexture_p.h>
+
+#include <QPainter>
+#include <QQuickWindow>
+#include <QVarLengthArray>
+#include <QtMath>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#elif defined(__ARM_NEON)
+#include <arm_neon.h>
+#endif
+
+#include <cmath>
+#include <cstring>
+
+// Multiply the premultiplied pixels by the coverage, round(x * a / 255) in every
+// channel by (x * a + 128 + ((x * a + 128) >> 8)) >> 8, the SIMD paths are the same.
+static inline uint byteMul(uint pixel, uint a)
+{
+    uint t = (pixel & 0xff00ff) * a + 0x800080;
+    t = (t + ((t >> 8) & 0xff00ff)) >> 8;
+    t &= 0xff00ff;
+
+    pixel = ((pixel >> 8) & 0xff00ff) * a + 0x800080;
+    pixel = pixel + ((pixel >> 8) & 0xff00ff);
+    pixel &= 0xff00ff00;
+    return pixel | t;
+}
+
+static void multiplyCoverage(uint *pixels, const uchar *coverage, int count)
+{
+    int i = 0;
+#if defined(__SSE2__)
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i half = _mm_set1_epi16(0x80);
+    for (; i + 4 <= count; i += 4) {
+        int c4;
+        std::memcpy(&c4, coverage + i, sizeof(c4));
+        __m128i c = _mm_cvtsi32_si128(c4);
+        c = _mm_unpacklo_epi8(c, c);
+        c = _mm_unpacklo_epi16(c, c);
+
+        const __m128i px = _mm_loadu_si128(reinterpret_cast<const __m128i *>(pixels + i));
+        __m128i lo = _mm_mullo_epi16(_mm_unpacklo_epi8(px, zero), _mm_unpacklo_epi8(c, zero));
+        __m128i hi = _mm_mullo_epi16(_mm_unpackhi_epi8(px, zero), _mm_unpackhi_epi8(c, zero));
+        lo = _mm_add_epi16(lo, half);
+        hi = _mm_add_epi16(hi, half);
+        lo = _mm_srli_epi16(_mm_add_epi16(lo, _mm_srli_epi16(lo, 8)), 8);
+        hi = _mm_srli_epi16(_mm_add_epi16(hi, _mm_srli_epi16(hi, 8)), 8);
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(pixels + i), _mm_packus_epi16(lo, hi));
+    }
+#elif defined(__ARM_NEON)
+    for (; i + 4 <= count; i += 4) {
+        uint32_t c4;
+        std::memcpy(&c4, coverage + i, sizeof(c4));
+        const uint8x8_t c = vcreate_u8(c4);
+        const uint8x8x2_t c2 = vzip_u8(c, c);
+        const uint16x4x2_t c4x = vzip_u16(vreinterpret_u16_u8(c2.val[0]),
+                                          vreinterpret_u16_u8(c2.val[0]));
+        const uint8x16_t cc = vcombine_u8(vreinterpret_u8_u16(c4x.val[0]),
+                                          vreinterpret_u8_u16(c4x.val[1]));
+
+        const uint8x16_t px = vld1q_u8(reinterpret_cast<const uint8_t *>(pixels + i));
+        const uint16x8_t half = vdupq_n_u16(0x80);
+        const uint16x8_t lo = vaddq_u16(vmull_u8(vget_low_u8(px), vget_low_u8(cc)), half);
+        const uint16x8_t hi = vaddq_u16(vmull_u8(vget_high_u8(px), vget_high_u8(cc)), half);
+        const uint8x16_t result = vcombine_u8(vshrn_n_u16(vsraq_n_u16(lo, lo, 8), 8),
+                                              vshrn_n_u16(vsraq_n_u16(hi, hi, 8), 8));
+        vst1q_u8(reinterpret_cast<uint8_t *>(pixels + i), result);
+    }
+#endif
+    for (; i < count; ++i)
+        pixels[i] = byteMul(pixels[i], coverage[i]);
+}
+
+TSGRadiusSoftwareNode::TSGRadiusSoftwareNode(QQuickWindow *window)
+    : m_window(window)
+{
+    setFlag(QSGNode::UsePreprocess);
+}
+
+void TSGRadiusSoftwareNode::setRect(const QRectF &rect)
+{
+    if (m_rect == rect)
+        return;
+
+    m_rect = rect;
+    markDirty(DirtyGeometry);
+}
+
+void TSGRadiusSoftwareNode::setRadius(qreal radius)
+{
+    if (m_radius == radius)
+        return;
+
+    m_radius = radius;
+    markDirty(DirtyMaterial);
+}
+
+void TSGRadiusSoftwareNode::setTopLeftRadius(qreal radius)
+{
+    if (m_topLeftRadius == radius)
+        return;
+
+    m_topLeftRadius = radius;
+    markDirty(DirtyMaterial);
+}
+
+void TSGRadiusSoftwareNode::setTopRightRadius(qreal radius)
+{
+    if (m_topRightRadius == radius)
+        return;
+
+    m_topRightRadius = radius;
+    markDirty(DirtyMaterial);
+}
+
+void TSGRadiusSoftwareNode::setBottomLeftRadius(qreal radius)
+{
+    if (m_bottomLeftRadius == radius)
+        return;
+
+    m_bottomLeftRadius = radius;
+    markDirty(DirtyMaterial);
+}
+
+void TSGRadiusSoftwareNode::setBottomRightRadius(qreal radius)
+{
+    if (m_bottomRightRadius == radius)
+        return;
+
+    m_bottomRightRadius = radius;
+    markDirty(DirtyMaterial);
+}
+
+void TSGRadiusSoftwareNode::setAntialiasing(bool antialiasing)
+{
+    if (m_antialiasing == antialiasing)
+        return;
+
+    m_antialiasing = antialiasing;
+    m_coverageTables.clear();
+    for (auto &cache : m_cornerCaches)
+        cache.sourceKey = 0;
+    markDirty(DirtyMaterial);
+}
+
+void TSGRadiusSoftwareNode::setSmooth(bool smooth)
+{
+    if (m_smooth == smooth)
+        return;
+
+    m_smooth = smooth;
+    markDirty(DirtyMaterial);
+}
+
+void TSGRadiusSoftwareNode::setTextureProvider(QSGTextureProvider *p)
+{
+    if (p == m_provider)
+        return;
+
+    if (m_provider) {
+        disconnect(m_provider.data(),
+                   &QSGTextureProvider::textureChanged,
+                   this,
+                   &TSGRadiusSoftwareNode::handleTextureChange);
+    }
+
+    m_provider = p;
+    if (m_provider) {
+        connect(m_provider.data(),
+                &QSGTextureProvider::textureChanged,
+                this,
+                &TSGRadiusSoftwareNode::handleTextureChange,
+                Qt::DirectConnection);
+    }
+    markDirty(DirtyMaterial);
+}
+
+void TSGRadiusSoftwareNode::handleTextureChange()
+{
+    markDirty(DirtyMaterial);
+}
+
+void TSGRadiusSoftwareNode::preprocess()
+{
+    if (!m_provider)
+        return;
+
+    if (auto dt = qobject_cast<QSGDynamicTexture *>(m_provider->texture())) {
+        if (dt->updateTexture())
+            markDirty(DirtyMaterial);
+    }
+}
+
+QSGRenderNode::StateFlags TSGRadiusSoftwareNode::changedStates() const
+{
+    return {};
+}
+
+QSGRenderNode::RenderingFlags TSGRadiusSoftwareNode::flags() const
+{
+    return BoundedRectRendering;
+}
+
+QRectF TSGRadiusSoftwareNode::rect() const
+{
+    return m_rect;
+}
+
+QImage TSGRadiusSoftwareNode::sourceImage(QRectF *sourceRect)
+{
+    QSGTexture *texture = m_provider ? m_provider->texture() : nullptr;
+    if (!texture)
+        return {};
+
+    QImage image;
+    if (auto t = qobject_cast<QSGPlainTexture *>(texture)) {
+        image = t->image();
+    } else if (auto t = qobject_cast<QSGLayer *>(texture)) {
+        image = t->toImage();
+    } else if (QByteArrayView(texture->metaObject()->className())
+               == QByteArrayView("QSGSoftwarePixmapTexture")) {
+        image = static_cast<QSGSoftwarePixmapTexture *>(texture)->pixmap().toImage();
+    }
+
+    const QRectF subRect = texture->normalizedTextureSubRect();
+    *sourceRect = QRectF(subRect.x() * image.width(),
+                         subRect.y() * image.height(),
+                         subRect.width() * image.width(),
+                         subRect.height() * image.height());
+    return image;
+}
+
+const QByteArray &TSGRadiusSoftwareNode::coverageTable(int radius)
+{
+    auto it = m_coverageTables.find(radius);
+    if (it != m_coverageTables.end())
+        return *it;
+
+    QByteArray table(radius * radius, Qt::Uninitialized);
+    auto data = reinterpret_cast<uchar *>(table.data());
+    for (int y = 0; y < radius; ++y) {
+        for (int x = 0; x < radius; ++x) {
+            // The center of the circle is at the bottom right of the top left corner
+            const qreal distance = std::hypot(radius - x - 0.5, radius - y - 0.5);
+            const qreal coverage = qBound(0.0, radius - distance + 0.5, 1.0);
+            if (m_antialiasing)
+                data[y * radius + x] = qRound(coverage * 255);
+            else
+                data[y * radius + x] = coverage >= 0.5 ? 255 : 0;
+        }
+    }
+
+    return *m_coverageTables.insert(radius, table);
+}
+
+// The corner images are cached, not masked again if the source is not changed,
+// and their buffers are reused while the radius is not changed.
+QImage TSGRadiusSoftwareNode::maskedCorner(const QImage &source,
+                                           const QRect &sourceRect,
+                                           Corner corner)
+{
+    CornerCache &cache = m_cornerCaches[corner];
+    if (cache.sourceKey == source.cacheKey() && cache.sourceRect == sourceRect)
+        return cache.image;
+
+    // The premultiplied layout of the opaque pixels is the same
+    if (source.format() == QImage::Format_ARGB32_Premultiplied
+        || source.format() == QImage::Format_RGB32) {
+        if (cache.image.size() != sourceRect.size())
+            cache.image = QImage(sourceRect.size(), QImage::Format_ARGB32_Premultiplied);
+        for (int y = 0; y < sourceRect.height(); ++y) {
+            std::memcpy(cache.image.scanLine(y),
+                        source.constScanLine(sourceRect.y() + y) + sourceRect.x() * sizeof(uint),
+                        sourceRect.width() * sizeof(uint));
+        }
+    } else {
+        cache.image =
+            source.copy(sourceRect).convertToFormat(QImage::Format_ARGB32_Premultiplied);
+    }
+
+    QImage &image = cache.image;
+    const int radius = image.width();
+    const auto table = reinterpret_cast<const uchar *>(coverageTable(radius).constData());
+    const bool flipX = corner == TopRight || corner == BottomRight;
+    const bool flipY = corner == BottomLeft || corner == BottomRight;
+
+    QVarLengthArray<uchar, 128> row(radius);
+    for (int y = 0; y < image.height(); ++y) {
+        const uchar *coverage = table + (flipY ? radius - 1 - y : y) * radius;
+        if (flipX) {
+            for (int x = 0; x < radius; ++x)
+                row[x] = coverage[radius - 1 - x];
+            coverage = row.constData();
+        }
+        multiplyCoverage(reinterpret_cast<uint *>(image.scanLine(y)), coverage, radius);
+    }
+
+    cache.sourceKey = source.cacheKey();
+    cache.sourceRect = sourceRect;
+    return image;
+}
+
+void TSGRadiusSoftwareNode::render(const RenderState *state)
+{
+    QRectF sourceRect;
+    const QImage source = sourceImage(&sourceRect);
+    if (source.isNull() || sourceRect.isEmpty() || m_rect.isEmpty())
+        return;
+
+    QSGRendererInterface *rif = m_window->rendererInterface();
+    auto p = static_cast<QPainter *>(rif->getResource(m_window,
+                                                      QSGRendererInterface::PainterResource));
+    Q_ASSERT(p);
+
+    const QRegion *clipRegion = state->clipRegion();
+    if (clipRegion && !clipRegion->isEmpty())
+        p->setClipRegion(*clipRegion, Qt::IntersectClip);
+    p->setTransform(matrix()->toTransform());
+    p->setOpacity(inheritedOpacity());
+    p->setRenderHint(QPainter::SmoothPixmapTransform, m_smooth);
+
+    const qreal scale = sourceRect.width() / m_rect.width();
+    const qreal maxRadius = qMin(m_rect.width(), m_rect.height()) / 2;
+
+    struct CornerData
+    {
+        Corner corner;
+        QRect sourceRect;
+        QRectF targetRect;
+    };
+    QVarLengthArray<CornerData, 4> corners;
+    QRegion clip(m_rect.toAlignedRect());
+
+    const auto addCorner = [&](Corner corner, qreal radius) {
+        if (radius < 0)
+            radius = m_radius;
+        // The radius in the pixels of the source
+        const int pixelRadius = qCeil(qMin(radius, maxRadius) * scale);
+        if (pixelRadius <= 0)
+            return;
+
+        const qreal targetRadius = pixelRadius / scale;
+        const bool right = corner == TopRight || corner == BottomRight;
+        const bool bottom = corner == BottomLeft || corner == BottomRight;
+        const QPoint sourcePos(qFloor(right ? sourceRect.right() - pixelRadius : sourceRect.left()),
+                               qFloor(bottom ? sourceRect.bottom() - pixelRadius
+                                             : sourceRect.top()));
+        const QPointF targetPos(right ? m_rect.right() - targetRadius : m_rect.left(),
+                                bottom ? m_rect.bottom() - targetRadius : m_rect.top());
+
+        CornerData data{ corner,
+                         QRect(sourcePos, QSize(pixelRadius, pixelRadius)),
+                         QRectF(targetPos, QSizeF(targetRadius, targetRadius)) };
+        if (!source.rect().contains(data.sourceRect))
+            return;
+        clip -= data.targetRect.toAlignedRect();
+        corners.append(data);
+    };
+
+    addCorner(TopLeft, m_topLeftRadius);
+    addCorner(TopRight, m_topRightRadius);
+    addCorner(BottomLeft, m_bottomLeftRadius);
+    addCorner(BottomRight, m_bottomRightRadius);
+
+    if (corners.isEmpty()) {
+        p->drawImage(m_rect, source, sourceRect);
+        return;
+    }
+
+    // The area out of the corners, then the corners with the coverage
+    p->save();
+    p->setClipRegion(clip, Qt::IntersectClip);
+    p->drawImage(m_rect, source, sourceRect);
+    p->restore();
+
+    for (const auto &corner : std::as_const(corners))
+        p->drawImage(corner.targetRect, maskedCorner(source, corner.sourceRect, corner.corner));
+}
@@ -0,0 +1,90 @@
+// Copyright (C) 2026 UnionTech Software Technology Co., Ltd.
+// SPDX-License-Identifier: Apache-2.0 OR LGPL-3.0-only OR GPL-2.0-only OR GPL-3.0-only
+
+#pragma once
+
+#include <QHash>
+#include <QImage>
+#include <QPointer>
+#include <QSGRenderNode>
+#include <QSGTextureProvider>
+
+QT_BEGIN_NAMESPACE
+class QQuickWindow;
+QT_END_NAMESPACE
+
+// The radius image node of the software renderer, the source is painted as
+// usual except the corners, only the pixels of the corners are masked.
+class TSGRadiusSoftwareNode
+    : public QObject
+    , public QSGRenderNode
+{
+    Q_OBJECT
+public:
+    explicit TSGRadiusSoftwareNode(QQuickWindow *window);
+
+    void setRect(const QRectF &rect);
+
+    void setRadius(qreal radius);
+    void setTopLeftRadius(qreal radius);
+    void setTopRightRadius(qreal radius);
+    void setBottomLeftRadius(qreal radius);
+    void setBottomRightRadius(qreal radius);
+
+    void setAntialiasing(bool antialiasing);
+    void setSmooth(bool smooth);
+    void setTextureProvider(QSGTextureProvider *p);
+
+    void preprocess() override;
+    void render(const RenderState *state) override;
+    StateFlags changedStates() const override;
+    RenderingFlags flags() const override;
+    QRectF rect() const override;
+
+public Q_SLOTS:
+    void handleTextureChange();
+
+protected:
+    // Returns the image to paint, and its area to paint in the pixels of the image
+    virtual QImage sourceImage(QRectF *sourceRect);
+
+    inline QSGTexture *sourceTexture() const
+    {
+        return m_provider ? m_provider->texture() : nullptr;
+    }
+
+private:
+    enum Corner {
+        TopLeft,
+        TopRight,
+        BottomLeft,
+        BottomRight,
+    };
+
+    const QByteArray &coverageTable(int radius);
+    QImage maskedCorner(const QImage &source, const QRect &sourceRect, Corner corner);
+
+    QQuickWindow *m_window;
+    QPointer<QSGTextureProvider> m_provider;
+    QRectF m_rect;
+
+    qreal m_radius = 0;
+    qreal m_topLeftRadius = -1;
+    qreal m_topRightRadius = -1;
+    qreal m_bottomLeftRadius = -1;
+    qreal m_bottomRightRadius = -1;
+
+    bool m_antialiasing = false;
+    bool m_smooth = true;
+    // The quarter circle coverage of the radius in pixels, in the orientation of
+    // the top left corner
+    QHash<int, QByteArray> m_coverageTables;
+
+    struct CornerCache
+    {
+        qint64 sourceKey = 0;
+        QRect sourceRect;
+        QImage image;
+    };
+    CornerCache m_cornerCaches[4];
+};
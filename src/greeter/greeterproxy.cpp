@@ -138,8 +138,10 @@ void GreeterProxy::setLock(bool isLocked)
 {
     if (isLocked && !m_isLocked) {
         m_isLocked = true;
-        if (m_lockScreen && !m_lockScreen->isVisible())
-            m_lockScreen->lock();
+        // Load the lockscreen plugin if it's not loaded yet, it sets m_lockScreen
+        auto lockScreen = Helper::instance()->lockScreen();
+        if (lockScreen && !lockScreen->isVisible())
+            lockScreen->lock();
         Q_EMIT lockChanged(true);
     } else if (!isLocked && m_isLocked) {
         m_failedAttempts = 0;
@@ -18,19 +18,28 @@
 #include <woutputviewport.h>
 #include <wquickcursor.h>
 #include <wquicktextureproxy.h>
+#include <wrenderhelper.h>
 #include <wtools.h>
 
 #include <qwcompositor.h>
 #include <qwdisplay.h>
 #include <qwlayershellv1.h>
+#include <qwoutput.h>
+#include <qwrenderer.h>
+#include <qwtexture.h>
 
 #include <QLoggingCategory>
 #include <QQueue>
 #include <QQuickItemGrabResult>
 #include <QSGTextureProvider>
 
+#include <memory>
 #include <utility>
 
+extern "C" {
+#include <wlr/render/pass.h>
+}
+
 static inline QRectF scaledRect(const QRectF &rect, qreal devicePixelRatio)
 {
     return { rect.x() * devicePixelRatio,
@@ -164,8 +173,11 @@ void CaptureContextV1::onCapture(treeland_capture_frame_v1 *frame)
 void CaptureContextV1::handleFrameCopy(QW_NAMESPACE::qw_buffer *buffer)
 {
     if (m_captureSource) {
-        m_captureSource->copyBuffer(buffer);
-        m_frame->sendReady();
+        auto renderer = outputRenderWindow() ? outputRenderWindow()->renderer() : nullptr;
+        if (m_captureSource->copyBuffer(buffer, renderer))
+            m_frame->sendReady();
+        else
+            m_frame->sendFailed();
     } else {
         wl_client_post_implementation_error(wl_resource_get_client(m_handle->resource),
                                             "Source is not ready, cannot capture.");
@@ -236,6 +248,7 @@ void CaptureContextV1::handleSourceDestroyed()
 void CaptureContextV1::handleSessionStart()
 {
     m_currentFrameData.acked = true;
+    m_lastFrameSequence = -1;
     auto conn = connect(outputRenderWindow(),
                         &WOutputRenderWindow::renderEnd,
                         this,
@@ -289,8 +302,26 @@ void CaptureContextV1::handleRenderEnd()
         qCWarning(treelandCapture) << "Source has been invalid while connection still exists.";
         return;
     }
+    // The source isn't updated since the last frame, nothing new for the client.
+    // Don't compare the buffers, the swapchain and the clients reuse them.
+    const qint64 sequence = source->contentSequence();
+    if (sequence == m_lastFrameSequence)
+        return;
+
+    wlr_dmabuf_attributes attribs{};
+    if (!dmabuf->get_dmabuf(&attribs)) {
+        // e.g. the pixman renderer, the session can only share dmabuf
+        qCWarning(treelandCapture) << "Source buffer is not a dmabuf, cancel the session.";
+        disconnect(outputRenderWindow(),
+                   &WOutputRenderWindow::renderEnd,
+                   this,
+                   &CaptureContextV1::handleRenderEnd);
+        session()->sendProduceMoreCancel();
+        return;
+    }
     m_currentFrameData = {};
-    dmabuf->get_dmabuf(&m_currentFrameData.attribs);
+    m_currentFrameData.attribs = attribs;
+    m_lastFrameSequence = sequence;
 
     union
     {
@@ -303,8 +334,7 @@ void CaptureContextV1::handleRenderEnd()
         };
     } modifierUnion(m_currentFrameData.attribs.modifier);
 
-    qCInfo(treelandCapture) << "Session:" << session();
-    qCInfo(treelandCapture) << "Session resource:" << session()->resource;
+    qCDebug(treelandCapture) << "Session:" << session() << "resource:" << session()->resource;
     treeland_capture_session_v1_send_frame(session()->resource,
                                            source->cropRect().x(),
                                            source->cropRect().y(),
@@ -766,6 +796,12 @@ CaptureSource::CaptureSourceType CaptureSourceSurface::sourceType()
     return CaptureSource::Surface;
 }
 
+quint64 CaptureSourceSurface::contentSequence() const
+{
+    auto surface = m_surfaceItemContent ? m_surfaceItemContent->surface() : nullptr;
+    return surface ? surface->handle()->handle()->current.seq : 0;
+}
+
 QRect CaptureSourceSurface::cropRect() const
 {
     return m_surfaceItemContent
@@ -919,23 +955,88 @@ qw_buffer *CaptureSource::sourceDMABuffer()
     return buffer;
 }
 
-void CaptureSource::copyBuffer(qw_buffer *buffer)
+bool CaptureSource::copyBuffer(qw_buffer *buffer, qw_renderer *renderer)
 {
-    Q_ASSERT(imageValid());
-    auto width = cropRect().width();
-    auto height = cropRect().height();
+    const QSize bufferSize(buffer->handle()->width, buffer->handle()->height);
+    if (bufferSize != cropRect().size()) {
+        qCWarning(treelandCapture) << "Buffer size" << bufferSize << "doesn't match the capture region"
+                                   << cropRect();
+        return false;
+    }
+
     uint32_t format;
     size_t stride;
     void *data;
-    buffer->begin_data_ptr_access(WLR_BUFFER_DATA_PTR_ACCESS_WRITE, &data, &format, &stride);
-    Q_ASSERT(stride == static_cast<size_t>(width) * 4); // For QImage
-    QImage img = image().copy(cropRect());
-    auto bufFormat = WTools::toImageFormat(format);
-    if (image().format() != bufFormat) {
-        img = image().convertToFormat(bufFormat);
+    if (buffer->begin_data_ptr_access(WLR_BUFFER_DATA_PTR_ACCESS_WRITE, &data, &format, &stride)) {
+        const bool ok = copyImageLines(data, format, stride, bufferSize);
+        buffer->end_data_ptr_access();
+        return ok;
     }
-    memcpy(data, img.constBits(), stride * height);
-    buffer->end_data_ptr_access();
+
+    return blitSourceBuffer(buffer, renderer);
+}
+
+bool CaptureSource::copyImageLines(void *data, uint32_t format, size_t stride, const QSize &bufferSize)
+{
+    if (!imageValid())
+        return false;
+
+    const auto bufFormat = WTools::toImageFormat(format);
+    if (bufFormat == QImage::Format_Invalid)
+        return false;
+
+    const QRect rect = cropRect().intersected(m_image.rect());
+    if (rect.size() != bufferSize)
+        return false;
+
+    // Refer to the cropped lines only, avoid to copy or convert the whole image
+    const int bytesPerPixel = m_image.depth() / 8;
+    QImage cropped(m_image.constScanLine(rect.y()) + rect.x() * bytesPerPixel,
+                   rect.width(),
+                   rect.height(),
+                   m_image.bytesPerLine(),
+                   m_image.format());
+    if (cropped.format() != bufFormat)
+        cropped = cropped.convertToFormat(bufFormat);
+
+    const size_t lineBytes = size_t(rect.width()) * cropped.depth() / 8;
+    if (lineBytes > stride)
+        return false;
+
+    auto dst = static_cast<uchar *>(data);
+    for (int y = 0; y < rect.height(); ++y)
+        memcpy(dst + y * stride, cropped.constScanLine(y), lineBytes);
+
+    return true;
+}
+
+bool CaptureSource::blitSourceBuffer(qw_buffer *buffer, qw_renderer *renderer)
+{
+    auto source = internalBuffer();
+    if (!renderer || !source)
+        return false;
+
+    std::unique_ptr<qw_texture> texture{ qw_texture::from_buffer(*renderer, *source) };
+    if (!texture)
+        return false;
+
+    const QRect rect = cropRect();
+    // The GL context is shared with Qt, same as the mirror blit of the outputs
+    WRenderHelper::resetGlState();
+    bool ok = false;
+    if (auto pass = wlr_renderer_begin_buffer_pass(*renderer, *buffer, nullptr)) {
+        wlr_render_texture_options options{};
+        options.texture = texture->handle();
+        options.src_box = { double(rect.x()), double(rect.y()),
+                            double(rect.width()), double(rect.height()) };
+        options.dst_box = { 0, 0, rect.width(), rect.height() };
+        options.blend_mode = WLR_RENDER_BLEND_MODE_NONE;
+        wlr_render_pass_add_texture(pass, &options);
+        ok = wlr_render_pass_submit(pass);
+    }
+    WRenderHelper::resetGlState();
+
+    return ok;
 }
 
 CaptureSourceOutput::CaptureSourceOutput(WOutputViewport *viewport)
@@ -971,6 +1072,13 @@ CaptureSource::CaptureSourceType CaptureSourceOutput::sourceType()
     return CaptureSource::Output;
 }
 
+quint64 CaptureSourceOutput::contentSequence() const
+{
+    return m_outputViewport && m_outputViewport->output()
+        ? m_outputViewport->output()->nativeHandle()->commit_seq
+        : 0;
+}
+
 CaptureSourceRegion::CaptureSourceRegion(WOutputViewport *viewport, const QRect &region)
     : CaptureSource(viewport, viewport->devicePixelRatio(), nullptr)
 {
@@ -992,6 +1100,16 @@ CaptureSource::CaptureSourceType CaptureSourceRegion::sourceType()
     return CaptureSource::Region;
 }
 
+quint64 CaptureSourceRegion::contentSequence() const
+{
+    quint64 sequence = 0;
+    for (const auto &viewportRegion : std::as_const(m_viewportRegions)) {
+        if (viewportRegion.first && viewportRegion.first->output())
+            sequence += viewportRegion.first->output()->nativeHandle()->commit_seq;
+    }
+    return sequence;
+}
+
 QRect CaptureSourceRegion::cropRect() const
 {
     QRect result{};
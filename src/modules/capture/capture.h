@@ -100,9 +100,12 @@ public:
 
     /**
      * @brief copyBuffer render captured contents to a buffer
-     * @param buffer buffer prepared by client
+     * @param buffer buffer prepared by client, the shm buffer is filled with the cropped
+     * lines of the image, the dmabuf buffer is blitted from the source buffer on GPU
+     * @param renderer used for the blit of the dmabuf buffer
+     * @return false if the buffer can't be filled
      */
-    void copyBuffer(qw_buffer *buffer);
+    bool copyBuffer(qw_buffer *buffer, qw_renderer *renderer);
 
     // Cropped area of source
     virtual QRect cropRect() const = 0;
@@ -112,6 +115,10 @@ public:
 
     virtual CaptureSourceType sourceType() = 0;
 
+    // Increased when the contents of the source are updated, e.g. the commit
+    // sequence of the output or the surface
+    virtual quint64 contentSequence() const = 0;
+
 protected:
     virtual qw_buffer *internalBuffer() = 0;
 
@@ -135,6 +142,9 @@ protected:
     }
 
     friend QDebug operator<<(QDebug debug, CaptureSource &captureSource);
+    bool copyImageLines(void *data, uint32_t format, size_t stride, const QSize &bufferSize);
+    bool blitSourceBuffer(qw_buffer *buffer, qw_renderer *renderer);
+
     QImage m_image;
     QMetaObject::Connection m_bufferConn;
     QList<QPair<QPointer<QQuickItem>, WTextureProviderProvider *>> m_sourceList;
@@ -251,6 +261,8 @@ private:
     QPointer<treeland_capture_session_v1> m_session{ nullptr };
     const QPointer<WOutputRenderWindow> m_outputRenderWindow;
     FrameData m_currentFrameData{};
+    // The content sequence of the source in the last frame, -1 if no frame is sent
+    qint64 m_lastFrameSequence = -1;
     QRect m_captureRegion;
 };
 class CaptureSourceSelector;
@@ -323,6 +335,7 @@ public:
     CaptureSourceType sourceType() override;
     QRect cropRect() const override;
     QSize sourceSize() const override;
+    quint64 contentSequence() const override;
 
 private:
     const QPointer<WSurfaceItemContent> m_surfaceItemContent;
@@ -337,6 +350,7 @@ public:
     CaptureSourceType sourceType() override;
     QRect cropRect() const override;
     QSize sourceSize() const override;
+    quint64 contentSequence() const override;
 
 private:
     const QPointer<WOutputViewport> m_outputViewport;
@@ -351,6 +365,7 @@ public:
     CaptureSourceType sourceType() override;
     QRect cropRect() const override;
     QSize sourceSize() const override;
+    quint64 contentSequence() const override;
     bool addViewportRegion(WOutputViewport *viewport, const QRect &region);
 
 private:
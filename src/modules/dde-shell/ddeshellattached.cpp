@@ -4,8 +4,6 @@
 #include "ddeshellattached.h"
 #include "ddeshellmanagerinterfacev1.h"
 
-#include <QTimer>
-
 DDEShellAttached::DDEShellAttached(QQuickItem *target, QObject *parent)
     : QObject(parent)
     , m_target(target)
@@ -15,39 +13,25 @@ DDEShellAttached::DDEShellAttached(QQuickItem *target, QObject *parent)
 WindowOverlapChecker::WindowOverlapChecker(QQuickItem *target, QObject *parent)
     : DDEShellAttached(target, parent)
 {
-    QTimer *timer = new QTimer(this);
-    timer->setSingleShot(true);
-    timer->setInterval(300);
-
-    connect(timer, &QTimer::timeout, this, [this] {
+    auto update = [this] {
         QRectF rect{ m_target->x(), m_target->y(), m_target->width(), m_target->height() };
-        region -= m_lastRect;
-        m_lastRect = rect.toRect();
-        region += m_lastRect;
-        WindowOverlapCheckerInterface::checkRegionalConflict(region);
-    });
-
-    auto update = [timer] {
-        if (!timer->isActive()) {
-            timer->start();
-        }
+        WindowOverlapCheckerInterface::updateWindow(this, rect.toRect());
     };
 
-    connect(target, &QQuickItem::xChanged, update);
-    connect(target, &QQuickItem::yChanged, update);
-    connect(target, &QQuickItem::heightChanged, update);
-    connect(target, &QQuickItem::widthChanged, update);
+    connect(target, &QQuickItem::xChanged, this, update);
+    connect(target, &QQuickItem::yChanged, this, update);
+    connect(target, &QQuickItem::heightChanged, this, update);
+    connect(target, &QQuickItem::widthChanged, this, update);
     connect(target, &QQuickItem::destroyed, this, [this] {
-        region -= m_lastRect;
-        WindowOverlapCheckerInterface::checkRegionalConflict(region);
+        WindowOverlapCheckerInterface::removeWindow(this);
     });
 
-    timer->start();
+    update();
 }
 
 WindowOverlapChecker::~WindowOverlapChecker()
 {
-region -= m_lastRect;
+    WindowOverlapCheckerInterface::removeWindow(this);
 }
 
 void WindowOverlapChecker::setOverlapped(bool overlapped)
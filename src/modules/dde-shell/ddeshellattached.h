@@ -38,9 +38,6 @@ private:
     void setOverlapped(bool overlapped);
 
     bool m_overlapped{ false };
-    QRect m_lastRect;
-
-    inline static QRegion region;
 };
 
 class DDEShellHelper : public QObject
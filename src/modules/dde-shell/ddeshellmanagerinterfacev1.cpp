@@ -2,6 +2,7 @@
 // SPDX-License-Identifier: Apache-2.0 OR LGPL-3.0-only OR GPL-2.0-only OR GPL-3.0-only
 
 #include "ddeshellmanagerinterfacev1.h"
+#include "overlapindex.h"
 
 #include "qwayland-server-treeland-dde-shell-v1.h"
 
@@ -18,13 +19,13 @@
 
 #define TREELAND_DDE_SHELL_MANAGER_V1_VERSION 1
 
-static QList<DDEShellSurfaceInterface *> s_shellSurfaces;
-static QList<DDEActiveInterface *> s_ddeActives;
+// Keyed by the wlr_surface and the WSeat, these are looked up on every activation
+static QHash<const wlr_surface *, DDEShellSurfaceInterface *> s_shellSurfaces;
+static QMultiHash<const WSeat *, DDEActiveInterface *> s_ddeActives;
 static QList<WindowOverlapCheckerInterface *> s_OverlapCheckers;
 static QList<MultiTaskViewInterface *> s_multiTaskViews;
 static QList<WindowPickerInterface *> s_windowPickers;
 static QList<LockScreenInterface *> s_lockScreens;
-static QMap<WindowOverlapCheckerInterface *, QRect> s_conflictList;
 
 class DDEShellManagerInterfaceV1Private : public QtWaylandServer::treeland_dde_shell_manager_v1
 {
@@ -137,10 +138,12 @@ void DDEShellManagerInterfaceV1Private::get_shell_surface(Resource *resource,
     }
 
     auto shellSurface = new DDEShellSurfaceInterface(surface, shell_resource);
-    s_shellSurfaces.append(shellSurface);
+    const wlr_surface *key = wlr_surface_from_resource(surface);
+    s_shellSurfaces.insert(key, shellSurface);
 
-    QObject::connect(shellSurface, &QObject::destroyed, [shellSurface]() {
-        s_shellSurfaces.removeOne(shellSurface);
+    QObject::connect(shellSurface, &QObject::destroyed, [key, shellSurface]() {
+        if (s_shellSurfaces.value(key) == shellSurface)
+            s_shellSurfaces.remove(key);
     });
 
     Q_EMIT q->surfaceCreated(shellSurface);
@@ -166,10 +169,11 @@ void DDEShellManagerInterfaceV1Private::get_treeland_dde_active(Resource *resour
     }
 
     auto active = new DDEActiveInterface(seat, active_resource);
-    s_ddeActives.append(active);
+    const WSeat *key = active->seat();
+    s_ddeActives.insert(key, active);
 
-    QObject::connect(active, &QObject::destroyed, [active]() {
-        s_ddeActives.removeOne(active);
+    QObject::connect(active, &QObject::destroyed, [key, active]() {
+        s_ddeActives.remove(key, active);
     });
 
     Q_EMIT q->activeCreated(active);
@@ -472,13 +476,10 @@ DDEShellSurfaceInterface *DDEShellSurfaceInterface::get(wl_resource *native)
 
 DDEShellSurfaceInterface *DDEShellSurfaceInterface::get(WSurface *surface)
 {
-    for (DDEShellSurfaceInterface *shellSurface : std::as_const(s_shellSurfaces)) {
-        if (shellSurface->wSurface() == surface) {
-            return shellSurface;
-        }
-    }
+    if (!surface)
+        return nullptr;
 
-    return nullptr;
+    return s_shellSurfaces.value(surface->handle()->handle());
 }
 
 class DDEActiveInterfacePrivate : public QtWaylandServer::treeland_dde_active_v1
@@ -549,38 +550,30 @@ void DDEActiveInterface::sendDrop()
 
 void DDEActiveInterface::sendActiveIn(uint32_t reason, const WSeat *seat)
 {
-    for (auto interface : s_ddeActives) {
-        if (interface->seat() == seat) {
-            interface->sendActiveIn(reason);
-        }
-    }
+    const auto actives = s_ddeActives.values(seat);
+    for (auto interface : actives)
+        interface->sendActiveIn(reason);
 }
 
 void DDEActiveInterface::sendActiveOut(uint32_t reason, const WSeat *seat)
 {
-    for (auto interface : s_ddeActives) {
-        if (interface->seat() == seat) {
-            interface->sendActiveOut(reason);
-        }
-    }
+    const auto actives = s_ddeActives.values(seat);
+    for (auto interface : actives)
+        interface->sendActiveOut(reason);
 }
 
 void DDEActiveInterface::sendStartDrag(const WSeat *seat)
 {
-    for (auto interface : s_ddeActives) {
-        if (interface->seat() == seat) {
-            interface->sendStartDrag();
-        }
-    }
+    const auto actives = s_ddeActives.values(seat);
+    for (auto interface : actives)
+        interface->sendStartDrag();
 }
 
 void DDEActiveInterface::sendDrop(const WSeat *seat)
 {
-    for (auto interface : s_ddeActives) {
-        if (interface->seat() == seat) {
-            interface->sendDrop();
-        }
-    }
+    const auto actives = s_ddeActives.values(seat);
+    for (auto interface : actives)
+        interface->sendDrop();
 }
 
 class WindowOverlapCheckerInterfacePrivate : public QtWaylandServer::treeland_window_overlap_checker
@@ -629,16 +622,23 @@ void WindowOverlapCheckerInterface::sendOverlapped(bool overlapped)
     }
 }
 
-void WindowOverlapCheckerInterface::checkRegionalConflict(const QRegion &region)
+// The checkers are the areas, keyed by the WindowOverlapCheckerInterface
+static OverlapIndex &overlapIndex()
 {
-    for (auto &&[interface, checkRect] : s_conflictList.asKeyValueRange()) {
-        if (region.intersects(checkRect)) {
-            interface->sendOverlapped(true);
-            continue;
-        } else {
-            interface->sendOverlapped(false);
-        }
-    }
+    static OverlapIndex index([](OverlapIndex::Id area, bool overlapped) {
+        reinterpret_cast<WindowOverlapCheckerInterface *>(area)->sendOverlapped(overlapped);
+    });
+    return index;
+}
+
+void WindowOverlapCheckerInterface::updateWindow(const QObject *window, const QRect &geometry)
+{
+    overlapIndex().setWindow(reinterpret_cast<OverlapIndex::Id>(window), geometry);
+}
+
+void WindowOverlapCheckerInterface::removeWindow(const QObject *window)
+{
+    overlapIndex().removeWindow(reinterpret_cast<OverlapIndex::Id>(window));
 }
 
 WindowOverlapCheckerInterfacePrivate::WindowOverlapCheckerInterfacePrivate(
@@ -651,7 +651,7 @@ WindowOverlapCheckerInterfacePrivate::WindowOverlapCheckerInterfacePrivate(
 
 void WindowOverlapCheckerInterfacePrivate::destroy_resource([[maybe_unused]] Resource *resource)
 {
-    s_conflictList.remove(q);
+    overlapIndex().removeArea(reinterpret_cast<OverlapIndex::Id>(q));
     delete q;
 }
 
@@ -689,7 +689,9 @@ void WindowOverlapCheckerInterfacePrivate::update(Resource *resource,
         return;
     }
 
-    s_conflictList.insert(q, checkRect);
+    // The rect is relative to the output
+    checkRect.translate(wOutput->position());
+    overlapIndex().setArea(reinterpret_cast<OverlapIndex::Id>(q), checkRect);
     Q_EMIT q->refresh();
 }
 
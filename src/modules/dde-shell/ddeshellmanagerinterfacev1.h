@@ -8,6 +8,7 @@
 #include <wserver.h>
 
 #include <QObject>
+#include <QRect>
 
 WAYLIB_SERVER_USE_NAMESPACE
 QW_USE_NAMESPACE
@@ -140,7 +141,9 @@ public:
     ~WindowOverlapCheckerInterface() override;
     void sendOverlapped(bool overlapped);
 
-    static void checkRegionalConflict(const QRegion &region);
+    // The windows checked by all overlap checkers, in the global logical coordinates
+    static void updateWindow(const QObject *window, const QRect &geometry);
+    static void removeWindow(const QObject *window);
 
 Q_SIGNALS:
     void refresh();
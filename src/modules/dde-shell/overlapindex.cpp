@@ -0,0 +1,155 @@
+// Copyright (C) 2026 UnionTech Software Technology Co., Ltd.
+// SPDX-License-Identifier: Apache-2.0 OR LGPL-3.0-only OR GPL-2.0-only OR GPL-3.0-only
+
+#include "overlapindex.h"
+
+#include <algorithm>
+
+static constexpr int CellSize = 256;
+
+static inline int cellOf(int v)
+{
+    return v >= 0 ? v / CellSize : (v + 1) / CellSize - 1;
+}
+
+template<typename F>
+static void forEachCell(const QRect &rect, F f)
+{
+    if (rect.isEmpty())
+        return;
+
+    const int right = cellOf(rect.right());
+    const int bottom = cellOf(rect.bottom());
+    for (int x = cellOf(rect.left()); x <= right; ++x) {
+        for (int y = cellOf(rect.top()); y <= bottom; ++y)
+            f((quint64(quint32(x)) << 32) | quint32(y));
+    }
+}
+
+static void removeDuplicates(QList<OverlapIndex::Id> &ids)
+{
+    std::sort(ids.begin(), ids.end());
+    ids.erase(std::unique(ids.begin(), ids.end()), ids.end());
+}
+
+void OverlapIndex::Grid::insert(Id id, const QRect &rect)
+{
+    forEachCell(rect, [this, id](quint64 cell) {
+        m_cells[cell].append(id);
+    });
+}
+
+void OverlapIndex::Grid::remove(Id id, const QRect &rect)
+{
+    forEachCell(rect, [this, id](quint64 cell) {
+        auto it = m_cells.find(cell);
+        if (it == m_cells.end())
+            return;
+        it->removeOne(id);
+        if (it->isEmpty())
+            m_cells.erase(it);
+    });
+}
+
+void OverlapIndex::Grid::query(const QRect &rect, QList<Id> &ids) const
+{
+    forEachCell(rect, [this, &ids](quint64 cell) {
+        auto it = m_cells.constFind(cell);
+        if (it != m_cells.cend())
+            ids.append(*it);
+    });
+}
+
+OverlapIndex::OverlapIndex(Notifier notifier)
+    : m_notifier(std::move(notifier))
+{
+}
+
+void OverlapIndex::setWindow(Id window, const QRect &geometry)
+{
+    auto it = m_windows.find(window);
+    QRect oldGeometry;
+    if (it != m_windows.end()) {
+        if (*it == geometry)
+            return;
+        oldGeometry = *it;
+        *it = geometry;
+    } else {
+        m_windows.insert(window, geometry);
+    }
+
+    m_windowGrid.remove(window, oldGeometry);
+    m_windowGrid.insert(window, geometry);
+    updateAreas(oldGeometry, geometry);
+}
+
+void OverlapIndex::removeWindow(Id window)
+{
+    auto it = m_windows.find(window);
+    if (it == m_windows.end())
+        return;
+
+    const QRect oldGeometry = *it;
+    m_windows.erase(it);
+    m_windowGrid.remove(window, oldGeometry);
+    updateAreas(oldGeometry, QRect());
+}
+
+void OverlapIndex::setArea(Id area, const QRect &geometry)
+{
+    auto it = m_areas.find(area);
+    if (it == m_areas.end())
+        it = m_areas.insert(area, Area{});
+    m_areaGrid.remove(area, it->geometry);
+    m_areaGrid.insert(area, geometry);
+    it->geometry = geometry;
+
+    QList<Id> windows;
+    m_windowGrid.query(geometry, windows);
+    removeDuplicates(windows);
+    it->windows = std::count_if(windows.cbegin(), windows.cend(), [this, &geometry](Id window) {
+        return m_windows.value(window).intersects(geometry);
+    });
+
+    if (m_notifier)
+        m_notifier(area, it->windows > 0);
+}
+
+void OverlapIndex::removeArea(Id area)
+{
+    auto it = m_areas.find(area);
+    if (it == m_areas.end())
+        return;
+
+    m_areaGrid.remove(area, it->geometry);
+    m_areas.erase(it);
+}
+
+bool OverlapIndex::isOverlapped(Id area) const
+{
+    return m_areas.value(area).windows > 0;
+}
+
+void OverlapIndex::updateAreas(const QRect &oldGeometry, const QRect &newGeometry)
+{
+    QList<Id> areas;
+    m_areaGrid.query(oldGeometry, areas);
+    m_areaGrid.query(newGeometry, areas);
+    if (areas.isEmpty())
+        return;
+    removeDuplicates(areas);
+
+    for (Id id : std::as_const(areas)) {
+        Area &area = m_areas[id];
+        const bool wasIntersected = area.geometry.intersects(oldGeometry);
+        const bool isIntersected = area.geometry.intersects(newGeometry);
+        if (wasIntersected == isIntersected)
+            continue;
+
+        const bool wasOverlapped = area.windows > 0;
+        area.windows += isIntersected ? 1 : -1;
+        Q_ASSERT(area.windows >= 0);
+        if (m_notifier && wasOverlapped != (area.windows > 0))
+            m_notifier(id, area.windows > 0);
+    }
+}
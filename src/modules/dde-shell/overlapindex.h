@@ -0,0 +1,58 @@
+// Copyright (C) 2026 UnionTech Software Technology Co., Ltd.
+// SPDX-License-Identifier: Apache-2.0 OR LGPL-3.0-only OR GPL-2.0-only OR GPL-3.0-only
+#pragma once
+
+#include <QHash>
+#include <QList>
+#include <QRect>
+
+#include <functional>
+
+// Track whether the areas (e.g. the dock) are overlapped by the windows. The
+// windows and the areas are kept in the uniform grids, a change of a window
+// only checks the areas in the cells it touches.
+class OverlapIndex
+{
+public:
+    using Id = quintptr;
+    // Called when an area becomes overlapped or not, and once for every setArea()
+    using Notifier = std::function<void(Id area, bool overlapped)>;
+
+    explicit OverlapIndex(Notifier notifier = {});
+
+    void setWindow(Id window, const QRect &geometry);
+    void removeWindow(Id window);
+
+    void setArea(Id area, const QRect &geometry);
+    void removeArea(Id area);
+
+    bool isOverlapped(Id area) const;
+
+private:
+    class Grid
+    {
+    public:
+        void insert(Id id, const QRect &rect);
+        void remove(Id id, const QRect &rect);
+        // Append the ids in the cells touched by the rect, may be duplicated
+        void query(const QRect &rect, QList<Id> &ids) const;
+
+    private:
+        QHash<quint64, QList<Id>> m_cells;
+    };
+
+    struct Area
+    {
+        QRect geometry;
+        // the windows intersecting the geometry
+        int windows = 0;
+    };
+
+    void updateAreas(const QRect &oldGeometry, const QRect &newGeometry);
+
+    Notifier m_notifier;
+    QHash<Id, QRect> m_windows;
+    QHash<Id, Area> m_areas;
+    Grid m_windowGrid;
+    Grid m_areaGrid;
+};
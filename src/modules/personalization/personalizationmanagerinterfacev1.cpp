@@ -29,9 +29,14 @@
 #include <QJsonObject>
 #include <QSettings>
 #include <QStandardPaths>
+#include <QThreadPool>
 
+#include <cstdio>
 #include <optional>
+#include <fcntl.h>
+#include <sys/sendfile.h>
 #include <sys/socket.h>
+#include <sys/stat.h>
 #include <unistd.h>
 
 DCORE_USE_NAMESPACE
@@ -98,6 +103,10 @@ public:
     QString cacheDirectory;
     QString settingFile;
     QString iniMetaData;
+    // Copy the wallpaper files in the commit order, out of the main thread
+    QThreadPool wallpaperIOPool;
+    // Make the wallpaper file names unique in the same millisecond
+    quint32 wallpaperSerial = 0;
     PersonalizationManagerInterfaceV1 *q;
 
 protected:
@@ -112,6 +121,7 @@ PersonalizationManagerInterfaceV1Private::PersonalizationManagerInterfaceV1Priva
     : QtWaylandServer::treeland_personalization_manager_v1()
     , q(_q)
 {
+    wallpaperIOPool.setMaxThreadCount(1);
 }
 
 wl_global *PersonalizationManagerInterfaceV1Private::global() const
@@ -1004,6 +1014,7 @@ PersonalizationManagerInterfaceV1::PersonalizationManagerInterfaceV1(QObject *pa
 
 PersonalizationManagerInterfaceV1::~PersonalizationManagerInterfaceV1()
 {
+    d->wallpaperIOPool.waitForDone();
     Q_CLEANUP_RESOURCE(default_background);
 }
 
@@ -1170,6 +1181,82 @@ void PersonalizationManagerInterfaceV1::onFontContextCreated(PersonalizationFont
     context->blockSignals(false);
 }
 
+// Runs in the wallpaper IO thread, the fd is read from the beginning without
+// changing its file offset, it can be shared by the background and lockscreen.
+// The file is written to a temporary path and renamed to dest when it's valid,
+// so dest is never seen truncated.
+static bool copyWallpaperFile(int fd, const QString &dest)
+{
+    const QString tmp = dest + QStringLiteral(".tmp");
+    const int destFd = ::open(QFile::encodeName(tmp).constData(),
+                              O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC,
+                              0644);
+    if (destFd < 0)
+        return false;
+
+    struct stat st;
+    const off_t size = fstat(fd, &st) == 0 && S_ISREG(st.st_mode) ? st.st_size : -1;
+    off_t offset = 0;
+    bool ok = size >= 0;
+
+    // Copy in the kernel if possible
+    while (ok && offset < size) {
+        const ssize_t n = sendfile(destFd, fd, &offset, size - offset);
+        if (n < 0 && errno == EINTR)
+            continue;
+        if (n <= 0)
+            ok = false;
+    }
+
+    if (!ok) {
+        // e.g. the fd is a pipe, fall back to copy in chunks
+        ok = true;
+        if (offset > 0 && (ftruncate(destFd, 0) != 0 || lseek(destFd, 0, SEEK_SET) != 0))
+            ok = false;
+
+        QByteArray buffer(256 * 1024, Qt::Uninitialized);
+        offset = 0;
+        while (ok) {
+            const ssize_t n = size >= 0 ? pread(fd, buffer.data(), buffer.size(), offset)
+                                        : read(fd, buffer.data(), buffer.size());
+            if (n < 0 && errno == EINTR)
+                continue;
+            if (n <= 0) {
+                ok = n == 0;
+                break;
+            }
+            offset += n;
+
+            for (ssize_t written = 0; written < n;) {
+                const ssize_t w = write(destFd, buffer.constData() + written, n - written);
+                if (w < 0 && errno == EINTR)
+                    continue;
+                if (w <= 0) {
+                    ok = false;
+                    break;
+                }
+                written += w;
+            }
+        }
+    }
+
+    ::close(destFd);
+
+    if (ok) {
+        // Decode the header, refuse the files that can't be shown as wallpaper
+        QImageReader reader(tmp);
+        ok = reader.canRead() && reader.size().isValid();
+    }
+
+    if (ok)
+        ok = ::rename(QFile::encodeName(tmp).constData(), QFile::encodeName(dest).constData()) == 0;
+
+    if (!ok)
+        QFile::remove(tmp);
+
+    return ok;
+}
+
 void PersonalizationManagerInterfaceV1::saveImage(PersonalizationWallpaperContextV1 *context,
                                    const QString &prefix)
 {
@@ -1191,47 +1278,61 @@ void PersonalizationManagerInterfaceV1::saveImage(PersonalizationWallpaperContex
     }
 
     QString dest = d->cacheDirectory + prefix + "_" + output + "_"
-        + QDateTime::currentDateTime().toString("yyyyMMddhhmmss");
+        + QDateTime::currentDateTime().toString("yyyyMMddhhmmsszzz") + "_"
+        + QString::number(++d->wallpaperSerial);
 
-    QFile src_file;
-    if (!src_file.open(context->fd(), QIODevice::ReadOnly))
+    // The context may be destroyed before the copy is finished
+    const int fd = fcntl(context->fd(), F_DUPFD_CLOEXEC, 0);
+    if (fd < 0)
         return;
 
-    QByteArray data = src_file.readAll();
-    src_file.close();
+    const QString outputName = context->outputName();
+    const bool isDark = context->isDark();
+    const QString metaData = context->metaData();
 
-    QFile dest_file(dest);
-    if (dest_file.open(QIODevice::WriteOnly)) {
-        dest_file.write(data);
-        dest_file.close();
-    }
+    d->wallpaperIOPool.start([this, fd, dest, prefix, output, outputName, isDark, metaData] {
+        const bool ok = copyWallpaperFile(fd, dest);
+        ::close(fd);
 
-    QSettings settings(d->settingFile, QSettings::IniFormat);
+        if (!ok) {
+            qCWarning(treelandWallpaper) << "Failed to save the wallpaper to" << dest;
+            return;
+        }
+
+        QMetaObject::invokeMethod(this, [=, this] {
+            QSettings settings(d->settingFile, QSettings::IniFormat);
 
-    int workspaceId = 1;
-    settings.beginGroup(QString("%1.%2.%3").arg(prefix).arg(output).arg(workspaceId));
+            int workspaceId = 1;
+            settings.beginGroup(QString("%1.%2.%3").arg(prefix).arg(output).arg(workspaceId));
 
-    const QString &old_path = settings.value("path").toString();
-    QFile::remove(old_path);
+            const QString &old_path = settings.value("path").toString();
+            if (old_path != dest)
+                QFile::remove(old_path);
 
-    settings.setValue("path", dest);
-    settings.setValue("isdark", context->isDark());
-    settings.endGroup();
+            settings.setValue("path", dest);
+            settings.setValue("isdark", isDark);
+            settings.endGroup();
 
-    settings.setValue("metadata", context->metaData());
-    d->iniMetaData = context->metaData();
+            settings.setValue("metadata", metaData);
+            d->iniMetaData = metaData;
+
+            if (prefix == QStringLiteral("background"))
+                Q_EMIT backgroundChanged(outputName, isDark);
+            else
+                Q_EMIT lockscreenChanged();
+        }, Qt::QueuedConnection);
+    });
 }
 
 void PersonalizationManagerInterfaceV1::onWallpaperCommit(PersonalizationWallpaperContextV1 *context)
 {
+    // The change signals are emitted after the image is saved
     if (context->options() & TREELAND_PERSONALIZATION_WALLPAPER_CONTEXT_V1_OPTIONS_BACKGROUND) {
         saveImage(context, "background");
-        Q_EMIT backgroundChanged(context->outputName(), context->isDark());
     }
 
     if (context->options() & TREELAND_PERSONALIZATION_WALLPAPER_CONTEXT_V1_OPTIONS_LOCKSCREEN) {
         saveImage(context, "lockscreen");
-        Q_EMIT lockscreenChanged();
     }
 }
 
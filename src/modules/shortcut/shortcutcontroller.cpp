@@ -27,6 +27,25 @@ static_assert(
 
 using BindError = QtWaylandServer::treeland_shortcut_manager_v2::bind_error;
 
+// The flags of the key events passed to dispatchKeyEvent
+static constexpr ShortcutController::KeyFlags EventFlags[] = {
+    ShortcutController::KeyPress,
+    ShortcutController::KeyPress | ShortcutController::Repeat,
+    ShortcutController::KeyRelease,
+    ShortcutController::KeyRelease | ShortcutController::Repeat,
+};
+
+static inline quint64 keySlotKey(int combined, ShortcutController::KeyFlags flags)
+{
+    // The flags are never 0, so is the key
+    return (quint64(quint32(combined)) << 8) | flags.toInt();
+}
+
+static inline quint32 keySlotIndex(quint64 key, quint32 mask)
+{
+    return quint32((key * 0x9E3779B97F4A7C15ull) >> 32) & mask;
+}
+
 ShortcutController::ShortcutController(QObject *parent)
     : QObject(parent)
 {
@@ -70,8 +89,14 @@ uint ShortcutController::registerKey(const QString &name, const QString& key, Sh
     }
     m_keyMap[combined][action] = std::make_pair(name, keybindFlags);
     m_deleters[name] = [this, combined, action]() {
-        m_keyMap[combined].remove(action);
+        auto it = m_keyMap.find(combined);
+        if (it == m_keyMap.end())
+            return;
+        it->remove(action);
+        if (it->isEmpty())
+            m_keyMap.erase(it);
     };
+    compileKeyTable();
     return 0;
 }
 
@@ -184,6 +209,7 @@ void ShortcutController::unregisterShortcut(const QString &name)
 {
     if (m_deleters.contains(name)) {
         m_deleters.take(name)();
+        compileKeyTable();
     }
 }
 
@@ -193,17 +219,62 @@ bool ShortcutController::dispatchKeyEvent(const QKeyEvent *kevent)
     ShortcutController::KeyFlags keyFlags = (kevent->isAutoRepeat() ? ShortcutController::Repeat : ShortcutController::None)
         | (kevent->type() == QEvent::KeyPress ? ShortcutController::KeyPress : ShortcutController::None)
         | (kevent->type() == QEvent::KeyRelease ? ShortcutController::KeyRelease : ShortcutController::None);
-    if (m_keyMap.contains(combined)) {
-        for (const auto &[action, keybind] : std::as_const(m_keyMap[combined]).asKeyValueRange()) {
-            const auto& [name, bindFlags] = keybind;
-            if ((bindFlags & keyFlags) != keyFlags) {
-                continue;
-            }
+    if (m_keySlots.isEmpty())
+        return false;
+
+    const quint64 key = keySlotKey(combined, keyFlags);
+    const quint32 mask = m_keySlots.size() - 1;
+    for (quint32 i = keySlotIndex(key, mask);; i = (i + 1) & mask) {
+        const KeySlot &slot = m_keySlots.at(i);
+        if (slot.key == 0)
+            return false;
+        if (slot.key != key)
+            continue;
+
+        // Shared rather than copied, in case a slot changes the bindings
+        const auto actions = m_keyActions;
+        const quint32 end = slot.first + slot.count;
+        for (quint32 j = slot.first; j < end; ++j) {
+            const auto &[action, name] = actions.at(j);
             emit actionTriggered(action, name, false, keyFlags);
         }
         return true;
     }
-    return false;
+}
+
+void ShortcutController::compileKeyTable()
+{
+    m_keySlots.clear();
+    m_keyActions.clear();
+    if (m_keyMap.isEmpty())
+        return;
+
+    // Every combination has a slot for every flags of the key events, so
+    // that the combination is consumed even if no binding accepts the flags.
+    const quint32 slotCount = m_keyMap.size() * std::size(EventFlags);
+    quint32 capacity = 16;
+    while (capacity < slotCount * 2)
+        capacity <<= 1;
+    m_keySlots.resize(capacity);
+
+    for (const auto &[combined, actions] : m_keyMap.asKeyValueRange()) {
+        for (const auto eventFlags : EventFlags) {
+            const quint64 key = keySlotKey(combined, eventFlags);
+            quint32 i = keySlotIndex(key, capacity - 1);
+            while (m_keySlots.at(i).key != 0)
+                i = (i + 1) & (capacity - 1);
+
+            KeySlot &slot = m_keySlots[i];
+            slot.key = key;
+            slot.first = m_keyActions.size();
+            for (const auto &[action, keybind] : actions.asKeyValueRange()) {
+                const auto &[name, bindFlags] = keybind;
+                if ((bindFlags & eventFlags) == eventFlags)
+                    m_keyActions.append(std::make_pair(action, name));
+            }
+            slot.count = m_keyActions.size() - slot.first;
+        }
+    }
 }
 
 void ShortcutController::clear()
@@ -212,6 +283,7 @@ void ShortcutController::clear()
         deleter();
     }
     m_deleters.clear();
+    compileKeyTable();
 }
 
 constexpr QKeyCombination ShortcutController::normalizeKeyCombination(QKeyCombination combination) {
@@ -43,8 +43,22 @@ Q_SIGNALS:
 
 private:
     static constexpr QKeyCombination normalizeKeyCombination(QKeyCombination combination);
+    void compileKeyTable();
 
     QMap<int, QMap<ShortcutAction, std::pair<QString, KeyFlags>>> m_keyMap;
+
+    // m_keyMap compiled into an open-addressed table keyed by the key combination
+    // and the flags of the key event, dispatchKeyEvent doesn't allocate.
+    struct KeySlot {
+        // 0 if the slot is empty
+        quint64 key = 0;
+        // the range in m_keyActions
+        quint32 first = 0;
+        quint32 count = 0;
+    };
+    QList<KeySlot> m_keySlots;
+    QList<std::pair<ShortcutAction, QString>> m_keyActions;
+
     QMap<std::pair<uint, SwipeGesture::Direction>, QMap<ShortcutAction, QString>> m_gesturemap;
     QMap<std::pair<uint, SwipeGesture::Direction>, QObject*> m_gestures;
     QMap<QString, std::function<void()>> m_deleters;
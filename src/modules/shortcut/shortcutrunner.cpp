@@ -111,7 +111,7 @@ void ShortcutRunner::onActionTrigger(ShortcutAction action, const QString &name,
         }
         break;
     case ShortcutAction::OpenMultiTaskView:
-        if (!helper->m_multitaskView ||
+        if (!helper->multitaskView() ||
             (helper->currentMode() != Helper::CurrentMode::Normal
              && helper->currentMode() != Helper::CurrentMode::Multitaskview)) {
             break;
@@ -120,7 +120,7 @@ void ShortcutRunner::onActionTrigger(ShortcutAction action, const QString &name,
         helper->m_multitaskView->toggleMultitaskView(IMultitaskView::ActiveReason::ShortcutKey);
         break;
     case ShortcutAction::CloseMultiTaskView:
-        if (!helper->m_multitaskView ||
+        if (!helper->multitaskView() ||
             (helper->currentMode() != Helper::CurrentMode::Normal
              && helper->currentMode() != Helper::CurrentMode::Multitaskview)) {
             break;
@@ -132,8 +132,8 @@ void ShortcutRunner::onActionTrigger(ShortcutAction action, const QString &name,
         if (helper->currentMode() == Helper::CurrentMode::Normal
             || helper->currentMode() == Helper::CurrentMode::Multitaskview) {
             helper->restoreFromShowDesktop();
-            if (helper->m_multitaskView) {
-                helper->m_multitaskView->toggleMultitaskView(IMultitaskView::ActiveReason::ShortcutKey);
+            if (auto multitaskView = helper->multitaskView()) {
+                multitaskView->toggleMultitaskView(IMultitaskView::ActiveReason::ShortcutKey);
             }
         }
         break;
@@ -142,15 +142,17 @@ void ShortcutRunner::onActionTrigger(ShortcutAction action, const QString &name,
         break;
     case ShortcutAction::Lockscreen:
 #ifndef DISABLE_DDM
-        if (helper->m_lockScreen && helper->m_lockScreen->available() && helper->currentMode() == Helper::CurrentMode::Normal) {
+        if (auto lockScreen = helper->lockScreen();
+            lockScreen && lockScreen->available() && helper->currentMode() == Helper::CurrentMode::Normal) {
             helper->showLockScreen();
         }
 #endif
         break;
     case ShortcutAction::ShutdownMenu:
-        if (helper->m_lockScreen && helper->m_lockScreen->available() && helper->currentMode() == Helper::CurrentMode::Normal) {
+        if (auto lockScreen = helper->lockScreen();
+            lockScreen && lockScreen->available() && helper->currentMode() == Helper::CurrentMode::Normal) {
             helper->setCurrentMode(Helper::CurrentMode::LockScreen);
-            helper->m_lockScreen->shutdown();
+            lockScreen->shutdown();
             helper->setWorkspaceVisible(false);
         }
         break;
@@ -188,15 +190,15 @@ void ShortcutRunner::onActionProgress(ShortcutAction action, qreal progress, con
     case ShortcutAction::OpenMultiTaskView:
     {
         auto helper = Helper::instance();
-        if (helper->m_multitaskView)
-            helper->m_multitaskView->updatePartialFactor(progress);
+        if (auto multitaskView = helper->multitaskView())
+            multitaskView->updatePartialFactor(progress);
         break;
     }
     case ShortcutAction::CloseMultiTaskView:
     {
         auto helper = Helper::instance();
-        if (helper->m_multitaskView)
-            helper->m_multitaskView->updatePartialFactor(-progress);
+        if (auto multitaskView = helper->multitaskView())
+            multitaskView->updatePartialFactor(-progress);
         break;
     }
     default:
@@ -214,20 +216,20 @@ void ShortcutRunner::onActionFinish(ShortcutAction action, const QString &name,
         break;
     case ShortcutAction::OpenMultiTaskView:
     {
-        auto helper = Helper::instance();
-        if (!helper->m_multitaskView)
+        auto multitaskView = Helper::instance()->multitaskView();
+        if (!multitaskView)
             break;
-        helper->m_multitaskView->setStatus(IMultitaskView::Active);
-        helper->m_multitaskView->toggleMultitaskView(IMultitaskView::ActiveReason::Gesture);
+        multitaskView->setStatus(IMultitaskView::Active);
+        multitaskView->toggleMultitaskView(IMultitaskView::ActiveReason::Gesture);
         break;
     }
     case ShortcutAction::CloseMultiTaskView:
     {
-        auto helper = Helper::instance();
-        if (!helper->m_multitaskView)
+        auto multitaskView = Helper::instance()->multitaskView();
+        if (!multitaskView)
             break;
-        helper->m_multitaskView->setStatus(IMultitaskView::Exited);
-        helper->m_multitaskView->toggleMultitaskView(IMultitaskView::ActiveReason::Gesture);
+        multitaskView->setStatus(IMultitaskView::Exited);
+        multitaskView->toggleMultitaskView(IMultitaskView::ActiveReason::Gesture);
         break;
     }
     default:
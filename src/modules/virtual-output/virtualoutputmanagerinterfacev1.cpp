@@ -215,11 +215,9 @@ void VirtualOutputInterfaceV1::sendError(uint32_t code, const QString &message)
 
 VirtualOutputInterfaceV1 *VirtualOutputInterfaceV1::get(wl_resource *resource)
 {
-    for (auto interface : s_virtualOutputs) {
-        if (interface->resource() == resource) {
-            return interface;
-        }
-    }
+    auto r = VirtualOutputInterfaceV1Private::Resource::fromResource(resource);
+    if (!r)
+        return nullptr;
 
-    return nullptr;
+    return static_cast<VirtualOutputInterfaceV1Private *>(r->object())->q;
 }
@@ -0,0 +1,308 @@
+// Copyright (C) 2026 UnionTech Software Technology Co., Ltd.
+// SPDX-License-Identifier: Apache-2.0 OR LGPL-3.0-only OR GPL-2.0-only OR GPL-3.0-only
+
+#include "frametimingmonitor.h"
+
+#include "common/treelandlogging.h"
+#include "core/rootsurfacecontainer.h"
+#include "output/output.h"
+
+#include <woutput.h>
+#include <woutputviewport.h>
+
+#include <QDBusConnection>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QStandardPaths>
+
+#include <ctime>
+
+using FrameTiming = WOutputRenderWindow::FrameTiming;
+
+static constexpr qint64 kNsecsPerSec = 1000000000;
+static constexpr qreal kNsecsPerMsec = 1000000.0;
+// The trace is stopped when it grows over the size
+static constexpr qint64 kMaxTraceSize = 64 * 1024 * 1024;
+
+FrameTimingMonitor::FrameTimingMonitor(RootSurfaceContainer *container,
+                                       WOutputRenderWindow *renderWindow,
+                                       QObject *parent)
+    : QObject(parent)
+    , m_container(container)
+    , m_renderWindow(renderWindow)
+{
+    m_traceTimer.setInterval(1000);
+    connect(&m_traceTimer, &QTimer::timeout, this, &FrameTimingMonitor::writeTrace);
+
+    QDBusConnection::sessionBus().registerObject("/org/deepin/Compositor1/FrameTiming",
+                                                 this,
+                                                 QDBusConnection::ExportScriptableSlots);
+
+    // The file can't be chosen on the session bus, any client could overwrite
+    // the files of the user with it
+    m_traceFileName = qEnvironmentVariable("TREELAND_FRAME_TRACE");
+    if (!m_traceFileName.isEmpty()) {
+        startTrace();
+    } else {
+        const QString runtimeDir =
+            QStandardPaths::writableLocation(QStandardPaths::RuntimeLocation);
+        if (!runtimeDir.isEmpty())
+            m_traceFileName = runtimeDir + "/treeland-frame-trace.json";
+    }
+}
+
+FrameTimingMonitor::~FrameTimingMonitor()
+{
+    stopTrace();
+}
+
+qint64 FrameTimingMonitor::now()
+{
+    timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return qint64(now.tv_sec) * kNsecsPerSec + now.tv_nsec;
+}
+
+FrameTimingMonitor::FrameStatistics
+FrameTimingMonitor::statistics(const QList<FrameTiming> &frames, qint64 since)
+{
+    FrameStatistics stats;
+    int frameCount = 0;
+    int renderCount = 0;
+    qint64 polishTime = 0;
+    qint64 syncTime = 0;
+    qint64 renderTime = 0;
+    qint64 mirrorTime = 0;
+    qint64 commitTime = 0;
+    qint64 presentLatency = 0;
+
+    for (const auto &frame : frames) {
+        if (frame.commitStart < since)
+            continue;
+
+        switch (frame.state) {
+        case FrameTiming::Presented:
+            ++stats.presentedFrames;
+            presentLatency += frame.presented - frame.commitEnd;
+            if (frame.refresh > 0)
+                stats.refreshRate = qRound(qreal(kNsecsPerSec) / frame.refresh);
+            break;
+        case FrameTiming::Discarded:
+        case FrameTiming::CommitFailed:
+            ++stats.droppedFrames;
+            break;
+        case FrameTiming::Pending:
+            break;
+        }
+
+        ++frameCount;
+        polishTime += frame.syncStart - frame.polishStart;
+        syncTime += (frame.renderStart ? frame.renderStart : frame.commitStart) - frame.syncStart;
+        if (frame.path == FrameTiming::MirrorShared || frame.path == FrameTiming::MirrorBlitted) {
+            ++stats.mirroredFrames;
+            mirrorTime += frame.renderEnd - frame.renderStart;
+        } else if (frame.renderStart) {
+            ++renderCount;
+            renderTime += frame.renderEnd - frame.renderStart;
+        }
+        commitTime += frame.commitEnd - frame.commitStart;
+    }
+
+    if (frameCount > 0) {
+        stats.polishTime = polishTime / kNsecsPerMsec / frameCount;
+        stats.syncTime = syncTime / kNsecsPerMsec / frameCount;
+        stats.commitTime = commitTime / kNsecsPerMsec / frameCount;
+    }
+    if (renderCount > 0)
+        stats.renderTime = renderTime / kNsecsPerMsec / renderCount;
+    if (stats.mirroredFrames > 0)
+        stats.mirrorTime = mirrorTime / kNsecsPerMsec / stats.mirroredFrames;
+    if (stats.presentedFrames > 0)
+        stats.presentLatency = presentLatency / kNsecsPerMsec / stats.presentedFrames;
+
+    return stats;
+}
+
+bool FrameTimingMonitor::startTrace()
+{
+    stopTrace();
+
+    if (m_traceFileName.isEmpty()) {
+        qCWarning(treelandOutput) << "No file for the frame trace";
+        return false;
+    }
+
+    m_traceFile.setFileName(m_traceFileName);
+    if (!m_traceFile.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        qCWarning(treelandOutput) << "Failed to open the frame trace file" << m_traceFileName
+                                  << m_traceFile.errorString();
+        return false;
+    }
+
+    qCInfo(treelandOutput) << "Write the frame trace to" << m_traceFileName;
+    m_traceFile.write("{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n");
+    m_firstTraceEvent = true;
+    m_tracedOutputs.clear();
+    m_traceTimer.start();
+    return true;
+}
+
+void FrameTimingMonitor::stopTrace()
+{
+    if (!m_traceFile.isOpen())
+        return;
+
+    writeTrace();
+    finishTrace();
+}
+
+void FrameTimingMonitor::finishTrace()
+{
+    if (!m_traceFile.isOpen())
+        return;
+
+    m_traceTimer.stop();
+    m_traceFile.write("\n]}\n");
+    m_traceFile.close();
+}
+
+QStringList FrameTimingMonitor::Outputs() const
+{
+    QStringList names;
+    for (auto output : m_container->outputs())
+        names.append(output->output()->name());
+    return names;
+}
+
+QVariantMap FrameTimingMonitor::Statistics(const QString &output) const
+{
+    auto viewport = this->viewport(output);
+    if (!viewport)
+        return {};
+
+    const auto stats = statistics(m_renderWindow->frameTimings(viewport), now() - kNsecsPerSec);
+    return {
+        { "presentedFrames", stats.presentedFrames },
+        { "droppedFrames", stats.droppedFrames },
+        { "refreshRate", stats.refreshRate },
+        { "polishTime", stats.polishTime },
+        { "syncTime", stats.syncTime },
+        { "renderTime", stats.renderTime },
+        { "mirroredFrames", stats.mirroredFrames },
+        { "mirrorTime", stats.mirrorTime },
+        { "commitTime", stats.commitTime },
+        { "presentLatency", stats.presentLatency },
+    };
+}
+
+QString FrameTimingMonitor::StartTrace()
+{
+    return startTrace() ? m_traceFileName : QString();
+}
+
+void FrameTimingMonitor::StopTrace()
+{
+    stopTrace();
+}
+
+WOutputViewport *FrameTimingMonitor::viewport(const QString &output) const
+{
+    for (auto o : m_container->outputs()) {
+        if (o->output()->name() == output)
+            return o->screenViewport();
+    }
+    return nullptr;
+}
+
+void FrameTimingMonitor::writeTrace()
+{
+    const auto writeEvent = [this](const QJsonObject &event) {
+        if (!m_firstTraceEvent)
+            m_traceFile.write(",\n");
+        m_firstTraceEvent = false;
+        m_traceFile.write(QJsonDocument(event).toJson(QJsonDocument::Compact));
+    };
+
+    // The frames waiting for the presentation feedback are written later
+    const qint64 pendingSince = now() - kNsecsPerSec;
+    for (auto output : m_container->outputs()) {
+        const QString name = output->output()->name();
+        auto it = m_tracedOutputs.find(name);
+        if (it == m_tracedOutputs.end()) {
+            it = m_tracedOutputs.insert(name, { int(m_tracedOutputs.size()) + 1, 0 });
+            writeEvent({
+                { "name", "thread_name" },
+                { "ph", "M" },
+                { "pid", 0 },
+                { "tid", it->tid },
+                { "args", QJsonObject{ { "name", name } } },
+            });
+        }
+
+        const int tid = it->tid;
+        const auto writeSlice = [&](const char *slice, qint64 start, qint64 end, const QJsonObject &args) {
+            if (start <= 0 || end < start)
+                return;
+            writeEvent({
+                { "name", slice },
+                { "cat", "frame" },
+                { "ph", "X" },
+                { "pid", 0 },
+                { "tid", tid },
+                { "ts", start / 1000.0 },
+                { "dur", (end - start) / 1000.0 },
+                { "args", args },
+            });
+        };
+
+        const auto frames = m_renderWindow->frameTimings(output->screenViewport());
+        for (const auto &frame : frames) {
+            if (frame.commitStart <= it->until)
+                continue;
+            if (frame.state == FrameTiming::Pending && frame.commitStart > pendingSince)
+                break;
+
+            it->until = frame.commitStart;
+            writeSlice("polish", frame.polishStart, frame.syncStart, {});
+            writeSlice("sync",
+                       frame.syncStart,
+                       frame.renderStart ? frame.renderStart : frame.commitStart,
+                       {});
+            const bool mirrored = frame.path == FrameTiming::MirrorShared
+                || frame.path == FrameTiming::MirrorBlitted;
+            writeSlice(mirrored ? "mirror" : "render", frame.renderStart, frame.renderEnd, {});
+            writeSlice("commit",
+                       frame.commitStart,
+                       frame.commitEnd,
+                       { { "commitSeq", qint64(frame.commitSeq) } });
+
+            if (frame.state == FrameTiming::Presented) {
+                writeSlice("present",
+                           frame.commitEnd,
+                           frame.presented,
+                           { { "refresh", frame.refresh },
+                             { "flags", qint64(frame.presentFlags) } });
+            } else {
+                const char *reason = frame.state == FrameTiming::Discarded ? "discarded"
+                    : frame.state == FrameTiming::CommitFailed             ? "commit failed"
+                                                                           : "no feedback";
+                writeEvent({
+                    { "name", reason },
+                    { "cat", "frame" },
+                    { "ph", "i" },
+                    { "s", "t" },
+                    { "pid", 0 },
+                    { "tid", tid },
+                    { "ts", frame.commitEnd / 1000.0 },
+                });
+            }
+        }
+    }
+
+    m_traceFile.flush();
+    if (m_traceFile.size() >= kMaxTraceSize) {
+        qCWarning(treelandOutput) << "Stop the frame trace, it is larger than"
+                                  << kMaxTraceSize << "bytes";
+        finishTrace();
+    }
+}
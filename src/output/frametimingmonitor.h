@@ -0,0 +1,91 @@
+// Copyright (C) 2026 UnionTech Software Technology Co., Ltd.
+// SPDX-License-Identifier: Apache-2.0 OR LGPL-3.0-only OR GPL-2.0-only OR GPL-3.0-only
+
+#pragma once
+
+#include <wglobal.h>
+#include <woutputrenderwindow.h>
+
+#include <QFile>
+#include <QHash>
+#include <QObject>
+#include <QTimer>
+#include <QVariantMap>
+
+class RootSurfaceContainer;
+
+WAYLIB_SERVER_USE_NAMESPACE
+
+// Exposes the frame timing of the outputs recorded by WOutputRenderWindow on
+// the session bus, and writes them to a Chrome trace file. The trace is
+// started at startup if TREELAND_FRAME_TRACE is set to the file name, else
+// StartTrace() writes it to treeland-frame-trace.json in XDG_RUNTIME_DIR.
+class FrameTimingMonitor : public QObject
+{
+    Q_OBJECT
+    Q_CLASSINFO("D-Bus Interface", "org.deepin.Compositor1.FrameTiming")
+
+public:
+    struct FrameStatistics
+    {
+        int presentedFrames = 0;
+        // discarded or failed to commit
+        int droppedFrames = 0;
+        // in Hz, from the presentation feedback
+        int refreshRate = 0;
+        // the average durations in milliseconds
+        qreal polishTime = 0;
+        qreal syncTime = 0;
+        // the frames rendered the scene
+        qreal renderTime = 0;
+        // the frames showing the buffer of the mirror source
+        int mirroredFrames = 0;
+        qreal mirrorTime = 0;
+        qreal commitTime = 0;
+        // from the end of the commit to the presentation
+        qreal presentLatency = 0;
+    };
+
+    explicit FrameTimingMonitor(RootSurfaceContainer *container,
+                                WOutputRenderWindow *renderWindow,
+                                QObject *parent = nullptr);
+    ~FrameTimingMonitor() override;
+
+    // CLOCK_MONOTONIC in nanoseconds, the clock of the frame timing
+    static qint64 now();
+    // The statistics of the frames committed since the time
+    static FrameStatistics statistics(const QList<WOutputRenderWindow::FrameTiming> &frames,
+                                 qint64 since);
+
+    bool startTrace();
+    void stopTrace();
+
+public Q_SLOTS:
+    Q_SCRIPTABLE QStringList Outputs() const;
+    // The statistics of the last second of the output
+    Q_SCRIPTABLE QVariantMap Statistics(const QString &output) const;
+    // Returns the file name of the trace, empty if failed
+    Q_SCRIPTABLE QString StartTrace();
+    Q_SCRIPTABLE void StopTrace();
+
+private:
+    WOutputViewport *viewport(const QString &output) const;
+    void writeTrace();
+    void finishTrace();
+
+    RootSurfaceContainer *m_container = nullptr;
+    WOutputRenderWindow *m_renderWindow = nullptr;
+
+    QString m_traceFileName;
+    QFile m_traceFile;
+    QTimer m_traceTimer;
+    bool m_firstTraceEvent = true;
+
+    struct TracedOutput
+    {
+        int tid = 0;
+        // the commit start of the last frame written to the trace
+        qint64 until = 0;
+    };
+    QHash<QString, TracedOutput> m_tracedOutputs;
+};
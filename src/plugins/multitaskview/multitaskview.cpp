@@ -13,8 +13,6 @@
 #include <woutputitem.h>
 #include <woutputrenderwindow.h>
 
-#include <QtConcurrentMap>
-
 WAYLIB_SERVER_USE_NAMESPACE
 
 Multitaskview::Multitaskview(QQuickItem *parent)
@@ -125,6 +123,16 @@ void MultitaskviewSurfaceModel::initializeModel()
                         .translated(-layoutArea().topLeft()),
                     false,
                     surface->isMinimized()));
+                connect(surface,
+                        &QQuickItem::widthChanged,
+                        this,
+                        &MultitaskviewSurfaceModel::handleWrapperSizeChanged,
+                        Qt::UniqueConnection);
+                connect(surface,
+                        &QQuickItem::heightChanged,
+                        this,
+                        &MultitaskviewSurfaceModel::handleWrapperSizeChanged,
+                        Qt::UniqueConnection);
             } else {
                 monitorUnreadySurface(surface);
             }
@@ -146,6 +154,12 @@ void MultitaskviewSurfaceModel::initializeModel()
                   return laterActiveThan(lhs->wrapper, rhs->wrapper);
               });
     doUpdateZOrder(m_data);
+    QList<QSizeF> sizes;
+    sizes.reserve(m_data.size());
+    for (const auto &modelData : std::as_const(m_data))
+        sizes.append(modelData->wrapper->size());
+    m_layout.setConfig(layoutConfig());
+    m_layout.reset(sizes);
     endResetModel();
     m_modelReady = true;
     Q_EMIT countChanged();
@@ -211,18 +225,9 @@ bool MultitaskviewSurfaceModel::modelReady() const
 
 void MultitaskviewSurfaceModel::calcLayout()
 {
-    doCalculateLayout(m_data);
-    auto [beginIndex, endIndex] = commitAndGetUpdateRange(m_data);
-    if (beginIndex <= endIndex) {
-        Q_EMIT dataChanged(index(beginIndex),
-                           index(endIndex),
-                           { GeometryRole,
-                             PaddingRole,
-                             UpIndexRole,
-                             DownIndexRole,
-                             LeftIndexRole,
-                             RightIndexRole });
-    }
+    m_layout.setConfig(layoutConfig());
+    m_layout.layout();
+    commitLayout();
     Q_EMIT rowsChanged();
     Q_EMIT contentHeightChanged();
 }
@@ -285,129 +290,31 @@ void MultitaskviewSurfaceModel::setLayoutArea(const QRectF &newLayoutArea)
     Q_EMIT layoutAreaChanged();
 }
 
-bool MultitaskviewSurfaceModel::tryLayout(const QList<ModelDataPtr> &rawData,
-                                          qreal rowH,
-                                          bool ignoreOverlap)
+MultitaskviewLayout::Config MultitaskviewSurfaceModel::layoutConfig() const
 {
-    int nrows = 1;
-    qreal acc = 0;
     auto devicePixelRatio = output()->outputItem()->devicePixelRatio();
     auto topContentMargin =
         Helper::instance()->config()->multitaskviewTopContentMargin() / devicePixelRatio;
     auto bottomContentMargin =
         Helper::instance()->config()->multitaskviewBottomContentMargin() / devicePixelRatio;
-    auto cellPadding = Helper::instance()->config()->multitaskviewCellPadding() / devicePixelRatio;
     auto horizontalMargin =
         Helper::instance()->config()->multitaskviewHorizontalMargin() / devicePixelRatio;
-    auto availWidth = std::max(0.0, layoutArea().width() - 2 * horizontalMargin);
-    auto availHeight =
-        std::max(0.0, layoutArea().height() - topContentMargin - bottomContentMargin);
-    if (availWidth <= 0)
-        return false;
-    QList<QList<ModelDataPtr>> rowstmp;
-    QList<ModelDataPtr> currow;
-    for (auto &modelData : rawData) {
-        auto surface = modelData->wrapper;
-        auto whRatio = surface->width() / surface->height();
-        modelData->pendingPadding = surface->height() < (rowH - 2 * cellPadding);
-        auto curW = std::min(availWidth,
-                             whRatio * std::min(rowH - 2 * cellPadding, surface->height())
-                                 + 2 * cellPadding);
-        modelData->pendingGeometry.setWidth(curW - 2 * cellPadding);
-        auto newAcc = acc + curW;
-        if (newAcc <= availWidth) {
-            acc = newAcc;
-            currow.append(modelData);
-        } else if (newAcc / availWidth > Helper::instance()->config()->multitaskviewLoadFactor()) {
-            acc = curW;
-            nrows++;
-            rowstmp.append(currow);
-            currow = { modelData };
-        } else {
-            // Just scale the last element
-            curW = availWidth - acc;
-            modelData->pendingGeometry.setWidth(curW - 2 * cellPadding);
-            currow.append(modelData);
-            acc = newAcc;
-        }
-    }
-    if (nrows * rowH <= availHeight || ignoreOverlap) {
-        if (currow.length()) {
-            rowstmp.append(currow);
-        }
-        m_rowHeight = rowH;
-        m_rows = rowstmp;
-        return true;
-    }
-    return false;
-}
 
-void MultitaskviewSurfaceModel::calcDisplayPos(const QList<ModelDataPtr> &rawData)
-{
-    auto devicePixelRatio = output()->outputItem()->devicePixelRatio();
-    auto topContentMargin =
-        Helper::instance()->config()->multitaskviewTopContentMargin() / devicePixelRatio;
-    auto bottomContentMargin =
-        Helper::instance()->config()->multitaskviewBottomContentMargin() / devicePixelRatio;
-    auto cellPadding = Helper::instance()->config()->multitaskviewCellPadding() / devicePixelRatio;
-    auto horizontalMargin =
-        Helper::instance()->config()->multitaskviewHorizontalMargin() / devicePixelRatio;
-    auto availWidth = std::max(0.0, layoutArea().width() - 2 * horizontalMargin);
-    auto availHeight =
+    MultitaskviewLayout::Config config;
+    config.availableWidth = std::max(0.0, layoutArea().width() - 2 * horizontalMargin);
+    config.availableHeight =
         std::max(0.0, layoutArea().height() - topContentMargin - bottomContentMargin);
-    auto contentHeight = m_rows.length() * m_rowHeight;
-    auto curY = std::max(availHeight - contentHeight, 0.0) / 2 + topContentMargin;
-    const auto hCenter = availWidth / 2;
-    for (auto i = 0; i < m_rows.size(); ++i) {
-        auto row = m_rows[i];
-        const auto totW = QtConcurrent::blockingMappedReduced(
-            row,
-            [cellPadding](ModelDataPtr data) {
-                return data->pendingGeometry.width() + 2 * cellPadding;
-            },
-            [](qreal &acc, const qreal &cur) {
-                acc += cur;
-            });
-        auto curX = hCenter - totW / 2 + cellPadding + horizontalMargin;
-        for (auto j = 0; j < row.size(); ++j) {
-            auto window = row[j];
-            window->pendingGeometry.moveLeft(curX);
-            window->pendingGeometry.moveTop(curY);
-            window->pendingGeometry.setHeight(m_rowHeight - 2 * cellPadding);
-            window->pendingLeftIndex = rawData.indexOf(row[(j - 1 + row.size()) % row.size()]);
-            window->pendingRightIndex = rawData.indexOf(row[(j + 1) % row.size()]);
-            auto lastRow = m_rows[std::max(0, i - 1)];
-            auto lastRowIndex = std::min(static_cast<int>(lastRow.size()) - 1, j);
-            window->pendingUpIndex = rawData.indexOf(lastRow[lastRowIndex]);
-            auto nextRow = m_rows[std::min(static_cast<int>(m_rows.size()) - 1, i + 1)];
-            auto nextRowIndex = std::min(static_cast<int>(nextRow.size()) - 1, j);
-            window->pendingDownIndex = rawData.indexOf(nextRow[nextRowIndex]);
-            curX += window->pendingGeometry.width() + 2 * cellPadding;
-        }
-        curY += m_rowHeight;
-    }
-    m_contentHeight = curY;
-}
-
-void MultitaskviewSurfaceModel::doCalculateLayout(const QList<ModelDataPtr> &rawData)
-{
-    auto devicePixelRatio = output()->outputItem()->devicePixelRatio();
-    auto maxWindowHeight =
+    config.topMargin = topContentMargin;
+    config.horizontalMargin = horizontalMargin;
+    config.cellPadding = Helper::instance()->config()->multitaskviewCellPadding() / devicePixelRatio;
+    config.maxRowHeight =
         std::min(layoutArea().height(),
                  static_cast<qreal>(Helper::instance()->config()->normalWindowHeight() / devicePixelRatio));
-    auto minWindowHeight = Helper::instance()->config()->minMultitaskviewSurfaceHeight() / devicePixelRatio;
-    auto windowHeightStep = Helper::instance()->config()->windowHeightStep() / devicePixelRatio;
-    auto rowH = maxWindowHeight;
-    while (rowH > minWindowHeight) {
-        if (tryLayout(rawData, rowH)) {
-            break;
-        }
-        rowH -= windowHeightStep;
-    }
-    if (rowH < minWindowHeight) {
-        tryLayout(rawData, minWindowHeight, true);
-    }
-    calcDisplayPos(rawData);
+    config.minRowHeight =
+        Helper::instance()->config()->minMultitaskviewSurfaceHeight() / devicePixelRatio;
+    config.rowHeightStep = Helper::instance()->config()->windowHeightStep() / devicePixelRatio;
+    config.loadFactor = Helper::instance()->config()->multitaskviewLoadFactor();
+    return config;
 }
 
 void MultitaskviewSurfaceModel::doUpdateZOrder(const QList<ModelDataPtr> &rawData)
@@ -427,29 +334,42 @@ void MultitaskviewSurfaceModel::doUpdateZOrder(const QList<ModelDataPtr> &rawDat
     });
 }
 
-std::pair<int, int> MultitaskviewSurfaceModel::commitAndGetUpdateRange(
-    [[maybe_unused]] const QList<ModelDataPtr> &rawData)
+void MultitaskviewSurfaceModel::commitLayout()
 {
-    // TODO: better algorithm
-    int beginIndex = 0, endIndex = -1;
-    bool unchanged = true;
+    Q_ASSERT(m_layout.count() == m_data.size());
+    // Emit the continuous windows with the same changed roles together
+    int beginIndex = 0;
+    QList<int> rangeRoles;
+    const auto emitRange = [this, &beginIndex, &rangeRoles](int endIndex) {
+        if (!rangeRoles.isEmpty() && beginIndex <= endIndex)
+            Q_EMIT dataChanged(index(beginIndex), index(endIndex), rangeRoles);
+    };
+
     for (int i = 0; i < m_data.size(); ++i) {
-        if (m_data[i]->padding != m_data[i]->pendingPadding
-            || m_data[i]->geometry != m_data[i]->pendingGeometry
-            || m_data[i]->upIndex != m_data[i]->pendingUpIndex
-            || m_data[i]->downIndex != m_data[i]->pendingDownIndex
-            || m_data[i]->leftIndex != m_data[i]->pendingLeftIndex
-            || m_data[i]->rightIndex != m_data[i]->pendingRightIndex) {
-            endIndex = i;
-            unchanged = false;
-        } else {
-            if (unchanged) {
-                beginIndex = i + 1;
-            }
+        auto &modelData = m_data[i];
+        const auto &cell = m_layout.cell(i);
+        QList<int> roles;
+        if (modelData->geometry != cell.geometry)
+            roles.append(GeometryRole);
+        if (modelData->padding != cell.padding)
+            roles.append(PaddingRole);
+        if (modelData->upIndex != cell.upIndex)
+            roles.append(UpIndexRole);
+        if (modelData->downIndex != cell.downIndex)
+            roles.append(DownIndexRole);
+        if (modelData->leftIndex != cell.leftIndex)
+            roles.append(LeftIndexRole);
+        if (modelData->rightIndex != cell.rightIndex)
+            roles.append(RightIndexRole);
+        modelData->setCell(cell);
+
+        if (roles != rangeRoles) {
+            emitRange(i - 1);
+            beginIndex = i;
+            rangeRoles = roles;
         }
-        m_data[i]->commit();
     }
-    return { beginIndex, endIndex };
+    emitRange(m_data.size() - 1);
 }
 
 void MultitaskviewSurfaceModel::handleWrapperGeometryChanged()
@@ -461,6 +381,33 @@ void MultitaskviewSurfaceModel::handleWrapperGeometryChanged()
     }
 }
 
+void MultitaskviewSurfaceModel::handleWrapperSizeChanged()
+{
+    // The width and the height are changed one by one, and many windows may be
+    // resized together, lay out once for all of them in the next event loop pass
+    if (m_relayoutPending)
+        return;
+    m_relayoutPending = true;
+    QMetaObject::invokeMethod(this,
+                              &MultitaskviewSurfaceModel::applyWrapperSizes,
+                              Qt::QueuedConnection);
+}
+
+void MultitaskviewSurfaceModel::applyWrapperSizes()
+{
+    m_relayoutPending = false;
+    m_layout.setConfig(layoutConfig());
+    for (int i = 0; i < m_data.size(); ++i) {
+        const QSizeF size = m_data[i]->wrapper->size();
+        // The unchanged sizes are skipped by the layout
+        if (!size.isEmpty())
+            m_layout.resize(i, size);
+    }
+    commitLayout();
+    Q_EMIT rowsChanged();
+    Q_EMIT contentHeightChanged();
+}
+
 void MultitaskviewSurfaceModel::handleWrapperOutputChanged()
 {
     auto wrapper = qobject_cast<SurfaceWrapper *>(sender());
@@ -549,20 +496,18 @@ void MultitaskviewSurfaceModel::handleSurfaceRemoved(SurfaceWrapper *surface)
                &SurfaceWrapper::surfaceStateChanged,
                this,
                &MultitaskviewSurfaceModel::handleSurfaceStateChanged);
+    disconnect(surface,
+               &QQuickItem::widthChanged,
+               this,
+               &MultitaskviewSurfaceModel::handleWrapperSizeChanged);
+    disconnect(surface,
+               &QQuickItem::heightChanged,
+               this,
+               &MultitaskviewSurfaceModel::handleWrapperSizeChanged);
+    m_layout.setConfig(layoutConfig());
+    m_layout.remove(toRemove);
     endRemoveRows();
-    doCalculateLayout(m_data);
-    auto [beginIndex, endIndex] = commitAndGetUpdateRange(m_data);
-    if (beginIndex <= endIndex) {
-        Q_ASSERT(beginIndex < m_data.size());
-        Q_EMIT dataChanged(index(beginIndex),
-                           index(endIndex),
-                           { GeometryRole,
-                             PaddingRole,
-                             UpIndexRole,
-                             DownIndexRole,
-                             LeftIndexRole,
-                             RightIndexRole });
-    }
+    commitLayout();
     Q_EMIT rowsChanged();
     Q_EMIT countChanged();
     Q_EMIT contentHeightChanged();
@@ -592,31 +537,28 @@ void MultitaskviewSurfaceModel::addReadySurface(SurfaceWrapper *surface)
                                                .translated(-layoutArea().topLeft()),
                                            false,
                                            surface->isMinimized());
-    QList<ModelDataPtr> pendingData{ m_data };
-    auto it = pendingData.begin();
-    for (; it != pendingData.end() && laterActiveThan((*it)->wrapper, surface); ++it)
+    connect(surface,
+            &QQuickItem::widthChanged,
+            this,
+            &MultitaskviewSurfaceModel::handleWrapperSizeChanged,
+            Qt::UniqueConnection);
+    connect(surface,
+            &QQuickItem::heightChanged,
+            this,
+            &MultitaskviewSurfaceModel::handleWrapperSizeChanged,
+            Qt::UniqueConnection);
+    auto it = m_data.begin();
+    for (; it != m_data.end() && laterActiveThan((*it)->wrapper, surface); ++it)
         ;
-    auto insertedIt = pendingData.insert(it, toBeInserted);
-    int insertedIndex = std::distance(pendingData.begin(), insertedIt);
-    Q_ASSERT(insertedIndex >= 0 && insertedIndex < pendingData.size());
-    doCalculateLayout(pendingData);
-    auto [beginIndex, endIndex] = commitAndGetUpdateRange(m_data);
-    if (beginIndex <= endIndex) {
-        Q_ASSERT(beginIndex < m_data.size());
-        Q_EMIT dataChanged(index(beginIndex),
-                           index(endIndex),
-                           { GeometryRole,
-                             PaddingRole,
-                             UpIndexRole,
-                             DownIndexRole,
-                             LeftIndexRole,
-                             RightIndexRole });
-    }
-    toBeInserted->commit();
+    int insertedIndex = std::distance(m_data.begin(), it);
     beginInsertRows({}, insertedIndex, insertedIndex);
-    m_data = pendingData;
-    pendingData.clear();
+    m_data.insert(insertedIndex, toBeInserted);
+    m_layout.setConfig(layoutConfig());
+    m_layout.insert(insertedIndex, surface->size());
+    toBeInserted->setCell(m_layout.cell(insertedIndex));
     endInsertRows();
+    // The other windows moved by the inserted one
+    commitLayout();
     Q_EMIT rowsChanged();
     Q_EMIT countChanged();
     Q_EMIT contentHeightChanged();
@@ -699,7 +641,7 @@ void MultitaskviewSurfaceModel::disconnectWorkspace(WorkspaceModel *workspace)
 
 uint MultitaskviewSurfaceModel::rows() const
 {
-    return m_rows.count();
+    return m_layout.rows();
 }
 
 WorkspaceModel *MultitaskviewSurfaceModel::workspace() const
@@ -722,7 +664,7 @@ void MultitaskviewSurfaceModel::setWorkspace(WorkspaceModel *newWorkspace)
 
 qreal MultitaskviewSurfaceModel::contentHeight() const
 {
-    return m_contentHeight;
+    return m_layout.contentHeight();
 }
 
 Output *MultitaskviewSurfaceModel::output() const
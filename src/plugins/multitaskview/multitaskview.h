@@ -3,6 +3,7 @@
 #pragma once
 
 #include "interfaces/multitaskviewinterface.h"
+#include "multitaskviewlayout.h"
 
 #include <QAbstractListModel>
 #include <QQuickItem>
@@ -94,23 +95,16 @@ class MultitaskviewSurfaceModel : public QAbstractListModel
         int downIndex{ 0 };
         int leftIndex{ 0 };
         int rightIndex{ 0 };
-
-        QRectF pendingGeometry{};
-        bool pendingPadding{ false };
         int zorder{ 0 };
-        int pendingUpIndex;
-        int pendingDownIndex;
-        int pendingLeftIndex;
-        int pendingRightIndex;
 
-        void commit()
+        void setCell(const MultitaskviewLayout::Cell &cell)
         {
-            geometry = pendingGeometry;
-            padding = pendingPadding;
-            upIndex = pendingUpIndex;
-            downIndex = pendingDownIndex;
-            leftIndex = pendingLeftIndex;
-            rightIndex = pendingRightIndex;
+            geometry = cell.geometry;
+            padding = cell.padding;
+            upIndex = cell.upIndex;
+            downIndex = cell.downIndex;
+            leftIndex = cell.leftIndex;
+            rightIndex = cell.rightIndex;
         }
     };
 
@@ -174,12 +168,12 @@ Q_SIGNALS:
     void countChanged();
 
 private:
-    bool tryLayout(const QList<ModelDataPtr> &rawData, qreal rowH, bool ignoreOverlap = false);
-    void calcDisplayPos(const QList<ModelDataPtr> &rawData);
-    void doCalculateLayout(const QList<ModelDataPtr> &rawData);
+    MultitaskviewLayout::Config layoutConfig() const;
+    void commitLayout();
     void doUpdateZOrder(const QList<ModelDataPtr> &rawData);
-    std::pair<int, int> commitAndGetUpdateRange(const QList<ModelDataPtr> &rawData);
     void handleWrapperGeometryChanged();
+    void handleWrapperSizeChanged();
+    void applyWrapperSizes();
     void handleWrapperOutputChanged();
     void handleSurfaceStateChanged();
     void handleSurfaceMappedChanged();
@@ -195,10 +189,9 @@ private:
 
     QList<ModelDataPtr> m_data{};
     QRectF m_layoutArea{};
-    QList<QList<ModelDataPtr>> m_rows{};
-    qreal m_rowHeight{ 0 };
-    qreal m_contentHeight{ 0 };
+    MultitaskviewLayout m_layout{};
     bool m_modelReady;
+    bool m_relayoutPending{ false };
     QList<ModelDataPtr> m_toBeInserted;
     WorkspaceModel *m_workspace = nullptr;
     Output *m_output = nullptr;
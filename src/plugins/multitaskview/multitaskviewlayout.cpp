@@ -0,0 +1,324 @@
+// Copyright (C) 2026 UnionTech Software Technology Co., Ltd.
+// SPDX-License-Identifier: Apache-2.0 OR LGPL-3.0-only OR GPL-2.0-only OR GPL-3.0-only
+
+#include "multitaskviewlayout.h"
+
+#include <algorithm>
+#include <cmath>
+
+const MultitaskviewLayout::Config &MultitaskviewLayout::config() const
+{
+    return m_config;
+}
+
+void MultitaskviewLayout::setConfig(const Config &config)
+{
+    if (m_config == config)
+        return;
+    m_config = config;
+    m_valid = false;
+}
+
+void MultitaskviewLayout::reset(const QList<QSizeF> &sizes)
+{
+    m_sizes = sizes;
+    m_widths.fill(0, sizes.size());
+    m_cells.fill(Cell{}, sizes.size());
+    m_rowStarts.clear();
+    m_valid = false;
+}
+
+void MultitaskviewLayout::layout()
+{
+    m_valid = false;
+    relayout(0, 0);
+}
+
+void MultitaskviewLayout::insert(int index, const QSizeF &size)
+{
+    Q_ASSERT(index >= 0 && index <= m_sizes.size());
+    m_sizes.insert(index, size);
+    m_widths.insert(index, 0);
+    m_cells.insert(index, Cell{});
+    shiftRows(index, 1);
+    relayout(index, index + 1, 1);
+}
+
+void MultitaskviewLayout::remove(int index)
+{
+    Q_ASSERT(index >= 0 && index < m_sizes.size());
+    m_sizes.remove(index);
+    m_widths.remove(index);
+    m_cells.remove(index);
+    shiftRows(index, -1);
+    relayout(index, index, -1);
+}
+
+void MultitaskviewLayout::resize(int index, const QSizeF &size)
+{
+    Q_ASSERT(index >= 0 && index < m_sizes.size());
+    if (m_sizes[index] == size)
+        return;
+    m_sizes[index] = size;
+    relayout(index, index + 1);
+}
+
+int MultitaskviewLayout::count() const
+{
+    return m_sizes.size();
+}
+
+int MultitaskviewLayout::rows() const
+{
+    return m_rowStarts.size();
+}
+
+qreal MultitaskviewLayout::rowHeight() const
+{
+    return m_rowHeight;
+}
+
+qreal MultitaskviewLayout::contentHeight() const
+{
+    return m_contentHeight;
+}
+
+const MultitaskviewLayout::Cell &MultitaskviewLayout::cell(int index) const
+{
+    return m_cells[index];
+}
+
+qreal MultitaskviewLayout::cellWidth(int index, qreal rowHeight, bool *padding) const
+{
+    const QSizeF &size = m_sizes[index];
+    const qreal cellPadding = m_config.cellPadding;
+    *padding = size.height() < (rowHeight - 2 * cellPadding);
+    const qreal whRatio = size.width() / size.height();
+    return std::min(m_config.availableWidth,
+                    whRatio * std::min(rowHeight - 2 * cellPadding, size.height())
+                        + 2 * cellPadding);
+}
+
+// Returns the index of the first window of the next row
+int MultitaskviewLayout::layoutRow(int start, qreal rowHeight, bool apply)
+{
+    const qreal availWidth = m_config.availableWidth;
+    qreal acc = 0;
+    int i = start;
+    for (; i < m_sizes.size(); ++i) {
+        bool padding;
+        qreal curW = cellWidth(i, rowHeight, &padding);
+        const qreal newAcc = acc + curW;
+        if (newAcc > availWidth) {
+            if (newAcc / availWidth > m_config.loadFactor)
+                break;
+            // Just scale the last element
+            curW = availWidth - acc;
+        }
+        acc = newAcc;
+        if (apply) {
+            m_widths[i] = curW;
+            m_cells[i].padding = padding;
+        }
+    }
+    return i;
+}
+
+QList<int> MultitaskviewLayout::layoutRows(qreal rowHeight, bool apply)
+{
+    QList<int> rowStarts;
+    for (int start = 0; start < m_sizes.size(); start = layoutRow(start, rowHeight, apply))
+        rowStarts.append(start);
+    return rowStarts;
+}
+
+// Lay out again from the row before the changed window, until a row at or
+// after stableFrom starts with the same window as before. Returns the first
+// row laid out again, and the first row kept from before in stableRow.
+int MultitaskviewLayout::updateRows(QList<int> &rowStarts,
+                                    qreal rowHeight,
+                                    int first,
+                                    int stableFrom,
+                                    bool apply,
+                                    int *stableRow)
+{
+    // The row before the changed window may take it or the next windows
+    const auto it = std::upper_bound(rowStarts.cbegin(), rowStarts.cend(), std::max(first - 1, 0));
+    const int row = std::max<int>(0, std::distance(rowStarts.cbegin(), it) - 1);
+
+    QList<int> newStarts(rowStarts.cbegin(), rowStarts.cbegin() + row);
+    int oldRow = row + 1;
+    int start = row > 0 ? rowStarts[row] : 0;
+    *stableRow = -1;
+    while (start < m_sizes.size()) {
+        newStarts.append(start);
+        start = layoutRow(start, rowHeight, apply);
+
+        // The rest rows are the same as before if starting with the same window
+        while (oldRow < rowStarts.size() && rowStarts[oldRow] < start)
+            ++oldRow;
+        if (start >= stableFrom && oldRow < rowStarts.size() && rowStarts[oldRow] == start) {
+            *stableRow = newStarts.size();
+            newStarts.append(rowStarts.mid(oldRow));
+            break;
+        }
+    }
+    if (*stableRow < 0)
+        *stableRow = newStarts.size();
+    rowStarts = newStarts;
+    return row;
+}
+
+// Keep the cached rows pointing to the same windows after inserting (delta 1)
+// or removing (delta -1) the window at index
+void MultitaskviewLayout::shiftRows(int index, int delta)
+{
+    const auto shift = [index, delta](QList<int> &rowStarts) {
+        if (delta < 0)
+            rowStarts.removeOne(index);
+        for (auto &start : rowStarts) {
+            if (start > index || (delta > 0 && start == index))
+                start += delta;
+        }
+    };
+    shift(m_rowStarts);
+    for (auto &rowStarts : m_candidateRows)
+        shift(rowStarts);
+}
+
+qreal MultitaskviewLayout::searchRowHeight(int first, int stableFrom)
+{
+    const Config &c = m_config;
+    // The candidates are from the max row height down by the step, the lower
+    // row height needs the less rows, find the highest one fits in the height
+    int candidates = 0;
+    if (c.maxRowHeight > c.minRowHeight) {
+        candidates = c.rowHeightStep > 0
+            ? static_cast<int>(std::ceil((c.maxRowHeight - c.minRowHeight) / c.rowHeightStep))
+            : 1;
+    }
+    const auto candidate = [&c](int i) {
+        return c.maxRowHeight - i * c.rowHeightStep;
+    };
+
+    // The rows of a candidate tried last time are updated from the changed
+    // window only, the ones not tried this time are dropped
+    QHash<int, QList<int>> candidateRows;
+    const auto countRows = [&](int i) {
+        QList<int> rowStarts;
+        const auto it = m_candidateRows.find(i);
+        if (it != m_candidateRows.end()) {
+            rowStarts = std::move(it.value());
+            int stableRow;
+            updateRows(rowStarts, candidate(i), first, stableFrom, false, &stableRow);
+        } else {
+            rowStarts = layoutRows(candidate(i), false);
+        }
+        const int rows = std::max<int>(rowStarts.size(), 1);
+        candidateRows.insert(i, std::move(rowStarts));
+        return rows;
+    };
+
+    int low = 0;
+    int high = candidates;
+    while (low < high) {
+        const int mid = (low + high) / 2;
+        const qreal rowH = candidate(mid);
+        if (countRows(mid) * rowH <= c.availableHeight)
+            high = mid;
+        else
+            low = mid + 1;
+    }
+    m_candidateRows = std::move(candidateRows);
+
+    // Overlap if no one fits
+    return low < candidates ? candidate(low) : c.minRowHeight;
+}
+
+void MultitaskviewLayout::relayout(int first, int stableFrom, int shift)
+{
+    if (m_config.availableWidth <= 0) {
+        m_rowStarts.clear();
+        m_candidateRows.clear();
+        m_valid = false;
+        return;
+    }
+
+    if (!m_valid)
+        m_candidateRows.clear();
+    const qreal rowHeight = searchRowHeight(first, stableFrom);
+    if (!m_valid || rowHeight != m_rowHeight) {
+        m_rowHeight = rowHeight;
+        m_rowStarts = layoutRows(rowHeight, true);
+        m_valid = true;
+        updateCells(0, m_rowStarts.size());
+        return;
+    }
+
+    int stableRow;
+    const int row = updateRows(m_rowStarts, rowHeight, first, stableFrom, true, &stableRow);
+    const int rows = m_rowStarts.size();
+    // The vertical center moves with the number of rows
+    if (rows != m_cellRows) {
+        updateCells(0, rows);
+        return;
+    }
+
+    // The rows around the changed ones point to them by the up and down index
+    const int lastRow = std::min(stableRow + 1, rows);
+    updateCells(std::max(row - 1, 0), lastRow);
+    if (shift != 0) {
+        const int begin = lastRow < rows ? m_rowStarts[lastRow] : static_cast<int>(m_cells.size());
+        for (int i = begin; i < m_cells.size(); ++i) {
+            Cell &cell = m_cells[i];
+            cell.upIndex += shift;
+            cell.downIndex += shift;
+            cell.leftIndex += shift;
+            cell.rightIndex += shift;
+        }
+    }
+}
+
+void MultitaskviewLayout::updateCells(int firstRow, int endRow)
+{
+    const Config &c = m_config;
+    const int rows = m_rowStarts.size();
+    const auto rowEnd = [this, rows](int row) {
+        return row + 1 < rows ? m_rowStarts[row + 1] : static_cast<int>(m_sizes.size());
+    };
+
+    const qreal contentHeight = rows * m_rowHeight;
+    const qreal top = std::max(c.availableHeight - contentHeight, 0.0) / 2 + c.topMargin;
+    const qreal hCenter = c.availableWidth / 2;
+    for (int row = firstRow; row < endRow; ++row) {
+        const int begin = m_rowStarts[row];
+        const int end = rowEnd(row);
+        qreal totW = 0;
+        for (int i = begin; i < end; ++i)
+            totW += m_widths[i];
+
+        const int lastRow = std::max(0, row - 1);
+        const int lastRowSize = rowEnd(lastRow) - m_rowStarts[lastRow];
+        const int nextRow = std::min(rows - 1, row + 1);
+        const int nextRowSize = rowEnd(nextRow) - m_rowStarts[nextRow];
+        const int size = end - begin;
+
+        const qreal curY = top + row * m_rowHeight;
+        qreal curX = hCenter - totW / 2 + c.cellPadding + c.horizontalMargin;
+        for (int i = begin; i < end; ++i) {
+            const int j = i - begin;
+            Cell &cell = m_cells[i];
+            cell.geometry = QRectF(curX,
+                                   curY,
+                                   m_widths[i] - 2 * c.cellPadding,
+                                   m_rowHeight - 2 * c.cellPadding);
+            cell.leftIndex = begin + (j - 1 + size) % size;
+            cell.rightIndex = begin + (j + 1) % size;
+            cell.upIndex = m_rowStarts[lastRow] + std::min(lastRowSize - 1, j);
+            cell.downIndex = m_rowStarts[nextRow] + std::min(nextRowSize - 1, j);
+            curX += m_widths[i];
+        }
+    }
+    m_contentHeight = top + contentHeight;
+    m_cellRows = rows;
+}
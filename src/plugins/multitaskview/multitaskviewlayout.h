@@ -0,0 +1,89 @@
+// Copyright (C) 2026 UnionTech Software Technology Co., Ltd.
+// SPDX-License-Identifier: Apache-2.0 OR LGPL-3.0-only OR GPL-2.0-only OR GPL-3.0-only
+#pragma once
+
+#include <QHash>
+#include <QList>
+#include <QRectF>
+#include <QSizeF>
+
+// Arrange the windows of the multitaskview in the rows of the same height.
+// The rows are cached, inserting, removing or resizing a window only lays out
+// again the rows from the changed one, until a row starts with the same window
+// as before.
+class MultitaskviewLayout
+{
+public:
+    struct Config
+    {
+        qreal availableWidth{ 0 };
+        qreal availableHeight{ 0 };
+        qreal topMargin{ 0 };
+        qreal horizontalMargin{ 0 };
+        qreal cellPadding{ 0 };
+        qreal maxRowHeight{ 0 };
+        qreal minRowHeight{ 0 };
+        qreal rowHeightStep{ 0 };
+        qreal loadFactor{ 1 };
+
+        bool operator==(const Config &other) const = default;
+    };
+
+    struct Cell
+    {
+        QRectF geometry{};
+        bool padding{ false };
+        int upIndex{ 0 };
+        int downIndex{ 0 };
+        int leftIndex{ 0 };
+        int rightIndex{ 0 };
+    };
+
+    const Config &config() const;
+    // The layout is invalidated if the config is changed
+    void setConfig(const Config &config);
+
+    // Replace all windows, the layout is calculated by the next layout()
+    void reset(const QList<QSizeF> &sizes);
+    void layout();
+
+    void insert(int index, const QSizeF &size);
+    void remove(int index);
+    void resize(int index, const QSizeF &size);
+
+    int count() const;
+    int rows() const;
+    qreal rowHeight() const;
+    qreal contentHeight() const;
+    const Cell &cell(int index) const;
+
+private:
+    qreal cellWidth(int index, qreal rowHeight, bool *padding) const;
+    int layoutRow(int start, qreal rowHeight, bool apply);
+    QList<int> layoutRows(qreal rowHeight, bool apply);
+    int updateRows(QList<int> &rowStarts,
+                   qreal rowHeight,
+                   int first,
+                   int stableFrom,
+                   bool apply,
+                   int *stableRow);
+    void shiftRows(int index, int delta);
+    qreal searchRowHeight(int first, int stableFrom);
+    void relayout(int first, int stableFrom, int shift = 0);
+    void updateCells(int firstRow, int endRow);
+
+    Config m_config{};
+    QList<QSizeF> m_sizes{};
+    // The width of the cells including the padding
+    QList<qreal> m_widths{};
+    QList<Cell> m_cells{};
+    // The index of the first window of every row
+    QList<int> m_rowStarts{};
+    // The number of rows the cells are laid out for
+    int m_cellRows{ 0 };
+    // The rows of the row heights tried by the last searchRowHeight()
+    QHash<int, QList<int>> m_candidateRows{};
+    qreal m_rowHeight{ 0 };
+    qreal m_contentHeight{ 0 };
+    bool m_valid{ false };
+};
@@ -261,6 +261,9 @@ Item {
                         id: surfaceProxy
                         surface: surfaceItemDelegate.wrapper
                         live: true
+                        // Only the hovered window is the live content
+                        thumbnail: surfaceItemDelegate.state === "taskview"
+                                   && !surfaceItemDelegate.hovered
                         fullProxy: true
                         radius: delegateCornerRadius
                         width: parent.width
@@ -40,6 +40,7 @@
 #include "modules/shortcut/shortcutmanager.h"
 #include "modules/shortcut/shortcutrunner.h"
 #include "modules/wallpaper-color/wallpapercolorinterfacev1.h"
+#include "output/frametimingmonitor.h"
 #include "output/outputconfigstate.h"
 #include "output/output.h"
 #include "output/outputlifecyclemanager.h"
@@ -121,7 +122,6 @@
 #include <QDBusConnection>
 #include <QDBusInterface>
 #include <QDBusObjectPath>
-#include <QKeySequence>
 #include <QLoggingCategory>
 #include <QMouseEvent>
 #include <QQmlContext>
@@ -204,6 +204,7 @@ Helper::Helper(QObject *parent)
     m_outputConfigState = new OutputConfigState(this);
     m_outputLifecycleManager =
         new OutputLifecycleManager(m_rootSurfaceContainer, m_outputConfigState, this);
+    m_frameTimingMonitor = new FrameTimingMonitor(m_rootSurfaceContainer, m_renderWindow, this);
 
 #ifdef EXT_SESSION_LOCK_V1
     m_lockScreenGraceTimer = new QTimer(this);
@@ -1248,6 +1249,7 @@ void Helper::init(Treeland::Treeland *treeland)
     engine->setContextForObject(m_renderWindow, engine->rootContext());
     engine->setContextForObject(m_renderWindow->contentItem(), engine->rootContext());
     m_rootSurfaceContainer->setQmlEngine(engine);
+    engine->setIncubationWindow(m_renderWindow);
     m_rootSurfaceContainer->init(m_server);
 
     m_backend = m_server->attach<WBackend>();
@@ -1261,8 +1263,8 @@ void Helper::init(Treeland::Treeland *treeland)
 
     m_ddeShellV1 = m_server->attach<DDEShellManagerInterfaceV1>();
     connect(m_ddeShellV1, &DDEShellManagerInterfaceV1::toggleMultitaskview, this, [this] {
-        if (m_multitaskView) {
-            m_multitaskView->toggleMultitaskView(IMultitaskView::ActiveReason::ShortcutKey);
+        if (auto multitaskView = this->multitaskView()) {
+            multitaskView->toggleMultitaskView(IMultitaskView::ActiveReason::ShortcutKey);
         }
     });
     connect(m_ddeShellV1,
@@ -1795,13 +1797,12 @@ bool Helper::beforeDisposeEvent(WSeat *seat, QWindow *targetWindow, QInputEvent
             auto kevent = static_cast<QKeyEvent *>(event);
 
 #ifndef QT_NO_DEBUG
-            if (QKeySequence(kevent->keyCombination()) ==
-                QKeySequence(Qt::MetaModifier | Qt::Key_F12)) {
+            if (kevent->keyCombination() == (Qt::MetaModifier | Qt::Key_F12)) {
                 std::terminate();
             }
             // The debug view shortcut should always handled first
-            if (QKeySequence(kevent->keyCombination())
-                == QKeySequence(Qt::ControlModifier | Qt::ShiftModifier | Qt::MetaModifier | Qt::Key_F11)) {
+            if (kevent->keyCombination()
+                == (Qt::ControlModifier | Qt::ShiftModifier | Qt::MetaModifier | Qt::Key_F11)) {
                 if (toggleDebugMenuBar())
                     return true;
             }
@@ -2199,23 +2200,26 @@ void Helper::handleRequestDrag([[maybe_unused]] WSurface *surface)
 void Helper::handleLockScreen(LockScreenInterface *lockScreen)
 {
     connect(lockScreen, &LockScreenInterface::shutdown, this, [this]() {
-        if (m_lockScreen && m_lockScreen->available() && currentMode() == Helper::CurrentMode::Normal) {
+        auto lockScreen = this->lockScreen();
+        if (lockScreen && lockScreen->available() && currentMode() == Helper::CurrentMode::Normal) {
             setCurrentMode(CurrentMode::LockScreen);
-            m_lockScreen->shutdown();
+            lockScreen->shutdown();
             setWorkspaceVisible(false);
         }
     });
     connect(lockScreen, &LockScreenInterface::lock, this, [this]() {
-        if (m_lockScreen && m_lockScreen->available() && currentMode() == Helper::CurrentMode::Normal) {
+        auto lockScreen = this->lockScreen();
+        if (lockScreen && lockScreen->available() && currentMode() == Helper::CurrentMode::Normal) {
             setCurrentMode(CurrentMode::LockScreen);
-            m_lockScreen->lock();
+            lockScreen->lock();
             setWorkspaceVisible(false);
         }
     });
     connect(lockScreen, &LockScreenInterface::switchUser, this, [this]() {
-        if (m_lockScreen && m_lockScreen->available() && currentMode() == Helper::CurrentMode::Normal) {
+        auto lockScreen = this->lockScreen();
+        if (lockScreen && lockScreen->available() && currentMode() == Helper::CurrentMode::Normal) {
             setCurrentMode(CurrentMode::LockScreen);
-            m_lockScreen->switchUser();
+            lockScreen->switchUser();
             setWorkspaceVisible(false);
         }
     });
@@ -2245,12 +2249,14 @@ void Helper::onSessionUnlock()
 void Helper::onExtSessionLock(WSessionLock *lock)
 {
 #ifdef EXT_SESSION_LOCK_V1
-    if (m_lockScreen->isLocked()) {
+    auto lockScreen = this->lockScreen();
+    // Can't show the lock surfaces without the lockscreen plugin
+    if (!lockScreen || lockScreen->isLocked()) {
         lock->finish();
         return;
     }
 
-    m_lockScreen->onExternalLock(lock);
+    lockScreen->onExternalLock(lock);
 
     setCurrentMode(CurrentMode::LockScreen);
 
@@ -2473,6 +2479,34 @@ void Helper::setMultitaskViewImpl(IMultitaskView *impl)
     m_multitaskView = impl;
 }
 
+void Helper::setMultitaskViewLoader(std::function<void()> loader)
+{
+    m_multitaskViewLoader = std::move(loader);
+}
+
+// Load the multitaskview plugin at the first use if it's not loaded in background yet
+IMultitaskView *Helper::multitaskView()
+{
+    if (!m_multitaskView && m_multitaskViewLoader)
+        std::exchange(m_multitaskViewLoader, nullptr)();
+
+    return m_multitaskView;
+}
+
+void Helper::setLockScreenLoader(std::function<void()> loader)
+{
+    m_lockScreenLoader = std::move(loader);
+}
+
+// Load the lockscreen plugin at the first use if it's not loaded in background yet
+LockScreen *Helper::lockScreen()
+{
+    if (!m_lockScreen && m_lockScreenLoader)
+        std::exchange(m_lockScreenLoader, nullptr)();
+
+    return m_lockScreen;
+}
+
 void Helper::setLockScreenImpl(ILockScreen *impl)
 {
 #if !defined(DISABLE_DDM) || defined(EXT_SESSION_LOCK_V1)
@@ -2533,7 +2567,8 @@ void Helper::setCurrentMode(CurrentMode mode)
 
 void Helper::showLockScreen(bool switchToGreeter)
 {
-    if (m_lockScreen->isLocked()) {
+    auto lockScreen = this->lockScreen();
+    if (!lockScreen || lockScreen->isLocked()) {
         return;
     }
 
@@ -2546,7 +2581,7 @@ void Helper::showLockScreen(bool switchToGreeter)
     setWorkspaceVisible(false);
 
     setCurrentMode(CurrentMode::LockScreen);
-    m_lockScreen->lock();
+    lockScreen->lock();
 
     // send DDM switch to greeter mode
     if (switchToGreeter) {
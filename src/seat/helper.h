@@ -24,6 +24,7 @@
 #include <QList>
 #include <QMap>
 
+#include <functional>
 #include <optional>
 
 class QJsonObject;
@@ -109,6 +110,7 @@ class Multitaskview;
 class Output;
 class OutputConfigState;
 class OutputLifecycleManager;
+class FrameTimingMonitor;
 class OutputManagerV1;
 class PersonalizationManagerInterfaceV1;
 class RootSurfaceContainer;
@@ -217,7 +219,11 @@ public:
     void handleWindowPicker(WindowPickerInterface *picker);
 
     void setMultitaskViewImpl(IMultitaskView *impl);
+    void setMultitaskViewLoader(std::function<void()> loader);
+    IMultitaskView *multitaskView();
     void setLockScreenImpl(ILockScreen *impl);
+    void setLockScreenLoader(std::function<void()> loader);
+    LockScreen *lockScreen();
 
     CurrentMode currentMode() const
     {
@@ -407,6 +413,7 @@ private:
     QList<Output *> m_outputList;
     OutputConfigState *m_outputConfigState = nullptr;
     OutputLifecycleManager *m_outputLifecycleManager = nullptr;
+    FrameTimingMonitor *m_frameTimingMonitor = nullptr;
     QPointer<QQuickItem> m_taskSwitch;
     QList<qw_idle_inhibitor_v1 *> m_idleInhibitors;
 
@@ -422,6 +429,8 @@ private:
     QPropertyAnimation *m_workspaceOpacityAnimation{ nullptr };
 
     IMultitaskView *m_multitaskView{ nullptr };
+    std::function<void()> m_multitaskViewLoader;
+    std::function<void()> m_lockScreenLoader;
     UserModel *m_userModel{ nullptr };
     SessionModel *m_sessionModel{ nullptr };
     GreeterProxy *m_greeterProxy{ nullptr };
@@ -3,18 +3,59 @@
 
 #include "surfaceproxy.h"
 
+#include "common/treelandlogging.h"
 #include "core/qmlengine.h"
 #include "surface/surfacewrapper.h"
 
+#include <wsurface.h>
+
 #include <private/qquickitem_p.h>
+#include <private/qquickshadereffectsource_p.h>
+
+#include <QElapsedTimer>
+#include <QQmlEngine>
+#include <QQuickWindow>
+#include <QTimer>
+
+#include <memory>
+
+extern "C" {
+#include <wlr/types/wlr_compositor.h>
+}
+
+// The minimum interval to refresh the thumbnail for the commits of the source
+static constexpr int ThumbnailRefreshInterval = 250;
+// The texture memory of all thumbnails, including the mipmap levels
+static qint64 thumbnailTextureBytes = 0;
+
+static qint64 textureBytes(const QSize &size)
+{
+    // RGBA8, the mipmap levels add a third
+    return qint64(size.width()) * size.height() * 4 * 4 / 3;
+}
+
+static void releaseShadow(QQuickItem *shadow)
+{
+    if (auto engine = qobject_cast<QmlEngine *>(qmlEngine(shadow)))
+        engine->releaseXdgShadow(shadow);
+    else
+        shadow->deleteLater();
+}
 
 SurfaceProxy::SurfaceProxy(QQuickItem *parent)
     : QQuickItem(parent)
+    , m_thumbnailTimer(new QTimer(this))
 {
+    m_thumbnailTimer->setSingleShot(true);
+    m_thumbnailTimer->setInterval(ThumbnailRefreshInterval);
+    connect(m_thumbnailTimer, &QTimer::timeout, this, &SurfaceProxy::refreshThumbnail);
 }
 
 SurfaceProxy::~SurfaceProxy()
 {
+    if (m_thumbnail)
+        thumbnailTextureBytes -= textureBytes(m_thumbnail->textureSize());
+
     if (m_proxySurface) {
         m_proxySurface->markWrapperToRemoved();
         m_proxySurface = nullptr;
@@ -128,16 +169,39 @@ void SurfaceProxy::setSurface(SurfaceWrapper *newSurface)
                                        this,
                                        &SurfaceProxy::updateImplicitSize);
 
+        for (auto signal : { &QQuickItem::xChanged,
+                             &QQuickItem::yChanged,
+                             &QQuickItem::scaleChanged }) {
+            m_sourceConnections << connect(m_proxySurface,
+                                           signal,
+                                           this,
+                                           &SurfaceProxy::updateThumbnailGeometry);
+        }
+        m_sourceConnections << connect(m_proxySurface,
+                                       &SurfaceWrapper::boundingRectChanged,
+                                       this,
+                                       &SurfaceProxy::updateThumbnailGeometry);
+        // The decoration is adopted asynchronously, and the title bar maybe
+        // changed without changing the bounding rect
+        for (auto signal : { &SurfaceWrapper::noDecorationChanged,
+                             &SurfaceWrapper::noTitleBarChanged }) {
+            m_sourceConnections << connect(m_proxySurface,
+                                           signal,
+                                           this,
+                                           &SurfaceProxy::refreshThumbnail);
+        }
+
         updateImplicitSize();
         updateProxySurfaceScale();
         updateShape();
     } else {
         if (m_shadow) {
-            m_shadow->deleteLater();
+            releaseShadow(m_shadow);
             m_shadow = nullptr;
         }
     }
 
+    updateThumbnail();
     Q_EMIT surfaceChanged();
 }
 
@@ -152,6 +216,158 @@ void SurfaceProxy::geometryChange(const QRectF &newGeo, const QRectF &oldGeo)
     }
 }
 
+// Render the proxy surface into a small texture, it's refreshed in the commits of the
+// source surface at most once in ThumbnailRefreshInterval, not sample the full size
+// client buffer in every frame.
+void SurfaceProxy::updateThumbnail()
+{
+    if (!m_thumbnailEnabled || !m_proxySurface) {
+        if (m_thumbnail) {
+            m_thumbnailTimer->stop();
+            thumbnailTextureBytes -= textureBytes(m_thumbnail->textureSize());
+            delete m_thumbnail;
+            m_thumbnail = nullptr;
+            updateCommitConnections();
+        }
+        return;
+    }
+
+    if (!m_thumbnail) {
+        m_thumbnail = new QQuickShaderEffectSource(this);
+        m_thumbnail->setLive(false);
+        m_thumbnail->setHideSource(true);
+        m_thumbnail->setMipmap(true);
+        m_thumbnail->setSmooth(true);
+    }
+
+    m_thumbnail->setSourceItem(m_proxySurface);
+    m_thumbnail->stackAfter(m_proxySurface);
+    updateCommitConnections();
+    updateThumbnailGeometry();
+    refreshThumbnail();
+}
+
+void SurfaceProxy::refreshThumbnail()
+{
+    if (!m_thumbnail)
+        return;
+
+    m_thumbnail->scheduleUpdate();
+
+    if (!treelandSurface().isDebugEnabled() || !window())
+        return;
+
+    // The frame rendering the thumbnail, it's the cost of a refresh
+    auto timer = std::make_shared<QElapsedTimer>();
+    connect(
+        window(),
+        &QQuickWindow::beforeRendering,
+        this,
+        [timer] {
+            timer->start();
+        },
+        Qt::SingleShotConnection);
+    connect(
+        window(),
+        &QQuickWindow::afterRendering,
+        this,
+        [this, timer] {
+            qCDebug(treelandSurface) << "The frame refreshing the thumbnail of" << m_sourceSurface
+                                     << "is rendered in" << timer->nsecsElapsed() / 1000 << "us";
+        },
+        Qt::SingleShotConnection);
+}
+
+// The thumbnail shows the subsurfaces and popups too, refresh it for the commits
+// of all surfaces in the tree, and follow the changes of the tree.
+void SurfaceProxy::updateCommitConnections()
+{
+    for (const QMetaObject::Connection &connection : std::as_const(m_commitConnections))
+        QObject::disconnect(connection);
+    m_commitConnections.clear();
+
+    if (!m_thumbnail || !m_sourceSurface)
+        return;
+
+    connectSurfaceTree(m_sourceSurface);
+}
+
+void SurfaceProxy::connectSurfaceTree(SurfaceWrapper *wrapper)
+{
+    // e.g. the prelaunch splash gets its surface later
+    m_commitConnections << connect(wrapper,
+                                   &SurfaceWrapper::surfaceItemCreated,
+                                   this,
+                                   &SurfaceProxy::updateCommitConnections);
+    m_commitConnections << connect(wrapper,
+                                   &SurfaceWrapper::subSurfacesChanged,
+                                   this,
+                                   &SurfaceProxy::updateCommitConnections);
+
+    if (auto surface = wrapper->surface())
+        connectSurface(surface);
+
+    for (auto subSurface : wrapper->subSurfaces())
+        connectSurfaceTree(subSurface);
+}
+
+void SurfaceProxy::connectSurface(WSurface *surface)
+{
+    m_commitConnections << connect(surface, &WSurface::commit, this, &SurfaceProxy::onSourceCommitted);
+    m_commitConnections << connect(surface, &WSurface::newSubsurface, this, [this](WSurface *sub) {
+        connectSurface(sub);
+        onSourceCommitted(WLR_SURFACE_STATE_BUFFER);
+    });
+
+    for (auto subsurface : surface->subsurfaces())
+        connectSurface(subsurface);
+}
+
+void SurfaceProxy::updateThumbnailGeometry()
+{
+    if (!m_thumbnail || !m_proxySurface)
+        return;
+
+    const QRectF sourceRect = m_proxySurface->boundingRect();
+    const qreal scale = m_proxySurface->scale();
+    // Not live, the texture of the old source rect would be stretched
+    const bool sourceRectChanged = m_thumbnail->sourceRect() != sourceRect;
+    m_thumbnail->setSourceRect(sourceRect);
+    m_thumbnail->setPosition(m_proxySurface->position() + sourceRect.topLeft() * scale);
+    m_thumbnail->setSize(sourceRect.size() * scale);
+
+    // Render in twice of the displayed size, the sampling of its mipmap is close to
+    // the box filter, but never larger than the source. Align to 64 pixels to not
+    // reallocate the texture in every frame of the resizing animations.
+    const qreal dpr = window() ? window()->effectiveDevicePixelRatio() : 1.0;
+    QSize textureSize = (m_thumbnail->size() * dpr * 2).toSize();
+    textureSize = QSize((textureSize.width() + 63) & ~63, (textureSize.height() + 63) & ~63)
+                      .boundedTo((sourceRect.size() * dpr).toSize())
+                      .expandedTo(QSize(1, 1));
+    if (m_thumbnail->textureSize() != textureSize) {
+        thumbnailTextureBytes += textureBytes(textureSize) - textureBytes(m_thumbnail->textureSize());
+        qCDebug(treelandSurface) << "Thumbnail texture of" << m_sourceSurface << "is resized to"
+                                 << textureSize << "from the source" << sourceRect.size()
+                                 << ", the thumbnails use" << thumbnailTextureBytes / 1024 << "KiB"
+                                 << "instead of sampling" << textureBytes(sourceRect.size().toSize()) / 1024
+                                 << "KiB of the source";
+        m_thumbnail->setTextureSize(textureSize);
+    } else if (!sourceRectChanged) {
+        return;
+    }
+
+    refreshThumbnail();
+}
+
+void SurfaceProxy::onSourceCommitted(quint32 committedState)
+{
+    if (!m_thumbnail || !(committedState & WLR_SURFACE_STATE_BUFFER))
+        return;
+
+    if (!m_thumbnailTimer->isActive())
+        m_thumbnailTimer->start();
+}
+
 void SurfaceProxy::updateProxySurfaceScale()
 {
     if (size().isEmpty())
@@ -293,7 +509,7 @@ void SurfaceProxy::setFullProxy(bool newFullProxy)
     if (m_proxySurface) {
         if (m_fullProxy) {
             if (m_shadow) {
-                m_shadow->deleteLater();
+                releaseShadow(m_shadow);
                 m_shadow = nullptr;
             }
         } else if (!m_shadow) {
@@ -307,3 +523,18 @@ void SurfaceProxy::setFullProxy(bool newFullProxy)
 
     Q_EMIT fullProxyChanged();
 }
+
+bool SurfaceProxy::thumbnail() const
+{
+    return m_thumbnailEnabled;
+}
+
+void SurfaceProxy::setThumbnail(bool newThumbnail)
+{
+    if (m_thumbnailEnabled == newThumbnail)
+        return;
+    m_thumbnailEnabled = newThumbnail;
+    updateThumbnail();
+
+    Q_EMIT thumbnailChanged();
+}
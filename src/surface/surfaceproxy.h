@@ -3,8 +3,19 @@
 
 #pragma once
 
+#include <wglobal.h>
+
 #include <QQuickItem>
 
+QT_BEGIN_NAMESPACE
+class QQuickShaderEffectSource;
+class QTimer;
+QT_END_NAMESPACE
+
+WAYLIB_SERVER_BEGIN_NAMESPACE
+class WSurface;
+WAYLIB_SERVER_END_NAMESPACE
+
 class SurfaceWrapper;
 
 class SurfaceProxy : public QQuickItem
@@ -15,6 +26,7 @@ class SurfaceProxy : public QQuickItem
     Q_PROPERTY(bool live READ live WRITE setLive NOTIFY liveChanged FINAL)
     Q_PROPERTY(QSizeF maxSize READ maxSize WRITE setMaxSize NOTIFY maxSizeChanged FINAL)
     Q_PROPERTY(bool fullProxy READ fullProxy WRITE setFullProxy NOTIFY fullProxyChanged FINAL)
+    Q_PROPERTY(bool thumbnail READ thumbnail WRITE setThumbnail NOTIFY thumbnailChanged FINAL)
     QML_ELEMENT
 
 public:
@@ -37,12 +49,16 @@ public:
     bool fullProxy() const;
     void setFullProxy(bool newFullProxy);
 
+    bool thumbnail() const;
+    void setThumbnail(bool newThumbnail);
+
 Q_SIGNALS:
     void surfaceChanged();
     void radiusChanged();
     void liveChanged();
     void maxSizeChanged();
     void fullProxyChanged();
+    void thumbnailChanged();
 
 private:
     void geometryChange(const QRectF &newGeo, const QRectF &oldGeo) override;
@@ -53,13 +69,25 @@ private:
     void updateNoCornerRadius();
     void updateImplicitSize();
     void onSourceRadiusChanged();
+    void updateThumbnail();
+    void updateThumbnailGeometry();
+    void refreshThumbnail();
+    void updateCommitConnections();
+    void connectSurfaceTree(SurfaceWrapper *wrapper);
+    void connectSurface(WAYLIB_SERVER_NAMESPACE::WSurface *surface);
+    void onSourceCommitted(quint32 committedState);
 
     SurfaceWrapper *m_sourceSurface = nullptr;
     SurfaceWrapper *m_proxySurface = nullptr;
     QList<QMetaObject::Connection> m_sourceConnections;
+    // the commits of the surface tree for the thumbnail
+    QList<QMetaObject::Connection> m_commitConnections;
     QQuickItem *m_shadow = nullptr;
+    QQuickShaderEffectSource *m_thumbnail = nullptr;
+    QTimer *m_thumbnailTimer = nullptr;
     qreal m_radius = -1;
     bool m_live = true;
     bool m_fullProxy = false;
+    bool m_thumbnailEnabled = false;
     QSizeF m_maxSize;
 };
@@ -27,8 +27,11 @@
 #include <qwlayershellv1.h>
 
 #include <QColor>
+#include <QElapsedTimer>
 #include <QVariant>
 
+#include <memory>
+
 #define OPEN_ANIMATION 1
 #define CLOSE_ANIMATION 2
 #define ALWAYSONTOPLAYER 1
@@ -197,7 +200,8 @@ SurfaceWrapper::~SurfaceWrapper()
         m_titleBar = nullptr;
     }
     if (m_decoration) {
-        delete m_decoration;
+        m_decoration->disconnect(this);
+        m_engine->releaseDecoration(m_decoration);
         m_decoration = nullptr;
     }
     if (m_geometryAnimation) {
@@ -1074,28 +1078,54 @@ void SurfaceWrapper::updateDecoration()
         updateTitleBar();
 
     if (m_noDecoration) {
-        Q_ASSERT(m_decoration);
-        m_decoration->disconnect(this);
-        m_decoration->deleteLater();
-        m_decoration = nullptr;
-    } else {
+        // Maybe still incubating, will be released in adoptDecoration
+        if (m_decoration) {
+            m_decoration->disconnect(this);
+            m_engine->releaseDecoration(m_decoration);
+            m_decoration = nullptr;
+        }
+    } else if (!m_decorationPending) {
         Q_ASSERT(!m_decoration);
         Q_ASSERT(m_surfaceItem || m_prelaunchSplash);
-        m_decoration = m_engine->createDecoration(this, this);
-        m_decoration->stackBefore(m_surfaceItem ? m_surfaceItem : m_prelaunchSplash);
-        connect(m_decoration, &QQuickItem::xChanged, this, &SurfaceWrapper::updateBoundingRect);
-        connect(m_decoration, &QQuickItem::yChanged, this, &SurfaceWrapper::updateBoundingRect);
-        connect(m_decoration, &QQuickItem::widthChanged, this, &SurfaceWrapper::updateBoundingRect);
-        connect(m_decoration,
-                &QQuickItem::heightChanged,
-                this,
-                &SurfaceWrapper::updateBoundingRect);
+        if (m_prelaunchSplash) {
+            // The splash transition hides and shows the decoration, it must exist now
+            adoptDecoration(m_engine->createDecoration(this, this));
+        } else {
+            m_decorationPending = true;
+            QElapsedTimer timer;
+            timer.start();
+            m_engine->createDecorationAsync(this, this, [this, timer](QQuickItem *decoration) {
+                qCDebug(treelandSurface) << "Decoration of" << this << "is ready after"
+                                         << timer.elapsed() << "ms";
+                adoptDecoration(decoration);
+            });
+        }
     }
 
     updateBoundingRect();
     Q_EMIT noDecorationChanged();
 }
 
+void SurfaceWrapper::adoptDecoration(QQuickItem *decoration)
+{
+    m_decorationPending = false;
+    if (m_noDecoration || m_decoration || m_wrapperAboutToRemove
+        || (!m_surfaceItem && !m_prelaunchSplash)) {
+        m_engine->releaseDecoration(decoration);
+        return;
+    }
+
+    m_decoration = decoration;
+    m_decoration->stackBefore(m_surfaceItem ? m_surfaceItem : m_prelaunchSplash);
+    connect(m_decoration, &QQuickItem::xChanged, this, &SurfaceWrapper::updateBoundingRect);
+    connect(m_decoration, &QQuickItem::yChanged, this, &SurfaceWrapper::updateBoundingRect);
+    connect(m_decoration, &QQuickItem::widthChanged, this, &SurfaceWrapper::updateBoundingRect);
+    connect(m_decoration, &QQuickItem::heightChanged, this, &SurfaceWrapper::updateBoundingRect);
+    updateBoundingRect();
+    // The decoration property is changed, it maybe adopted later than updateDecoration
+    Q_EMIT noDecorationChanged();
+}
+
 void SurfaceWrapper::updateTitleBar()
 {
     if (m_wrapperAboutToRemove)
@@ -1444,6 +1474,28 @@ void SurfaceWrapper::onMappedChanged()
 
     if (!m_isProxy) {
         if (mapped) {
+            auto renderWindow = qobject_cast<WOutputRenderWindow *>(window());
+            if (renderWindow && treelandSurface().isDebugEnabled()) {
+                QElapsedTimer timer;
+                timer.start();
+                auto connection = std::make_shared<QMetaObject::Connection>();
+                *connection = connect(
+                    renderWindow,
+                    &WOutputRenderWindow::renderEnd,
+                    this,
+                    [this, timer, connection] {
+                        if (!surface() || !surface()->mapped()) {
+                            disconnect(*connection);
+                            return;
+                        }
+                        // The window is complete after its decoration is ready
+                        if (m_decorationPending)
+                            return;
+                        qCDebug(treelandSurface) << "Map to the first complete frame of" << this
+                                                 << "took" << timer.elapsed() << "ms";
+                        disconnect(*connection);
+                    });
+            }
             if (!m_prelaunchSplash) {
                 createNewOrClose(OPEN_ANIMATION);
             } else {
@@ -1777,6 +1829,7 @@ void SurfaceWrapper::addSubSurface(SurfaceWrapper *surface)
     surface->m_parentSurface = this;
     surface->updateExplicitAlwaysOnTop();
     m_subSurfaces.append(surface);
+    Q_EMIT subSurfacesChanged();
 }
 
 void SurfaceWrapper::removeSubSurface(SurfaceWrapper *surface)
@@ -1785,6 +1838,7 @@ void SurfaceWrapper::removeSubSurface(SurfaceWrapper *surface)
     surface->m_parentSurface = nullptr;
     surface->updateExplicitAlwaysOnTop();
     m_subSurfaces.removeOne(surface);
+    Q_EMIT subSurfacesChanged();
 }
 
 const QList<SurfaceWrapper *> &SurfaceWrapper::subSurfaces() const
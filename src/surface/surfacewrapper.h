@@ -345,6 +345,7 @@ Q_SIGNALS:
     void isActivatedChanged();
     void attentionChanged();
     void surfaceItemCreated(); // Emitted once after surfaceItem is constructed
+    void subSurfacesChanged();
     void prelaunchSplashChanged();
     void typeChanged();
 
@@ -361,6 +362,7 @@ private:
     void setNormalGeometry(const QRectF &newNormalGeometry);
     void updateTitleBar();
     void updateDecoration();
+    void adoptDecoration(QQuickItem *decoration);
     void setBoundedRect(const QRectF &newBoundedRect);
     void setContainer(SurfaceContainer *newContainer);
     void setVisibleDecoration(bool newVisibleDecoration);
@@ -470,6 +472,7 @@ private:
     bool m_socketEnabled{ false };
     bool m_windowAnimationEnabled{ true };
     bool m_acceptKeyboardFocus{ true };
+    bool m_decorationPending{ false };
     const QString m_appId;
 };
 
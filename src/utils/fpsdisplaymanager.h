@@ -6,27 +6,35 @@
 #include <wglobal.h>
 
 #include <QObject>
-#include <QTimer>
-#include <QElapsedTimer>
-#include <QQueue>
 #include <QPointer>
+#include <QQmlEngine>
+#include <QTimer>
+
+Q_MOC_INCLUDE(<woutputviewport.h>)
 
-class QQuickItem;
 class QQuickWindow;
-class QScreen;
 
 WAYLIB_SERVER_BEGIN_NAMESPACE
-class WOutput;
+class WOutputRenderWindow;
+class WOutputViewport;
 WAYLIB_SERVER_END_NAMESPACE
 
 WAYLIB_SERVER_USE_NAMESPACE
 
+// Shows the frames presented on an output in the last second, from the frame
+// timing recorded by WOutputRenderWindow.
 class FpsDisplayManager : public QObject
 {
     Q_OBJECT
+    Q_PROPERTY(bool running READ running NOTIFY runningChanged)
     Q_PROPERTY(int currentFps READ currentFps NOTIFY currentFpsChanged)
     Q_PROPERTY(int maximumFps READ maximumFps NOTIFY maximumFpsChanged)
     Q_PROPERTY(int displayRefreshRate READ displayRefreshRate NOTIFY refreshRateChanged)
+    Q_PROPERTY(int droppedFrames READ droppedFrames NOTIFY statisticsChanged)
+    Q_PROPERTY(qreal syncTime READ syncTime NOTIFY statisticsChanged)
+    Q_PROPERTY(qreal renderTime READ renderTime NOTIFY statisticsChanged)
+    Q_PROPERTY(qreal commitTime READ commitTime NOTIFY statisticsChanged)
+    Q_PROPERTY(qreal presentLatency READ presentLatency NOTIFY statisticsChanged)
     QML_ELEMENT
 
 public:
@@ -34,58 +42,49 @@ public:
     ~FpsDisplayManager();
 
     Q_INVOKABLE void setTargetWindow(QQuickWindow *window);
-    // TODO: Add setTargetOutput(WOutput* output) method for multi-screen FPS display support
+    // Show the first output of the window if not set
+    Q_INVOKABLE void setTargetOutput(WOutputViewport *output);
     Q_INVOKABLE void start();
     Q_INVOKABLE void stop();
     Q_INVOKABLE void reset();
+    // The timing of the last frames of the output, the timestamps are in nanoseconds
+    Q_INVOKABLE QVariantList frameTimings(int count) const;
 
-    int currentFps() const { return qRound(m_currentFps); }
-    int maximumFps() const { return qRound(m_maximumFps); }
+    bool running() const { return m_updateTimer.isActive(); }
+    int currentFps() const { return m_currentFps; }
+    int maximumFps() const { return m_maximumFps; }
     int displayRefreshRate() const { return m_displayRefreshRate; }
+    int droppedFrames() const { return m_droppedFrames; }
+    qreal syncTime() const { return m_syncTime; }
+    qreal renderTime() const { return m_renderTime; }
+    qreal commitTime() const { return m_commitTime; }
+    qreal presentLatency() const { return m_presentLatency; }
 
 signals:
+    void runningChanged();
     void currentFpsChanged();
     void maximumFpsChanged();
     void refreshRateChanged();
+    void statisticsChanged();
 
 private Q_SLOTS:
     void updateFps();
-    void onVSyncTimer();
-    void onScreenChanged(QScreen *screen);
 
 private:
-    void updateRefreshAndInterval();
-    void updateTimerIntervals();
-    void updateFpsText();
-    void detectDisplayRefreshRate();
-    WOutput *getOutputForWindow() const;
-    WOutput *findBestOutput(const QVector<WOutput*> &outputs) const;
-    void invalidateCache();
+    WOutputViewport *targetOutput() const;
 
-    QPointer<QQuickWindow> m_targetWindow;
-
-    QElapsedTimer m_timer;
+    QPointer<WOutputRenderWindow> m_targetWindow;
+    QPointer<WOutputViewport> m_targetOutput;
     QTimer m_updateTimer;
-    QTimer m_vsyncTimer;
-    QQueue<qint64> m_vSyncTimes;
-
-    qreal m_currentFps = 0.0;
-    qreal m_averageFps = 0.0;
-    qreal m_maximumFps = 0.0;
-    qint64 m_lastUpdateTime = 0;
-    qint64 m_lastVSyncTime_precise = 0;
-
-    int m_displayRefreshRate = 60;              // Display refresh rate in Hz
-    double m_preciseVSyncInterval = 16.67;      // Precise VSync interval in milliseconds
-    // Constants
-    static constexpr int kUpdateIntervalMs = 500;     // UI update frequency in milliseconds
-    static constexpr qint64 kCacheValidityMs = 5000;  // Cache validity: 5 seconds
-
-    // Cache for change detection
-    int m_lastReportedCurrentFps = -1;
-    int m_lastReportedMaximumFps = -1;
-
-    // Output caching for performance optimization
-    mutable QPointer<WOutput> m_cachedOutput;
-    mutable qint64 m_cacheTimestamp = 0;
+
+    int m_currentFps = 0;
+    int m_maximumFps = 0;
+    int m_displayRefreshRate = 60;
+    int m_droppedFrames = 0;
+    qreal m_syncTime = 0;
+    qreal m_renderTime = 0;
+    qreal m_commitTime = 0;
+    qreal m_presentLatency = 0;
+
+    static constexpr int kUpdateIntervalMs = 500;
 };
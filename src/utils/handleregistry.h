@@ -0,0 +1,56 @@
+// Copyright (C) 2026 UnionTech Software Technology Co., Ltd.
+// SPDX-License-Identifier: Apache-2.0 OR LGPL-3.0-only OR GPL-2.0-only OR GPL-3.0-only
+#pragma once
+
+#include <QHash>
+#include <QVarLengthArray>
+
+// Map the handles (e.g. wlr_surface, WSurface, WToplevelSurface) to the object
+// owning them. A handle belongs to the first object registered it, and all the
+// handles of an object are released together by remove().
+template<typename T>
+class HandleRegistry
+{
+public:
+    bool insert(const void *handle, T *object)
+    {
+        Q_ASSERT(handle && object);
+        auto it = m_objects.find(handle);
+        if (it != m_objects.end())
+            return it.value() == object;
+
+        m_objects.insert(handle, object);
+        m_handles[object].append(handle);
+        return true;
+    }
+
+    void remove(T *object)
+    {
+        auto it = m_handles.find(object);
+        if (it == m_handles.end())
+            return;
+
+        for (const void *handle : std::as_const(it.value()))
+            m_objects.remove(handle);
+        m_handles.erase(it);
+    }
+
+    T *get(const void *handle) const
+    {
+        return m_objects.value(handle);
+    }
+
+    bool contains(T *object) const
+    {
+        return m_handles.contains(object);
+    }
+
+    qsizetype count() const
+    {
+        return m_handles.size();
+    }
+
+private:
+    QHash<const void *, T *> m_objects;
+    QHash<T *, QVarLengthArray<const void *, 3>> m_handles;
+};
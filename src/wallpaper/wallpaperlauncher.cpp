@@ -14,10 +14,21 @@ WallpaperLauncher::WallpaperLauncher(QPointer<WSocket> socket)
     m_launcherThread = new QThread();
     this->moveToThread(m_launcherThread);
     m_launcherThread->start();
+
+    // The wallpaper is a part of the compositor, never freeze it for its dispatch time
+    if (m_socket) {
+        m_clientAddedConnection =
+            connect(m_socket, &WSocket::clientAdded, m_socket, [this](WClient *client) {
+                const qint64 pid = m_wallpaperPid;
+                if (pid > 0 && client->credentials()->pid == pid)
+                    client->setThrottlable(false);
+            });
+    }
 }
 
 WallpaperLauncher::~WallpaperLauncher()
 {
+    disconnect(m_clientAddedConnection);
     if (m_launcherThread) {
         QMetaObject::invokeMethod(this,
                                   &WallpaperLauncher::onStopRequested,
@@ -82,6 +93,7 @@ void WallpaperLauncher::onStartRequested()
             this,
             &WallpaperLauncher::handleWallpaperFinished);
     m_wallpaperProcess->start();
+    m_wallpaperPid = m_wallpaperProcess->processId();
 }
 
 void WallpaperLauncher::onStopRequested()
@@ -100,6 +112,7 @@ void WallpaperLauncher::onStopRequested()
     }
     delete m_wallpaperProcess;
     m_wallpaperProcess = nullptr;
+    m_wallpaperPid = 0;
 }
 
 void WallpaperLauncher::handleWallpaperFinished([[maybe_unused]] int exitCode, [[maybe_unused]] QProcess::ExitStatus exitStatus)
@@ -9,6 +9,8 @@
 #include <QThread>
 #include <QProcess>
 
+#include <atomic>
+
 WAYLIB_SERVER_USE_NAMESPACE
 
 class WallpaperLauncher : public QObject
@@ -39,5 +41,8 @@ private:
     QPointer<WSocket> m_socket = nullptr;
     QThread *m_launcherThread = nullptr;
     QProcess *m_wallpaperProcess = nullptr;
+    // Read in the main thread by the clientAdded of the socket
+    std::atomic<qint64> m_wallpaperPid = 0;
+    QMetaObject::Connection m_clientAddedConnection;
     QString m_displayName;
 };
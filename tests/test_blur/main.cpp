@@ -0,0 +1,200 @@
+// Copyright (C) 2026 UnionTech Software Technology Co., Ltd.
+// SPDX-License-Identifier: Apache-2.0 OR LGPL-3.0-only OR GPL-2.0-only OR GPL-3.0-only
+
+// The CPU blur of the software renderer compared to MultiEffect, run the
+// benchmarks only with e.g.
+//   test_blur benchmarkCpuBlur benchmarkMultiEffect
+
+#include "tblurimage.h"
+
+#include <QObject>
+#include <QPainter>
+#include <QQmlComponent>
+#include <QQmlEngine>
+#include <QQuickItem>
+#include <QQuickWindow>
+#include <QTest>
+
+#include <memory>
+
+static const char multiEffectQml[] = R"(
+import QtQuick
+import QtQuick.Effects
+
+Item {
+    id: root
+    property real angle: 0
+
+    Rectangle {
+        id: source
+        anchors.fill: parent
+        rotation: root.angle
+        gradient: Gradient {
+            GradientStop { position: 0; color: "red" }
+            GradientStop { position: 1; color: "blue" }
+        }
+    }
+
+    MultiEffect {
+        anchors.fill: parent
+        source: source
+        autoPaddingEnabled: false
+        blurEnabled: true
+        blur: 1.0
+        blurMax: 64
+        saturation: 0.2
+    }
+}
+)";
+
+static QImage sourceImage(const QSize &size, bool inverted)
+{
+    QImage image(size, QImage::Format_ARGB32_Premultiplied);
+    QPainter painter(&image);
+    QLinearGradient gradient(0, 0, size.width(), size.height());
+    gradient.setColorAt(0, inverted ? Qt::blue : Qt::red);
+    gradient.setColorAt(1, inverted ? Qt::red : Qt::blue);
+    painter.fillRect(image.rect(), gradient);
+    for (int x = 0; x < size.width(); x += 40)
+        painter.fillRect(x, 0, 8, size.height(), QColor(255, 255, 255, 128));
+    return image;
+}
+
+// The pixels may be different by the rounding of the bilinear filtering
+static bool fuzzyCompare(const QImage &a, const QImage &b, int tolerance = 2)
+{
+    if (a.size() != b.size())
+        return false;
+
+    for (int y = 0; y < a.height(); ++y) {
+        auto rowA = reinterpret_cast<const uint *>(a.constScanLine(y));
+        auto rowB = reinterpret_cast<const uint *>(b.constScanLine(y));
+        for (int x = 0; x < a.width(); ++x) {
+            for (int shift = 0; shift < 32; shift += 8) {
+                const int ca = (rowA[x] >> shift) & 0xff;
+                const int cb = (rowB[x] >> shift) & 0xff;
+                if (qAbs(ca - cb) > tolerance)
+                    return false;
+            }
+        }
+    }
+
+    return true;
+}
+
+class BlurTest : public QObject
+{
+    Q_OBJECT
+
+public:
+    BlurTest(QObject *parent = nullptr)
+        : QObject(parent)
+    {
+    }
+
+private Q_SLOTS:
+
+    void testDamage_data()
+    {
+        QTest::addColumn<int>("radius");
+        QTest::addColumn<QRect>("damage");
+
+        QTest::newRow("small radius") << 8 << QRect(100, 50, 30, 20);
+        QTest::newRow("large radius") << 64 << QRect(100, 50, 30, 20);
+        QTest::newRow("edge") << 64 << QRect(0, 0, 10, 300);
+    }
+
+    void testDamage()
+    {
+        QFETCH(int, radius);
+        QFETCH(QRect, damage);
+
+        QImage image = sourceImage(QSize(400, 300), false);
+        TBlurImage blur;
+        blur.setRadius(radius);
+        QCOMPARE(blur.update(image, image.rect()), image.rect());
+        QVERIFY(blur.update(image, QRegion()).isEmpty());
+
+        QPainter painter(&image);
+        painter.fillRect(damage, Qt::green);
+        painter.end();
+
+        const QRect changed = blur.update(image, damage);
+        QVERIFY(changed.contains(damage));
+        QVERIFY(changed != image.rect());
+
+        TBlurImage full;
+        full.setRadius(radius);
+        full.update(image, image.rect());
+        QVERIFY(fuzzyCompare(blur.result(), full.result()));
+    }
+
+    void benchmarkCpuBlur_data()
+    {
+        QTest::addColumn<QSize>("size");
+        QTest::addColumn<QRect>("damage");
+
+        QTest::newRow("dock") << QSize(1280, 72) << QRect();
+        QTest::newRow("fullscreen") << QSize(1920, 1080) << QRect();
+        QTest::newRow("fullscreen damaged") << QSize(1920, 1080) << QRect(900, 500, 64, 64);
+    }
+
+    void benchmarkCpuBlur()
+    {
+        QFETCH(QSize, size);
+        QFETCH(QRect, damage);
+
+        // Switch between two images to change all pixels
+        const QImage images[2] = { sourceImage(size, false), sourceImage(size, true) };
+        QImage image = images[0];
+        TBlurImage blur;
+        blur.setRadius(64);
+        blur.update(image, image.rect());
+
+        int frame = 0;
+        QBENCHMARK {
+            ++frame;
+            QRect changed = image.rect();
+            if (damage.isEmpty()) {
+                image = images[frame % 2];
+            } else {
+                changed = damage.translated(frame % 64, 0);
+                QPainter painter(&image);
+                painter.fillRect(changed, QColor::fromHsv(frame % 360, 255, 255));
+            }
+            blur.update(image, changed);
+        }
+    }
+
+    void benchmarkMultiEffect()
+    {
+        QQmlEngine engine;
+        QQmlComponent component(&engine);
+        component.setData(multiEffectQml, QUrl());
+        if (component.isError())
+            QSKIP(qPrintable(component.errorString()));
+
+        QQuickWindow window;
+        window.resize(1920, 1080);
+        std::unique_ptr<QQuickItem> content(qobject_cast<QQuickItem *>(component.create()));
+        QVERIFY(content);
+        content->setParentItem(window.contentItem());
+        content->setSize(window.size());
+
+        // The scene graph is initialized by the first frame
+        window.grabWindow();
+        if (window.rendererInterface()->graphicsApi() == QSGRendererInterface::Software)
+            QSKIP("MultiEffect has no software renderer path");
+
+        // The grabbing includes reading back the frame, as the CPU blur has
+        // its result in the memory
+        int frame = 0;
+        QBENCHMARK {
+            content->setProperty("angle", ++frame % 360);
+            window.grabWindow();
+        }
+    }
+};
+
+QTEST_MAIN(BlurTest)
+#include "main.moc"
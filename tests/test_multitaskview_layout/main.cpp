@@ -0,0 +1,168 @@
+// Copyright (C) 2026 UnionTech Software Technology Co., Ltd.
+// SPDX-License-Identifier: Apache-2.0 OR LGPL-3.0-only OR GPL-2.0-only OR GPL-3.0-only
+
+#include "multitaskviewlayout.h"
+
+#include <QObject>
+#include <QRandomGenerator>
+#include <QTest>
+
+// The default config of a 1920x1080 output
+static MultitaskviewLayout::Config layoutConfig()
+{
+    MultitaskviewLayout::Config config;
+    config.availableWidth = 1920 - 2 * 20;
+    config.availableHeight = 1080 - 100 - 60;
+    config.topMargin = 100;
+    config.horizontalMargin = 20;
+    config.cellPadding = 8;
+    config.maxRowHeight = 720;
+    config.minRowHeight = 232;
+    config.rowHeightStep = 15;
+    config.loadFactor = 0.6;
+    return config;
+}
+
+static QList<QSizeF> windowSizes(int count, quint32 seed = 1)
+{
+    QRandomGenerator generator(seed);
+    QList<QSizeF> sizes;
+    for (int i = 0; i < count; ++i)
+        sizes.append(QSizeF(generator.bounded(200, 1900), generator.bounded(150, 1000)));
+    return sizes;
+}
+
+static void compareLayout(const MultitaskviewLayout &a, const MultitaskviewLayout &b)
+{
+    QCOMPARE(a.count(), b.count());
+    QCOMPARE(a.rows(), b.rows());
+    QCOMPARE(a.rowHeight(), b.rowHeight());
+    QCOMPARE(a.contentHeight(), b.contentHeight());
+    for (int i = 0; i < a.count(); ++i) {
+        QCOMPARE(a.cell(i).geometry, b.cell(i).geometry);
+        QCOMPARE(a.cell(i).padding, b.cell(i).padding);
+        QCOMPARE(a.cell(i).upIndex, b.cell(i).upIndex);
+        QCOMPARE(a.cell(i).downIndex, b.cell(i).downIndex);
+        QCOMPARE(a.cell(i).leftIndex, b.cell(i).leftIndex);
+        QCOMPARE(a.cell(i).rightIndex, b.cell(i).rightIndex);
+    }
+}
+
+class MultitaskviewLayoutTest : public QObject
+{
+    Q_OBJECT
+
+public:
+    MultitaskviewLayoutTest(QObject *parent = nullptr)
+        : QObject(parent)
+    {
+    }
+
+private Q_SLOTS:
+
+    void testEmpty()
+    {
+        MultitaskviewLayout layout;
+        layout.setConfig(layoutConfig());
+        layout.layout();
+        QCOMPARE(layout.count(), 0);
+        QCOMPARE(layout.rows(), 0);
+    }
+
+    void testFitsInHeight()
+    {
+        const auto config = layoutConfig();
+        MultitaskviewLayout layout;
+        layout.setConfig(config);
+        layout.reset(windowSizes(10));
+        layout.layout();
+
+        QVERIFY(layout.rows() > 0);
+        QVERIFY(layout.rows() * layout.rowHeight() <= config.availableHeight);
+        for (int i = 0; i < layout.count(); ++i) {
+            const auto &cell = layout.cell(i);
+            QVERIFY(cell.geometry.left() >= config.horizontalMargin);
+            QVERIFY(cell.geometry.right() <= config.horizontalMargin + config.availableWidth);
+        }
+    }
+
+    // The incremental layout is the same as laying out all windows again
+    void testIncremental()
+    {
+        QRandomGenerator generator(2);
+        MultitaskviewLayout layout;
+        layout.setConfig(layoutConfig());
+        layout.reset({});
+        layout.layout();
+
+        QList<QSizeF> sizes;
+        for (int i = 0; i < 500; ++i) {
+            const QSizeF size(generator.bounded(200, 1900), generator.bounded(150, 1000));
+            const int operation = sizes.isEmpty() ? 0 : generator.bounded(3);
+            if (operation == 0) {
+                const int index = generator.bounded(int(sizes.size()) + 1);
+                sizes.insert(index, size);
+                layout.insert(index, size);
+            } else if (operation == 1) {
+                const int index = generator.bounded(int(sizes.size()));
+                sizes.remove(index);
+                layout.remove(index);
+            } else {
+                const int index = generator.bounded(int(sizes.size()));
+                sizes[index] = size;
+                layout.resize(index, size);
+            }
+
+            MultitaskviewLayout full;
+            full.setConfig(layoutConfig());
+            full.reset(sizes);
+            full.layout();
+            compareLayout(layout, full);
+        }
+    }
+
+    void benchmarkLayout_data()
+    {
+        QTest::addColumn<int>("count");
+
+        QTest::newRow("10 windows") << 10;
+        QTest::newRow("100 windows") << 100;
+        QTest::newRow("500 windows") << 500;
+    }
+
+    void benchmarkLayout()
+    {
+        QFETCH(int, count);
+
+        MultitaskviewLayout layout;
+        layout.setConfig(layoutConfig());
+        layout.reset(windowSizes(count));
+        QBENCHMARK {
+            layout.layout();
+        }
+    }
+
+    void benchmarkInsertRemove_data()
+    {
+        benchmarkLayout_data();
+    }
+
+    // A window opened and closed in the middle of the grid
+    void benchmarkInsertRemove()
+    {
+        QFETCH(int, count);
+
+        MultitaskviewLayout layout;
+        layout.setConfig(layoutConfig());
+        layout.reset(windowSizes(count));
+        layout.layout();
+        const QSizeF size(800, 600);
+        QBENCHMARK {
+            layout.insert(count / 2, size);
+            layout.remove(count / 2);
+        }
+    }
+};
+
+QTEST_MAIN(MultitaskviewLayoutTest)
+#include "main.moc"
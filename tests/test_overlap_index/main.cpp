@@ -0,0 +1,144 @@
+// Copyright (C) 2026 UnionTech Software Technology Co., Ltd.
+// SPDX-License-Identifier: Apache-2.0 OR LGPL-3.0-only OR GPL-2.0-only OR GPL-3.0-only
+
+#include "overlapindex.h"
+
+#include <QObject>
+#include <QRandomGenerator>
+#include <QTest>
+
+static QRect randomRect(QRandomGenerator &generator)
+{
+    return QRect(generator.bounded(-3000, 4000),
+                 generator.bounded(-2000, 3000),
+                 generator.bounded(-5, 2500),
+                 generator.bounded(-5, 1500));
+}
+
+class OverlapIndexTest : public QObject
+{
+    Q_OBJECT
+
+public:
+    OverlapIndexTest(QObject *parent = nullptr)
+        : QObject(parent)
+    {
+    }
+
+private Q_SLOTS:
+
+    void testOverlap()
+    {
+        QHash<OverlapIndex::Id, bool> states;
+        OverlapIndex index([&states](OverlapIndex::Id area, bool overlapped) {
+            states[area] = overlapped;
+        });
+
+        // A dock at the bottom of a 1920x1080 output
+        const QRect dock(0, 1020, 1920, 60);
+        index.setArea(1, dock);
+        QCOMPARE(states.value(1, true), false);
+
+        index.setWindow(10, QRect(100, 100, 800, 600));
+        QVERIFY(!index.isOverlapped(1));
+        index.setWindow(10, QRect(100, 500, 800, 600));
+        QVERIFY(index.isOverlapped(1));
+        QCOMPARE(states.value(1), true);
+
+        index.setWindow(11, QRect(1000, 900, 400, 300));
+        index.removeWindow(10);
+        QCOMPARE(states.value(1), true);
+        index.setWindow(11, QRect());
+        QCOMPARE(states.value(1), false);
+
+        // Moving the area recounts the windows
+        index.setArea(1, QRect(0, 0, 1920, 60));
+        QVERIFY(!index.isOverlapped(1));
+        index.setWindow(12, QRect(-100, -100, 200, 200));
+        QVERIFY(index.isOverlapped(1));
+
+        index.removeArea(1);
+        states.clear();
+        index.setWindow(12, QRect(0, 0, 10, 10));
+        QVERIFY(states.isEmpty());
+    }
+
+    // The incremental state is the same as intersecting all windows
+    void testIncremental()
+    {
+        QRandomGenerator generator(3);
+        QHash<OverlapIndex::Id, bool> states;
+        OverlapIndex index([&states](OverlapIndex::Id area, bool overlapped) {
+            states[area] = overlapped;
+        });
+        QHash<OverlapIndex::Id, QRect> windows;
+        QHash<OverlapIndex::Id, QRect> areas;
+
+        for (int i = 0; i < 5000; ++i) {
+            const int operation = generator.bounded(10);
+            if (operation < 6) {
+                const OverlapIndex::Id window = generator.bounded(40);
+                const QRect geometry = randomRect(generator);
+                windows[window] = geometry;
+                index.setWindow(window, geometry);
+            } else if (operation < 7) {
+                const OverlapIndex::Id window = generator.bounded(40);
+                windows.remove(window);
+                index.removeWindow(window);
+            } else if (operation < 9) {
+                const OverlapIndex::Id area = 100 + generator.bounded(5);
+                const QRect geometry = randomRect(generator);
+                areas[area] = geometry;
+                index.setArea(area, geometry);
+            } else {
+                const OverlapIndex::Id area = 100 + generator.bounded(5);
+                areas.remove(area);
+                states.remove(area);
+                index.removeArea(area);
+            }
+
+            for (auto &&[area, geometry] : areas.asKeyValueRange()) {
+                bool overlapped = false;
+                for (const QRect &window : std::as_const(windows))
+                    overlapped |= window.intersects(geometry);
+                QCOMPARE(index.isOverlapped(area), overlapped);
+                QCOMPARE(states.value(area), overlapped);
+            }
+        }
+    }
+
+    void benchmarkMoveWindow_data()
+    {
+        QTest::addColumn<int>("count");
+
+        QTest::newRow("10 windows") << 10;
+        QTest::newRow("100 windows") << 100;
+        QTest::newRow("1000 windows") << 1000;
+    }
+
+    // A window dragged across the dock among the other windows
+    void benchmarkMoveWindow()
+    {
+        QFETCH(int, count);
+
+        QRandomGenerator generator(1);
+        OverlapIndex index([](OverlapIndex::Id, bool) { });
+        index.setArea(1, QRect(0, 1020, 1920, 60));
+        for (int i = 0; i < count; ++i) {
+            index.setWindow(100 + i,
+                            QRect(generator.bounded(0, 1600),
+                                  generator.bounded(0, 900),
+                                  generator.bounded(200, 1000),
+                                  generator.bounded(150, 800)));
+        }
+
+        int y = 0;
+        QBENCHMARK {
+            y = (y + 7) % 1080;
+            index.setWindow(2, QRect(600, y, 800, 600));
+        }
+    }
+};
+
+QTEST_MAIN(OverlapIndexTest)
+#include "main.moc"
@@ -0,0 +1,125 @@
+// Copyright (C) 2026 UnionTech Software Technology Co., Ltd.
+// SPDX-License-Identifier: Apache-2.0 OR LGPL-3.0-only OR GPL-2.0-only OR GPL-3.0-only
+
+#include "modules/shortcut/shortcutcontroller.h"
+#include "modules/shortcut/shortcutmanager.h"
+
+#include <QKeyEvent>
+#include <QObject>
+#include <QSignalSpy>
+#include <QTest>
+
+// The function keys with the combinations of the modifiers, 8 * 35 bindings
+static void registerKeys(ShortcutController &controller)
+{
+    static const char *const modifiers[] = {
+        "", "Ctrl+", "Alt+", "Shift+", "Meta+", "Ctrl+Alt+", "Ctrl+Shift+", "Meta+Shift+",
+    };
+    int index = 0;
+    for (const char *modifier : modifiers) {
+        for (int key = 1; key <= 35; ++key) {
+            const QString name = QStringLiteral("key%1").arg(index++);
+            const QString sequence = QString::fromLatin1(modifier) + QStringLiteral("F%1").arg(key);
+            QCOMPARE(controller.registerKey(name,
+                                            sequence,
+                                            ShortcutController::KeyPress,
+                                            ShortcutAction::Notify),
+                     0u);
+        }
+    }
+}
+
+class ShortcutDispatchTest : public QObject
+{
+    Q_OBJECT
+
+public:
+    ShortcutDispatchTest(QObject *parent = nullptr)
+        : QObject(parent)
+    {
+    }
+
+private Q_SLOTS:
+
+    void testDispatch()
+    {
+        ShortcutController controller;
+        QSignalSpy spy(&controller, &ShortcutController::actionTriggered);
+        QCOMPARE(controller.registerKey("press",
+                                        "Meta+D",
+                                        ShortcutController::KeyPress,
+                                        ShortcutAction::Notify),
+                 0u);
+        QCOMPARE(controller.registerKey("release",
+                                        "Meta+D",
+                                        ShortcutController::KeyRelease,
+                                        ShortcutAction::Workspace1),
+                 0u);
+
+        QKeyEvent press(QEvent::KeyPress, Qt::Key_D, Qt::MetaModifier);
+        QVERIFY(controller.dispatchKeyEvent(&press));
+        QCOMPARE(spy.count(), 1);
+        QCOMPARE(spy.at(0).at(1).toString(), QStringLiteral("press"));
+
+        // Consumed without the bindings of the repeat
+        QKeyEvent repeat(QEvent::KeyPress, Qt::Key_D, Qt::MetaModifier, QString(), true);
+        QVERIFY(controller.dispatchKeyEvent(&repeat));
+        QCOMPARE(spy.count(), 1);
+
+        QKeyEvent release(QEvent::KeyRelease, Qt::Key_D, Qt::MetaModifier);
+        QVERIFY(controller.dispatchKeyEvent(&release));
+        QCOMPARE(spy.count(), 2);
+        QCOMPARE(spy.at(1).at(1).toString(), QStringLiteral("release"));
+
+        QKeyEvent other(QEvent::KeyPress, Qt::Key_E, Qt::MetaModifier);
+        QVERIFY(!controller.dispatchKeyEvent(&other));
+
+        // The key is no longer consumed without the bindings
+        controller.unregisterShortcut("press");
+        controller.unregisterShortcut("release");
+        QVERIFY(!controller.dispatchKeyEvent(&press));
+        QCOMPARE(spy.count(), 2);
+    }
+
+    void testModifierOnly()
+    {
+        ShortcutController controller;
+        QSignalSpy spy(&controller, &ShortcutController::actionTriggered);
+        QCOMPARE(controller.registerKey("meta",
+                                        "Meta",
+                                        ShortcutController::KeyRelease,
+                                        ShortcutAction::Notify),
+                 0u);
+
+        QKeyEvent release(QEvent::KeyRelease, Qt::Key_Super_L, Qt::NoModifier);
+        QVERIFY(controller.dispatchKeyEvent(&release));
+        QCOMPARE(spy.count(), 1);
+    }
+
+    void benchmarkDispatch_data()
+    {
+        QTest::addColumn<bool>("bound");
+
+        QTest::newRow("typing") << false;
+        QTest::newRow("shortcut") << true;
+    }
+
+    // A key event among 280 bindings, typing a letter doesn't match any
+    void benchmarkDispatch()
+    {
+        QFETCH(bool, bound);
+
+        ShortcutController controller;
+        registerKeys(controller);
+        QKeyEvent event(QEvent::KeyPress,
+                        bound ? Qt::Key_F12 : Qt::Key_A,
+                        bound ? Qt::ControlModifier | Qt::AltModifier : Qt::NoModifier);
+        QBENCHMARK {
+            if (controller.dispatchKeyEvent(&event) != bound)
+                QFAIL("Wrong dispatch result");
+        }
+    }
+};
+
+QTEST_MAIN(ShortcutDispatchTest)
+#include "main.moc"
@@ -0,0 +1,156 @@
+// Copyright (C) 2026 UnionTech Software Technology Co., Ltd.
+// SPDX-License-Identifier: Apache-2.0 OR LGPL-3.0-only OR GPL-2.0-only OR GPL-3.0-only
+
+#include "utils/handleregistry.h"
+
+#include <QObject>
+#include <QTest>
+
+#include <memory>
+#include <vector>
+
+// Stand-ins of the wlr_surface, WSurface and WToplevelSurface of a SurfaceWrapper
+struct Toplevel
+{
+    int wlrSurface = 0;
+    int surface = 0;
+    int shellSurface = 0;
+};
+
+static std::vector<std::unique_ptr<Toplevel>> createToplevels(int count)
+{
+    std::vector<std::unique_ptr<Toplevel>> toplevels;
+    for (int i = 0; i < count; ++i)
+        toplevels.push_back(std::make_unique<Toplevel>());
+    return toplevels;
+}
+
+static void registerToplevel(HandleRegistry<Toplevel> &registry, Toplevel *toplevel)
+{
+    registry.insert(&toplevel->wlrSurface, toplevel);
+    registry.insert(&toplevel->surface, toplevel);
+    registry.insert(&toplevel->shellSurface, toplevel);
+}
+
+class SurfaceRegistryTest : public QObject
+{
+    Q_OBJECT
+
+public:
+    SurfaceRegistryTest(QObject *parent = nullptr)
+        : QObject(parent)
+    {
+    }
+
+private Q_SLOTS:
+
+    void testLookup()
+    {
+        const auto toplevels = createToplevels(10);
+        HandleRegistry<Toplevel> registry;
+        for (const auto &toplevel : toplevels)
+            registerToplevel(registry, toplevel.get());
+
+        QCOMPARE(registry.count(), 10);
+        for (const auto &toplevel : toplevels) {
+            QCOMPARE(registry.get(&toplevel->wlrSurface), toplevel.get());
+            QCOMPARE(registry.get(&toplevel->surface), toplevel.get());
+            QCOMPARE(registry.get(&toplevel->shellSurface), toplevel.get());
+        }
+        QCOMPARE(registry.get(nullptr), nullptr);
+    }
+
+    void testRemove()
+    {
+        const auto toplevels = createToplevels(3);
+        HandleRegistry<Toplevel> registry;
+        for (const auto &toplevel : toplevels)
+            registerToplevel(registry, toplevel.get());
+
+        Toplevel *removed = toplevels[1].get();
+        registry.remove(removed);
+        QVERIFY(!registry.contains(removed));
+        QCOMPARE(registry.get(&removed->wlrSurface), nullptr);
+        QCOMPARE(registry.get(&removed->surface), nullptr);
+        QCOMPARE(registry.get(&removed->shellSurface), nullptr);
+        QCOMPARE(registry.get(&toplevels[2]->surface), toplevels[2].get());
+
+        // Removing twice is harmless, and the handles can be registered again
+        registry.remove(removed);
+        registerToplevel(registry, removed);
+        QCOMPARE(registry.get(&removed->surface), removed);
+    }
+
+    // A handle belongs to the first object registered it
+    void testFirstOwner()
+    {
+        const auto toplevels = createToplevels(2);
+        HandleRegistry<Toplevel> registry;
+        int handle = 0;
+        QVERIFY(registry.insert(&handle, toplevels[0].get()));
+        QVERIFY(registry.insert(&handle, toplevels[0].get()));
+        QVERIFY(!registry.insert(&handle, toplevels[1].get()));
+        QCOMPARE(registry.get(&handle), toplevels[0].get());
+
+        registry.remove(toplevels[1].get());
+        QCOMPARE(registry.get(&handle), toplevels[0].get());
+    }
+
+    void benchmarkLookup_data()
+    {
+        QTest::addColumn<bool>("linear");
+
+        QTest::newRow("registry") << false;
+        QTest::newRow("linear scan") << true;
+    }
+
+    // Find every toplevel of 1000 by its WSurface, the linear scan is how
+    // RootSurfaceContainer::getSurface worked before the registry
+    void benchmarkLookup()
+    {
+        QFETCH(bool, linear);
+
+        const auto toplevels = createToplevels(1000);
+        HandleRegistry<Toplevel> registry;
+        QList<Toplevel *> list;
+        for (const auto &toplevel : toplevels) {
+            registerToplevel(registry, toplevel.get());
+            list.append(toplevel.get());
+        }
+
+        const auto find = [&](const int *surface) -> Toplevel * {
+            if (!linear)
+                return registry.get(surface);
+            for (auto toplevel : std::as_const(list)) {
+                if (&toplevel->surface == surface)
+                    return toplevel;
+            }
+            return nullptr;
+        };
+
+        QBENCHMARK {
+            for (const auto &toplevel : toplevels) {
+                if (find(&toplevel->surface) != toplevel.get())
+                    QFAIL("Wrong toplevel found");
+            }
+        }
+    }
+
+    // A toplevel mapped and unmapped among 1000 toplevels
+    void benchmarkInsertRemove()
+    {
+        const auto toplevels = createToplevels(1001);
+        HandleRegistry<Toplevel> registry;
+        for (int i = 0; i < 1000; ++i)
+            registerToplevel(registry, toplevels[i].get());
+
+        Toplevel *toplevel = toplevels.back().get();
+        QBENCHMARK {
+            registerToplevel(registry, toplevel);
+            registry.remove(toplevel);
+        }
+    }
+};
+
+QTEST_MAIN(SurfaceRegistryTest)
+#include "main.moc"
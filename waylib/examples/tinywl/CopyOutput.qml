@@ -49,6 +49,8 @@ OutputItem {
 
         anchors.centerIn: parent
         depends: [screenViewport]
+        // The content is rendered only if the source's buffer can't be shown
+        mirrorSource: screenViewport
         devicePixelRatio: outputItem.devicePixelRatio
         input: content
         output: outputItem.output
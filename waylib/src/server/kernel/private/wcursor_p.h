@@ -42,6 +42,10 @@ public:
     WCursorPrivate(WCursor *qq);
     ~WCursorPrivate();
 
+    static inline WCursorPrivate *get(WCursor *qq) {
+        return qq->d_func();
+    }
+
     WWRAP_HANDLE_FUNCTIONS(QW_NAMESPACE::qw_cursor, wlr_cursor)
 
     void instantRelease() override;
@@ -72,6 +76,8 @@ public:
 
     void connect();
     void processCursorMotion(QW_NAMESPACE::qw_pointer *device, uint32_t time);
+    void deliverCursorMotion(QW_NAMESPACE::qw_pointer *device, uint32_t time);
+    void flushPendingMotion();
 
     W_DECLARE_PUBLIC(WCursor)
 
@@ -88,6 +94,15 @@ public:
     Qt::MouseButton button = Qt::NoButton;
     QPointF lastPressedOrTouchDownPosition;
     bool visible = true;
+
+    // for motion coalescing, the motion events are delivered once when
+    // the current event dispatching is finished
+    bool coalesceMotion = false;
+    bool hasPendingMotion = false;
+    bool hasPendingFrame = false;
+    bool motionFlushScheduled = false;
+    QPointer<QW_NAMESPACE::qw_pointer> pendingMotionDevice;
+    uint32_t pendingMotionTime = 0;
 };
 
 WAYLIB_SERVER_END_NAMESPACE
@@ -6,7 +6,10 @@
 #include "wserver.h"
 #include "wglobal_p.h"
 
+#include <QPointer>
+
 struct wl_event_loop;
+struct wl_protocol_logger;
 
 QT_BEGIN_NAMESPACE
 class QSocketNotifier;
@@ -45,6 +48,19 @@ public:
 
     bool isProcessingEvents = false;
     void safeFlushClients();
+
+    // in microseconds, yield to Qt if an iteration of the dispatch exceeds it,
+    // 0 to never yield
+    int dispatchBudget = 0;
+    // in milliseconds per second, 0 to never throttle the clients
+    int clientDispatchLimit = 0;
+    wl_protocol_logger *protocolLogger = nullptr;
+    // the client of the request in handling, see finishRequest
+    QPointer<WClient> dispatchingClient;
+    qint64 requestStart = 0;
+    // the last request or event of dispatchingClient
+    qint64 requestActivity = 0;
+    void finishRequest(qint64 end);
 };
 
 WAYLIB_SERVER_END_NAMESPACE
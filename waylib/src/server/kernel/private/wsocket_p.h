@@ -0,0 +1,48 @@
+// Copyright (C) 2026 UnionTech Software Technology Co., Ltd.
+// SPDX-License-Identifier: Apache-2.0 OR LGPL-3.0-only OR GPL-2.0-only OR GPL-3.0-only
+
+#pragma once
+
+#include "wsocket.h"
+#include "wglobal_p.h"
+
+#include <QSharedPointer>
+
+struct wl_client;
+
+WAYLIB_SERVER_BEGIN_NAMESPACE
+
+class Q_DECL_HIDDEN WClientPrivate : public WObjectPrivate
+{
+public:
+    WClientPrivate(wl_client *handle, WSocket *socket, WClient *qq, bool isWlClientOwned);
+    ~WClientPrivate();
+
+    static inline WClientPrivate *get(WClient *qq) {
+        return qq->d_func();
+    }
+
+    // Freeze the client for the interval, see WServer::setClientDispatchLimit
+    void throttle(int msecs);
+    // Send SIGCONT before the handle is gone, the process is stopped for good otherwise
+    void resumeThrottled();
+
+    W_DECLARE_PUBLIC(WClient)
+
+    wl_client *handle = nullptr;
+    WSocket *socket = nullptr;
+    mutable QSharedPointer<WClient::Credentials> credentials;
+    mutable int pidFD = -1;
+    bool isWlClientOwned = true;
+
+    WClient::DispatchStatistics dispatchStatistics;
+    // the dispatch time in the current second, CLOCK_MONOTONIC in nanoseconds
+    qint64 dispatchWindowStart = 0;
+    qint64 dispatchWindowTime = 0;
+    bool throttled = false;
+    bool throttlable = true;
+    // by WClient::freeze(), the end of the throttling doesn't resume it
+    bool frozen = false;
+};
+
+WAYLIB_SERVER_END_NAMESPACE
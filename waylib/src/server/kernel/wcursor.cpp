@@ -46,6 +46,7 @@ Q_LOGGING_CATEGORY(waylibCursorTouch, "waylib.server.cursor.touch", QtInfoMsg)
 
 WCursorPrivate::WCursorPrivate(WCursor *qq)
     : WWrapObjectPrivate(qq)
+    , coalesceMotion(qEnvironmentVariableIsSet("WAYLIB_COALESCE_POINTER_MOTION"))
 {
     initHandle(qw_cursor::create());
     handle()->set_data(this, qq);
@@ -93,8 +94,13 @@ void WCursorPrivate::sendLeaveEvent(WInputDevice *device)
 
 void WCursorPrivate::on_motion(wlr_pointer_motion_event *event)
 {
+    W_Q(WCursor);
     auto device = qw_pointer::from(event->pointer);
-    q_func()->move(device, QPointF(event->delta_x, event->delta_y));
+    Q_EMIT q->relativeMotion(WInputDevice::fromHandle(device),
+                             QPointF(event->delta_x, event->delta_y),
+                             QPointF(event->unaccel_dx, event->unaccel_dy),
+                             event->time_msec);
+    q->move(device, QPointF(event->delta_x, event->delta_y));
     processCursorMotion(device, event->time_msec);
 }
 
@@ -107,6 +113,7 @@ void WCursorPrivate::on_motion_absolute(wlr_pointer_motion_absolute_event *event
 
 void WCursorPrivate::on_button(wlr_pointer_button_event *event)
 {
+    flushPendingMotion();
     auto device = qw_pointer::from(event->pointer);
     button = WCursor::fromNativeButton(event->button);
 
@@ -130,6 +137,7 @@ void WCursorPrivate::on_button(wlr_pointer_button_event *event)
 
 void WCursorPrivate::on_axis(wlr_pointer_axis_event *event)
 {
+    flushPendingMotion();
     auto device = qw_pointer::from(event->pointer);
 
     if (auto inputDevice = WInputDevice::fromHandle(device)) {
@@ -144,6 +152,12 @@ void WCursorPrivate::on_axis(wlr_pointer_axis_event *event)
 
 void WCursorPrivate::on_frame()
 {
+    // The frame must follow the motion events
+    if (hasPendingMotion) {
+        hasPendingFrame = true;
+        return;
+    }
+
     if (Q_LIKELY(seat)) {
         seat->notifyFrame(q_func());
     }
@@ -151,6 +165,7 @@ void WCursorPrivate::on_frame()
 
 void WCursorPrivate::on_swipe_begin(wlr_pointer_swipe_begin_event *event)
 {
+    flushPendingMotion();
     auto device = qw_pointer::from(event->pointer);
     if (Q_LIKELY(seat)) {
         seat->notifyGestureBegin(q_func(), WInputDevice::fromHandle(device),
@@ -160,6 +175,7 @@ void WCursorPrivate::on_swipe_begin(wlr_pointer_swipe_begin_event *event)
 
 void WCursorPrivate::on_swipe_update(wlr_pointer_swipe_update_event *event)
 {
+    flushPendingMotion();
     auto device = qw_pointer::from(event->pointer);
     if (Q_LIKELY(seat)) {
         QPointF delta = QPointF(event->dx, event->dy);
@@ -170,6 +186,7 @@ void WCursorPrivate::on_swipe_update(wlr_pointer_swipe_update_event *event)
 
 void WCursorPrivate::on_swipe_end(wlr_pointer_swipe_end_event *event)
 {
+    flushPendingMotion();
     auto device = qw_pointer::from(event->pointer);
     if (Q_LIKELY(seat)) {
         seat->notifyGestureEnd(q_func(), WInputDevice::fromHandle(device),
@@ -179,6 +196,7 @@ void WCursorPrivate::on_swipe_end(wlr_pointer_swipe_end_event *event)
 
 void WCursorPrivate::on_pinch_begin(wlr_pointer_pinch_begin_event *event)
 {
+    flushPendingMotion();
     auto device = qw_pointer::from(event->pointer);
     if (Q_LIKELY(seat)) {
         seat->notifyGestureBegin(q_func(), WInputDevice::fromHandle(device),
@@ -188,6 +206,7 @@ void WCursorPrivate::on_pinch_begin(wlr_pointer_pinch_begin_event *event)
 
 void WCursorPrivate::on_pinch_update(wlr_pointer_pinch_update_event *event)
 {
+    flushPendingMotion();
     auto device = qw_pointer::from(event->pointer);
     if (Q_LIKELY(seat)) {
         QPointF delta = QPointF(event->dx, event->dy);
@@ -199,6 +218,7 @@ void WCursorPrivate::on_pinch_update(wlr_pointer_pinch_update_event *event)
 
 void WCursorPrivate::on_pinch_end(wlr_pointer_pinch_end_event *event)
 {
+    flushPendingMotion();
     auto device = qw_pointer::from(event->pointer);
     if (Q_LIKELY(seat)) {
         seat->notifyGestureEnd(q_func(), WInputDevice::fromHandle(device),
@@ -209,6 +229,7 @@ void WCursorPrivate::on_pinch_end(wlr_pointer_pinch_end_event *event)
 
 void WCursorPrivate::on_hold_begin(wlr_pointer_hold_begin_event *event)
 {
+    flushPendingMotion();
     auto device = qw_pointer::from(event->pointer);
     if (Q_LIKELY(seat)) {
         seat->notifyHoldBegin(q_func(), WInputDevice::fromHandle(device),
@@ -218,6 +239,7 @@ void WCursorPrivate::on_hold_begin(wlr_pointer_hold_begin_event *event)
 
 void WCursorPrivate::on_hold_end(wlr_pointer_hold_end_event *event)
 {
+    flushPendingMotion();
     auto device = qw_pointer::from(event->pointer);
     if (Q_LIKELY(seat)) {
         seat->notifyHoldEnd(q_func(), WInputDevice::fromHandle(device),
@@ -335,6 +357,46 @@ void WCursorPrivate::connect()
 }
 
 void WCursorPrivate::processCursorMotion(qw_pointer *device, uint32_t time)
+{
+    if (!coalesceMotion) {
+        deliverCursorMotion(device, time);
+        return;
+    }
+
+    if (hasPendingMotion && pendingMotionDevice != device)
+        flushPendingMotion();
+
+    hasPendingMotion = true;
+    pendingMotionDevice = device;
+    pendingMotionTime = time;
+
+    if (!motionFlushScheduled) {
+        motionFlushScheduled = true;
+        // Run after the other input events of this dispatching
+        QMetaObject::invokeMethod(q_func(), [this] {
+            motionFlushScheduled = false;
+            flushPendingMotion();
+        }, Qt::QueuedConnection);
+    }
+}
+
+void WCursorPrivate::flushPendingMotion()
+{
+    if (!hasPendingMotion)
+        return;
+
+    hasPendingMotion = false;
+    if (pendingMotionDevice)
+        deliverCursorMotion(pendingMotionDevice, pendingMotionTime);
+    pendingMotionDevice = nullptr;
+
+    if (hasPendingFrame) {
+        hasPendingFrame = false;
+        on_frame();
+    }
+}
+
+void WCursorPrivate::deliverCursorMotion(qw_pointer *device, uint32_t time)
 {
     W_Q(WCursor);
 
@@ -688,6 +750,23 @@ bool WCursor::setPositionWithChecker(const QPointF &pos)
     return setPositionWithChecker(nullptr, pos);
 }
 
+bool WCursor::coalesceMotion() const
+{
+    W_DC(WCursor);
+    return d->coalesceMotion;
+}
+
+void WCursor::setCoalesceMotion(bool on)
+{
+    W_D(WCursor);
+    if (d->coalesceMotion == on)
+        return;
+
+    d->coalesceMotion = on;
+    if (!on)
+        d->flushPendingMotion();
+}
+
 bool WCursor::isVisible() const
 {
     W_DC(WCursor);
@@ -77,6 +77,11 @@ public:
     bool isVisible() const;
     void setVisible(bool visible);
 
+    // Deliver one motion event for all pointer motions in the same event dispatching,
+    // the cursor position and relativeMotion are still updated for every motion.
+    bool coalesceMotion() const;
+    void setCoalesceMotion(bool on);
+
     QPointF position() const;
     QPointF lastPressedOrTouchDownPosition() const;
 
@@ -89,6 +94,10 @@ Q_SIGNALS:
     void layoutChanged();
     void cursorChanged();
     void visibleChanged();
+    // Emitted for every relative motion of the pointer devices, never coalesced,
+    // WSeat sends it to the clients by the relative pointer protocol
+    void relativeMotion(WAYLIB_SERVER_NAMESPACE::WInputDevice *device, const QPointF &delta,
+                        const QPointF &unacceleratedDelta, uint32_t timestamp);
 
 protected:
     WCursor(WCursorPrivate &dd, QObject *parent = nullptr);
@@ -9,6 +9,7 @@
 #include "wxdgsurface.h"
 #include "platformplugin/qwlrootsintegration.h"
 #include "private/wglobal_p.h"
+#include "private/wcursor_p.h"
 
 #include <qwseat.h>
 #include <qwkeyboard.h>
@@ -16,6 +17,7 @@
 #include <qwcompositor.h>
 #include <qwdatadevice.h>
 #include <qwpointergesturesv1.h>
+#include <qwrelativepointerv1.h>
 #include <qwcompositor.h>
 #include <qwdisplay.h>
 #include <qwprimaryselection.h>
@@ -354,6 +356,8 @@ public:
     QString name;
     WCursor *cursor = nullptr;
     qw_pointer_gestures_v1 *gesture = nullptr;
+    qw_relative_pointer_manager_v1 *relativePointer = nullptr;
+    QMetaObject::Connection relativeMotionConnection;
     QVector<WInputDevice*> deviceList;
     QVector<WInputDevice*> touchDeviceList;
     QPointer<WSeatEventFilter> eventFilter;
@@ -530,6 +534,10 @@ void WSeatPrivate::handleKeyEvent(QKeyEvent &e)
 }
 void WSeatPrivate::on_keyboard_key(wlr_keyboard_key_event *event, WInputDevice *device)
 {
+    // Keep the order with the coalesced pointer motion
+    if (cursor)
+        WCursorPrivate::get(cursor)->flushPendingMotion();
+
     auto keyboard = qobject_cast<qw_keyboard*>(device->handle());
 
     auto code = event->keycode + 8; // map to wl_keyboard::keymap_format::keymap_format_xkb_v1
@@ -586,6 +594,9 @@ void WSeatPrivate::on_keyboard_key(wlr_keyboard_key_event *event, WInputDevice *
 
 void WSeatPrivate::on_keyboard_modifiers(WInputDevice *device)
 {
+    if (cursor)
+        WCursorPrivate::get(cursor)->flushPendingMotion();
+
     auto keyboard = qobject_cast<qw_keyboard*>(device->handle());
     keyModifiers = QXkbCommon::modifiers(keyboard->handle()->xkb_state);
     doNotifyModifiers(device);
@@ -740,10 +751,24 @@ void WSeat::setCursor(WCursor *cursor)
         }
 
         d->cursor->setSeat(nullptr);
+        QObject::disconnect(d->relativeMotionConnection);
     }
 
     d->cursor = cursor;
 
+    if (cursor) {
+        // The relative motions are never coalesced, see WCursor::coalesceMotion
+        d->relativeMotionConnection = connect(cursor, &WCursor::relativeMotion, this,
+                                              [d] (WInputDevice *, const QPointF &delta,
+                                                   const QPointF &unacceleratedDelta, uint32_t timestamp) {
+            if (!d->relativePointer)
+                return;
+            d->relativePointer->send_relative_motion(d->nativeHandle(), uint64_t(timestamp) * 1000,
+                                                     delta.x(), delta.y(),
+                                                     unacceleratedDelta.x(), unacceleratedDelta.y());
+        });
+    }
+
     if (isValid() && cursor) {
         cursor->setSeat(this);
 
@@ -1496,6 +1521,13 @@ void WSeat::create(WServer *server)
     if (!qEnvironmentVariableIsSet("WAYLIB_DISABLE_GESTURE"))
         d->gesture = qw_pointer_gestures_v1::create(*server->handle());
 
+    // Shared by all seats, the relative pointers of a client are only
+    // reachable from the global it bound
+    static QPointer<qw_relative_pointer_manager_v1> relativePointer;
+    if (!relativePointer && !qEnvironmentVariableIsSet("WAYLIB_DISABLE_RELATIVE_POINTER"))
+        relativePointer = qw_relative_pointer_manager_v1::create(*server->handle());
+    d->relativePointer = relativePointer;
+
     d->updateCapabilities();
 
     if (d->cursor)
@@ -1521,6 +1553,8 @@ void WSeat::destroy(WServer *)
     if (d->cursor)
         setCursor(nullptr);
 
+    d->relativePointer = nullptr;
+
     if (m_handle) {
         d->handle()->set_data(nullptr, nullptr);
         m_handle = nullptr;
@@ -10,6 +10,7 @@
 #include "private/wserver_p.h"
 #include "wsurface.h"
 #include "wsocket.h"
+#include "private/wsocket_p.h"
 #include "platformplugin/qwlrootsintegration.h"
 
 #include <qwdisplay.h>
@@ -30,6 +31,8 @@
 #include <QLocalServer>
 #include <QLocalSocket>
 #include <unistd.h>
+#include <time.h>
+#include <cstring>
 #include <private/qthread_p.h>
 #include <private/qguiapplication_p.h>
 #include <qpa/qplatformthemefactory_p.h>
@@ -74,11 +77,88 @@ static bool globalFilter(const wl_client *client,
     return d->globalFilterFunc(client, global, d->globalFilterFuncData);
 }
 
+static inline qint64 monotonicNsecs()
+{
+    timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1000000000ll + ts.tv_nsec;
+}
+
+// The size of the message on the wire, see wl_closure_marshal
+static quint32 messageSize(const wl_protocol_logger_message *message)
+{
+    quint32 size = 8;
+    const char *signature = message->message->signature;
+    for (int i = 0; i < message->arguments_count && *signature; ++signature) {
+        const auto &arg = message->arguments[i];
+        switch (*signature) {
+        case 'i': case 'u': case 'f': case 'o': case 'n':
+            size += 4;
+            break;
+        case 's':
+            size += 4 + (arg.s ? (strlen(arg.s) + 4) & ~3u : 0);
+            break;
+        case 'a':
+            size += 4 + (arg.a ? (arg.a->size + 3) & ~3u : 0);
+            break;
+        case 'h':
+            break;
+        default:
+            // '?' and the version
+            continue;
+        }
+        ++i;
+    }
+
+    return size;
+}
+
+// libwayland has no hook at the end of the request handlers of a client, the
+// time of a request lasts until the next request of the same client. For the
+// last request of the batch, which can't be told apart from the sources
+// dispatched after the client, until the last event sent to the client.
+static void logProtocol(void *data, wl_protocol_logger_type type,
+                        const wl_protocol_logger_message *message)
+{
+    WServerPrivate *d = reinterpret_cast<WServerPrivate*>(data);
+    auto client = WClient::get(wl_resource_get_client(message->resource));
+
+    if (type == WL_PROTOCOL_LOGGER_EVENT) {
+        if (client) {
+            ++WClientPrivate::get(client)->dispatchStatistics.events;
+            if (client == d->dispatchingClient)
+                d->requestActivity = monotonicNsecs();
+        }
+        return;
+    }
+
+    // The request is logged before calling its handler
+    const qint64 now = monotonicNsecs();
+    d->finishRequest(client && client == d->dispatchingClient ? now : d->requestActivity);
+    if (!client)
+        return;
+
+    auto &statistics = WClientPrivate::get(client)->dispatchStatistics;
+    ++statistics.requests;
+    statistics.requestBytes += messageSize(message);
+    d->dispatchingClient = client;
+    d->requestStart = now;
+    d->requestActivity = now;
+}
+
 WServerPrivate::WServerPrivate(WServer *qq)
     : WObjectPrivate(qq)
 {
     display.reset(new qw_display());
     wl_display_set_global_filter(display->handle(), globalFilter, this);
+
+    bool ok = false;
+    int value = qEnvironmentVariableIntValue("WAYLIB_DISPATCH_BUDGET", &ok);
+    if (ok && value >= 0)
+        dispatchBudget = value;
+    value = qEnvironmentVariableIntValue("WAYLIB_CLIENT_DISPATCH_LIMIT", &ok);
+    if (ok && value >= 0)
+        clientDispatchLimit = value;
 }
 
 WServerPrivate::~WServerPrivate()
@@ -104,17 +184,32 @@ void WServerPrivate::init()
 
     loop = wl_display_get_event_loop(display->handle());
     int fd = wl_event_loop_get_fd(loop);
+    protocolLogger = display->add_protocol_logger(logProtocol, this);
 
     sockNot.reset(new QSocketNotifier(fd, QSocketNotifier::Read));
-    QObject::connect(sockNot.get(), &QSocketNotifier::activated, q, [this] {
+    QObject::connect(sockNot.get(), &QSocketNotifier::activated, q, [this, q] {
         if (isProcessingEvents)
             return;
 
         QScopedValueRollback<bool> guard(isProcessingEvents, true);
 
+        const qint64 start = monotonicNsecs();
         int ret = wl_event_loop_dispatch(loop, 0);
         if (ret)
             fprintf(stderr, "wl_event_loop_dispatch error: %d\n", ret);
+
+        const qint64 end = monotonicNsecs();
+        finishRequest(requestActivity);
+
+        // A client flooding the requests can keep the fd readable, let the
+        // posted events and the rendering run before the next iteration.
+        if (dispatchBudget > 0 && end - start > dispatchBudget * 1000ll) {
+            sockNot->setEnabled(false);
+            QMetaObject::invokeMethod(q, [this] {
+                if (sockNot)
+                    sockNot->setEnabled(true);
+            }, Qt::QueuedConnection);
+        }
     });
 
     // Match upstream wl_display_run order: flush before dispatch.
@@ -139,6 +234,11 @@ void WServerPrivate::stop()
     // Disconnect event handlers BEFORE destroying clients to prevent
     // callbacks from firing during client destruction.
     sockNot.reset();
+    if (protocolLogger) {
+        wl_protocol_logger_destroy(protocolLogger);
+        protocolLogger = nullptr;
+    }
+    dispatchingClient = nullptr;
     if (auto *dispatcher = QThread::currentThread()->eventDispatcher())
         QObject::disconnect(dispatcher, nullptr, q, nullptr);
 
@@ -170,6 +270,30 @@ void WServerPrivate::safeFlushClients()
     }
 }
 
+void WServerPrivate::finishRequest(qint64 end)
+{
+    if (!dispatchingClient)
+        return;
+
+    auto client = WClientPrivate::get(dispatchingClient);
+    dispatchingClient = nullptr;
+    const qint64 time = end - requestStart;
+    client->dispatchStatistics.dispatchTime += time;
+
+    if (clientDispatchLimit <= 0)
+        return;
+
+    if (end - client->dispatchWindowStart > 1000000000ll) {
+        client->dispatchWindowStart = end;
+        client->dispatchWindowTime = 0;
+    }
+    client->dispatchWindowTime += time;
+    if (client->dispatchWindowTime > clientDispatchLimit * 1000000ll) {
+        client->dispatchWindowTime = 0;
+        client->throttle(100);
+    }
+}
+
 void WServerPrivate::initSocket(WSocket *socketServer)
 {
     bool ok = socketServer->listen(display->handle());
@@ -390,4 +514,32 @@ void WServer::setGlobalFilter(GlobalFilterFunc filter, void *data)
     d->globalFilterFuncData = data;
 }
 
+int WServer::dispatchBudget() const
+{
+    W_DC(WServer);
+    return d->dispatchBudget;
+}
+
+// The time in microseconds of one iteration of the client dispatch, beyond
+// it the next iteration waits for the pending Qt events, 0 is unlimited.
+void WServer::setDispatchBudget(int usecs)
+{
+    W_D(WServer);
+    d->dispatchBudget = std::max(usecs, 0);
+}
+
+int WServer::clientDispatchLimit() const
+{
+    W_DC(WServer);
+    return d->clientDispatchLimit;
+}
+
+// The time in milliseconds per second a client can take in its request
+// handlers, beyond it the client is frozen for a while, 0 is unlimited.
+void WServer::setClientDispatchLimit(int msecs)
+{
+    W_D(WServer);
+    d->clientDispatchLimit = std::max(msecs, 0);
+}
+
 WAYLIB_SERVER_END_NAMESPACE
@@ -142,6 +142,11 @@ public:
 
     void setGlobalFilter(GlobalFilterFunc filter, void *data);
 
+    int dispatchBudget() const;
+    void setDispatchBudget(int usecs);
+    int clientDispatchLimit() const;
+    void setClientDispatchLimit(int msecs);
+
 Q_SIGNALS:
     void started();
 
@@ -2,9 +2,10 @@
 // SPDX-License-Identifier: Apache-2.0 OR LGPL-3.0-only OR GPL-2.0-only OR GPL-3.0-only
 
 #include "wsocket.h"
-#include "private/wglobal_p.h"
+#include "private/wsocket_p.h"
 
 #include <QDir>
+#include <QTimer>
 #include <QStandardPaths>
 #include <QStringDecoder>
 #include <QPointer>
@@ -268,41 +269,65 @@ void WSocketPrivate::addClient(WClient *client)
     Q_EMIT q->clientsChanged();
 }
 
-class Q_DECL_HIDDEN WClientPrivate : public WObjectPrivate
+WClientPrivate::WClientPrivate(wl_client *handle, WSocket *socket, WClient *qq, bool isWlClientOwned)
+    : WObjectPrivate(qq)
+    , handle(handle)
+    , socket(socket)
+    , isWlClientOwned(isWlClientOwned)
 {
-public:
-    WClientPrivate(wl_client *handle, WSocket *socket, WClient *qq, bool isWlClientOwned)
-        : WObjectPrivate(qq)
-        , handle(handle)
-        , socket(socket)
-        , isWlClientOwned(isWlClientOwned)
-    {
-        auto listener = new WlClientDestroyListener(qq);
-        wl_client_add_destroy_listener(handle, &listener->destroy);
-        wl_client_add_destroy_late_listener(handle, &listener->destroy_late);
-    }
+    auto listener = new WlClientDestroyListener(qq);
+    wl_client_add_destroy_listener(handle, &listener->destroy);
+    wl_client_add_destroy_late_listener(handle, &listener->destroy_late);
+}
 
-    ~WClientPrivate() {
-        if (pidFD >= 0)
-            close(pidFD);
+WClientPrivate::~WClientPrivate()
+{
+    if (pidFD >= 0)
+        close(pidFD);
 
-        if (handle) {
-            auto listener = WlClientDestroyListener::get(handle);
-            if (!listener)
-                listener = WlClientDestroyListener::get_late(handle);
-            Q_ASSERT(listener);
-            delete listener;
-        }
+    // The throttle timer is destroyed with the client
+    resumeThrottled();
+
+    if (handle) {
+        auto listener = WlClientDestroyListener::get(handle);
+        if (!listener)
+            listener = WlClientDestroyListener::get_late(handle);
+        Q_ASSERT(listener);
+        delete listener;
     }
+}
+
+void WClientPrivate::throttle(int msecs)
+{
+    if (throttled || !throttlable || !handle)
+        return;
 
-    W_DECLARE_PUBLIC(WClient)
+    W_Q(WClient);
+    // Never stop the compositor itself, e.g. the clients created by socketpair
+    if (q->credentials()->pid == getpid())
+        return;
 
-    wl_client *handle = nullptr;
-    WSocket *socket = nullptr;
-    mutable QSharedPointer<WClient::Credentials> credentials;
-    mutable int pidFD = -1;
-    bool isWlClientOwned = true;
-};
+    if (!pauseClient(handle, true))
+        return;
+
+    throttled = true;
+    ++dispatchStatistics.throttles;
+    qCInfo(waylibSocket) << "Throttle the client" << q->credentials()->pid << "for" << msecs << "ms";
+    Q_EMIT q->throttledChanged();
+
+    QTimer::singleShot(msecs, q, [this] {
+        throttled = false;
+        if (handle && !frozen)
+            pauseClient(handle, false);
+        Q_EMIT q_func()->throttledChanged();
+    });
+}
+
+void WClientPrivate::resumeThrottled()
+{
+    if (handle && throttled && !frozen)
+        pauseClient(handle, false);
+}
 
 void WlClientDestroyListener::handle_destroy(wl_listener *listener, void *data)
 {
@@ -316,6 +341,8 @@ void WlClientDestroyListener::handle_destroy(wl_listener *listener, void *data)
         // WClient deletion is still deferred to handle_destroy_late until resources are destroyed.
         WSocketPrivate *socketPrivate = WSocketPrivate::get(socket);
         socketPrivate->clients.removeOne(client);
+        // The throttle timer can't resume the process without the handle
+        client->d_func()->resumeThrottled();
         client->d_func()->handle = nullptr;
     }
 }
@@ -394,6 +421,36 @@ WClient *WClient::get(const wl_client *client)
     return nullptr;
 }
 
+WClient::DispatchStatistics WClient::dispatchStatistics() const
+{
+    W_DC(WClient);
+    return d->dispatchStatistics;
+}
+
+bool WClient::isThrottled() const
+{
+    W_DC(WClient);
+    return d->throttled;
+}
+
+bool WClient::isThrottlable() const
+{
+    W_DC(WClient);
+    return d->throttlable;
+}
+
+void WClient::setThrottlable(bool throttlable)
+{
+    W_D(WClient);
+    d->throttlable = throttlable;
+    if (throttlable || !d->throttled)
+        return;
+
+    // The throttle timer only clears the state now
+    if (d->handle && !d->frozen)
+        pauseClient(d->handle, false);
+}
+
 QByteArray WClient::sandboxEngine() const
 {
     W_DC(WClient);
@@ -415,13 +472,17 @@ QByteArray WClient::instanceId() const
 void WClient::freeze()
 {
     W_D(WClient);
+    d->frozen = true;
     pauseClient(d->handle, true);
 }
 
 void WClient::activate()
 {
     W_D(WClient);
-    pauseClient(d->handle, false);
+    d->frozen = false;
+    // Resumed at the end of the throttling
+    if (!d->throttled)
+        pauseClient(d->handle, false);
 }
 
 WSocket::WSocket(bool freezeClientWhenDisable, QObject *parent)
@@ -788,6 +849,7 @@ void WSocketPrivate::doRemoveClient(WClient *client)
 
     auto handle = client->handle();
     if (handle && client->d_func()->isWlClientOwned) {
+        client->d_func()->resumeThrottled();
         // Set handle to nullptr to prevent handle_destroy from calling removeClient again
         client->d_func()->handle = nullptr;
         delete client;
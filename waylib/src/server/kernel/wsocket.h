@@ -22,6 +22,7 @@ class WAYLIB_SERVER_EXPORT WClient : public QObject, public WObject
     Q_PROPERTY(QByteArray sandboxEngine READ sandboxEngine CONSTANT FINAL)
     Q_PROPERTY(QByteArray appId READ appId CONSTANT FINAL)
     Q_PROPERTY(QByteArray instanceId READ instanceId CONSTANT FINAL)
+    Q_PROPERTY(bool throttled READ isThrottled NOTIFY throttledChanged FINAL)
     // Using for QQmlListProperty
     QML_ANONYMOUS
 
@@ -45,10 +46,30 @@ public:
     QByteArray appId() const;
     QByteArray instanceId() const;
 
+    struct DispatchStatistics {
+        quint64 requests = 0;
+        // the bytes of the requests on the wire, not including the fds
+        quint64 requestBytes = 0;
+        quint64 events = 0;
+        // the time spent in the request handlers, in nanoseconds
+        qint64 dispatchTime = 0;
+        // the times frozen by WServer::clientDispatchLimit
+        quint32 throttles = 0;
+    };
+    DispatchStatistics dispatchStatistics() const;
+    bool isThrottled() const;
+    // A client not throttlable is never frozen by WServer::clientDispatchLimit,
+    // e.g. Xwayland and the helper processes of the compositor
+    bool isThrottlable() const;
+    void setThrottlable(bool throttlable);
+
 public Q_SLOTS:
     void freeze();
     void activate();
 
+Q_SIGNALS:
+    void throttledChanged();
+
 private:
     friend class WSocket;
     friend class WSocketPrivate;
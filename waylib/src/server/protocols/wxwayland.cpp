@@ -341,7 +341,9 @@ void WXWayland::create(WServer *server)
 
     auto s = qw_xwayland_server::from(handle->handle()->server);
     QObject::connect(s, &qw_xwayland_server::notify_start, this, [d] {
-        d->socket->addClient(d->waylandClient(), false);
+        // Freezing Xwayland would stall all X11 windows
+        if (auto client = d->socket->addClient(d->waylandClient(), false))
+            client->setThrottlable(false);
     });
 }
 
@@ -88,6 +88,8 @@ WBufferRenderer::WBufferRenderer(QQuickItem *parent)
     : QQuickItem(parent)
     , m_cacheBuffer(true)
     , m_hideSource(false)
+    , m_hasDamageHint(false)
+    , m_hasUnfinishedRender(false)
 {
     // ensure graphical resources are released before scene graph is invalidated
     // since WBufferRenderer's ItemHasContent bit is unset
@@ -275,6 +277,11 @@ qw_damage_ring *WBufferRenderer::damageRing()
     return &m_damageRing;
 }
 
+const WOutputRenderWindow::DamageStatistics &WBufferRenderer::damageStatistics() const
+{
+    return m_damageStatistics;
+}
+
 bool WBufferRenderer::isTextureProvider() const
 {
     return true;
@@ -299,9 +306,20 @@ WSGTextureProvider *WBufferRenderer::wTextureProvider() const
         m_textureProvider->setBuffer(m_lastBuffer);
     }
 
+    m_textureProviderIdleFrames = 0;
     return m_textureProvider.get();
 }
 
+bool WBufferRenderer::hasTextureConsumers() const
+{
+    if (!m_textureProvider)
+        return false;
+
+    // The pollers (e.g. the screen capture) query the provider after the
+    // render of every frame, so a query in the previous frame is alive.
+    return m_textureProvider->isConnected() || m_textureProviderIdleFrames <= 1;
+}
+
 QTransform WBufferRenderer::inputMapToOutput(const QRectF &sourceRect, const QRectF &targetRect,
                                              const QSize &pixelSize, const qreal devicePixelRatio)
 {
@@ -337,6 +355,10 @@ qw_buffer *WBufferRenderer::beginRender(const QSize &pixelSize, qreal devicePixe
     if (pixelSize.isEmpty())
         return nullptr;
 
+    // The commands of the last frame are completed by QRhi::endOffscreenFrame
+    m_hasUnfinishedRender = false;
+    if (m_textureProviderIdleFrames < 2)
+        ++m_textureProviderIdleFrames;
     Q_EMIT beforeRendering();
 
     // configure swapchain
@@ -364,7 +386,7 @@ qw_buffer *WBufferRenderer::beginRender(const QSize &pixelSize, qreal devicePixe
             return nullptr;
     }
 
-    // TODO: Support scanout buffer of wlr_surface(from WSurfaceItem)
+    // The scanout of the client's buffer is done by OutputHelper::tryScanout
     auto wbuffer = m_swapchain->acquire();
     if (!wbuffer)
         return nullptr;
@@ -420,6 +442,8 @@ qw_buffer *WBufferRenderer::beginRender(const QSize &pixelSize, qreal devicePixe
     state.flags = flags;
     state.context = wd->context;
     state.pixelSize = pixelSize;
+    const int bitsPerPixel = QImage::toPixelFormat(WTools::toImageFormat(format)).bitsPerPixel();
+    state.bytesPerPixel = bitsPerPixel > 0 ? bitsPerPixel / 8 : 4;
     state.devicePixelRatio = devicePixelRatio;
     state.buffer.reset(buffer);
     state.renderTarget = rt;
@@ -428,6 +452,13 @@ qw_buffer *WBufferRenderer::beginRender(const QSize &pixelSize, qreal devicePixe
     return buffer;
 }
 
+inline static quint64 regionArea(const QRegion &region) {
+    quint64 area = 0;
+    for (const QRect &r : region)
+        area += quint64(r.width()) * r.height();
+    return area;
+}
+
 inline static QRect scaleToRect(const QRectF &s, qreal scale) {
     return QRect((s.topLeft() * scale).toPoint(),
                  (s.size() * scale).toSize());
@@ -575,17 +606,33 @@ void WBufferRenderer::render(int sourceIndex, const QMatrix4x4 &renderMatrix,
 
     { // after render
         if (!softwareRenderer) {
-            // TODO: get damage area from QRhi renderer
-            m_damageRing.add_whole();
-            // ###: maybe Qt bug? Before executing QRhi::endOffscreenFrame, we may
-            // use the same QSGRenderer for multiple drawings. This can lead to
-            // rendering the same content for different QSGRhiRenderTarget instances
-            // when using the RhiGles backend. Additionally, considering that the
-            // result of the current drawing may be needed when drawing the next
-            // sourceIndex, we should let the RHI (Rendering Hardware Interface)
-            // complete the results of this drawing here to ensure the current
-            // drawing result is available for use.
-            wd->rhi->finish();
+            // The QRhi renderer can't report the damage area, it's provided by
+            // the WOutputRenderWindow from the dirty items of the scene.
+            const quint64 bufferArea = quint64(state.pixelSize.width()) * state.pixelSize.height();
+            if (m_hasDamageHint) {
+                WPixmanRegion damage;
+                bool ok = WTools::toPixmanRegion(m_damageHint, damage);
+                Q_ASSERT(ok);
+                m_damageRing.add(damage);
+                m_damageStatistics.damagedBytes += regionArea(m_damageHint) * state.bytesPerPixel;
+                m_damageHint = QRegion();
+                m_hasDamageHint = false;
+            } else {
+                m_damageRing.add_whole();
+                m_damageStatistics.damagedBytes += bufferArea * state.bytesPerPixel;
+            }
+            m_damageStatistics.renderedBytes += bufferArea * state.bytesPerPixel;
+            // The commands are completed by QRhi::endOffscreenFrame at the end of the
+            // frame. Only wait here if the result is used by the texture provider in
+            // this frame, QRhi can't track this dependency because the texture is
+            // imported from the buffer again. The readers of the render target in the
+            // next sourceIndex will call waitForRender.
+            if (hasTextureConsumers()) {
+                wd->rhi->finish();
+                m_hasUnfinishedRender = false;
+            } else {
+                m_hasUnfinishedRender = true;
+            }
         } else {
             state.dirty = softwareRenderer->flushRegion();
 
@@ -617,6 +664,9 @@ void WBufferRenderer::render(int sourceIndex, const QMatrix4x4 &renderMatrix,
             if (!isRootItem(source.source))
                 applyTransform(softwareRenderer, state.worldTransform.inverted().toTransform());
             m_damageRing.add(scaledFlushDamage);
+            const quint64 flushBytes = regionArea(scaledFlushRegion) * state.bytesPerPixel;
+            m_damageStatistics.damagedBytes += flushBytes;
+            m_damageStatistics.renderedBytes += flushBytes;
         }
     }
 
@@ -625,8 +675,10 @@ void WBufferRenderer::render(int sourceIndex, const QMatrix4x4 &renderMatrix,
         dr->currentFrameCommandBuffer()->resourceUpdate(resourceUpdates);
     }
 
-    if (shouldCacheBuffer())
-        wTextureProvider()->setBuffer(state.buffer.get());
+    // Don't create the texture provider if nobody uses it, it will get the
+    // last buffer when it's created.
+    if (m_textureProvider && shouldCacheBuffer())
+        m_textureProvider->setBuffer(state.buffer.get());
 }
 
 void WBufferRenderer::endRender()
@@ -641,6 +693,9 @@ void WBufferRenderer::endRender()
         m_lastBuffer = buffer.get();
     }
 
+    m_damageHint = QRegion();
+    m_hasDamageHint = false;
+
 #ifndef QT_NO_OPENGL
     auto wd = QQuickWindowPrivate::get(window());
     if (state.flags.testFlag(RedirectOpenGLContextDefaultFrameBufferObject)
@@ -654,6 +709,22 @@ void WBufferRenderer::endRender()
     Q_EMIT afterRendering();
 }
 
+void WBufferRenderer::waitForRender()
+{
+    if (!m_hasUnfinishedRender)
+        return;
+
+    m_hasUnfinishedRender = false;
+    QQuickWindowPrivate::get(window())->rhi->finish();
+}
+
+void WBufferRenderer::setDamageHint(const QRegion &damage)
+{
+    Q_ASSERT(state.buffer);
+    m_damageHint = damage;
+    m_hasDamageHint = true;
+}
+
 void WBufferRenderer::componentComplete()
 {
     QQuickItem::componentComplete();
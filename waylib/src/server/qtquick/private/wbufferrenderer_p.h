@@ -78,10 +78,19 @@ public:
     QRhiTexture *currentRenderTarget() const;
     const QW_NAMESPACE::qw_damage_ring *damageRing() const;
     QW_NAMESPACE::qw_damage_ring *damageRing();
+    const WOutputRenderWindow::DamageStatistics &damageStatistics() const;
+
+    // Wait for the commands of the previous render in the current frame,
+    // used by who reads the render target out of the current QRhi's
+    // command buffer, e.g. RenderBufferBlitter.
+    void waitForRender();
 
     bool isTextureProvider() const override;
     QSGTextureProvider *textureProvider() const override;
     WSGTextureProvider *wTextureProvider() const;
+    // Whether the rendered buffer is read by others in the current frame,
+    // the consumers either listen to the provider or poll it every frame.
+    bool hasTextureConsumers() const;
 
     static QTransform inputMapToOutput(const QRectF &sourceRect, const QRectF &targetRect,
                                        const QSize &pixelSize, const qreal devicePixelRatio);
@@ -100,6 +109,10 @@ protected:
                 const QRectF &sourceRect = {}, const QRectF &targetRect = {},
                 bool preserveColorContents = false);
     void endRender();
+    // The damage of the next render in buffer coordinates, only used to
+    // update the damage ring for the RHI renderer. If it's not set, the
+    // whole buffer is damaged.
+    void setDamageHint(const QRegion &damage);
     void componentComplete() override;
 
 private:
@@ -143,6 +156,7 @@ private:
         QQuickRenderTarget renderTarget;
         QSGRenderTarget sgRenderTarget;
         QRegion dirty;
+        int bytesPerPixel;
     } state;
 
     QPointer<WOutput> m_output;
@@ -155,11 +169,17 @@ private:
     QList<Data> m_sourceList;
     QW_NAMESPACE::qw_damage_ring m_damageRing;
     mutable std::unique_ptr<WSGTextureProvider> m_textureProvider;
+    // The frames rendered since the provider was last queried
+    mutable uint m_textureProviderIdleFrames = 2;
     QColor m_clearColor = Qt::transparent;
     QList<QObject*> m_cacheBufferLocker;
+    QRegion m_damageHint;
+    WOutputRenderWindow::DamageStatistics m_damageStatistics;
 
     uint m_cacheBuffer:1;
     uint m_hideSource:1;
+    uint m_hasDamageHint:1;
+    uint m_hasUnfinishedRender:1;
 };
 
 WAYLIB_SERVER_END_NAMESPACE
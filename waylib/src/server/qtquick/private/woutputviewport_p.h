@@ -71,6 +71,7 @@ public:
 
     W_DECLARE_PUBLIC(WOutputViewport)
     QList<WOutputViewport*> depends;
+    QPointer<WOutputViewport> mirrorSource;
 
     QQuickItem *input = nullptr;
     WOutput *output = nullptr;
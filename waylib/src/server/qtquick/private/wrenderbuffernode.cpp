@@ -14,6 +14,8 @@
 #include <QSGImageNode>
 #include <private/qquickitem_p.h>
 #include <private/qsgplaintexture_p.h>
+#include <private/qsgabstractsoftwarerenderer_p.h>
+#include <private/qsgsoftwarerenderablenode_p.h>
 #include <private/qrhi_p.h>
 #include <private/qrhivulkan_p.h>
 #include <private/qsgrenderer_p.h>
@@ -699,6 +701,10 @@ public:
         }
 
         const auto currentRenderer = maybeBufferRenderer();
+        // The render target is read by the other QRhi in render, ensure
+        // the previous render passes on it are finished.
+        if (currentRenderer)
+            currentRenderer->waitForRender();
         // TODO: Apple viewport to matrix, needs get QSGRenderer
         renderMatrix = currentRenderer
                            ? currentRenderer->currentWorldTransform() * (*this->matrix())
@@ -1024,34 +1030,10 @@ WRenderBufferNode *WRenderBufferNode::createRhiNode(QQuickItem *item)
     return node;
 }
 
-class Q_DECL_HIDDEN QImageManager : public DataManager<QImageManager, QImage, QImage::Format, const QSize&>
-{
-    Q_OBJECT
-
-    friend class DataManager;
-
-    QImageManager(QQuickWindow *owner)
-        : DataManager<QImageManager, QImage, QImage::Format, const QSize&>(owner) {
-        Q_ASSERT(owner->findChildren<QImageManager*>(Qt::FindDirectChildrenOnly).size() == 1);
-    }
-
-    static bool check(QImage *image, QImage::Format format, const QSize &size) {
-        return image->format() == format && image->size() == size;
-    }
-
-    QImage *create(QImage::Format format, const QSize &size) {
-        return new QImage(size, format);
-    }
-
-    static void destroy(QImage *image) {
-        delete image;
-    }
-};
-
 class Q_DECL_HIDDEN SoftwareNode : public WRenderBufferNode {
 public:
     SoftwareNode(QQuickItem *item)
-        : WRenderBufferNode(item, new QSGPlainTexture)
+        : WRenderBufferNode(item, new WRenderBufferImageTexture)
     {
         texture()->setOwnsTexture(false);
         // Ensuse always render on software renderer
@@ -1068,7 +1050,7 @@ public:
 
     QImage toImage() const override
     {
-        return image.expired() ? QImage() : *image.lock()->data;
+        return image;
     }
 
     void render([[maybe_unused]] const RenderState *state) override {
@@ -1084,16 +1066,6 @@ public:
         // const auto sgRenderer = currentRenderer ? currentRenderer->currentRenderer() : nullptr;
         const auto matrix = /*(sgRenderer && sgRenderer->renderTarget().paintDevice == p->device())
             ? currentRenderer->currentWorldTransform() * (*this->matrix()) :*/ *this->matrix();
-        const auto oldManager = manager;
-        manager = QImageManager::resolve(manager, window);
-
-        if (oldManager != manager) {
-            texture()->setTexture(nullptr);
-            if (oldManager)
-                oldManager->release(image);
-            image.reset();
-        }
-
         const bool hasRotation = matrix.flags().testAnyFlags(QMatrix4x4::Rotation2D | QMatrix4x4::Rotation);
         QSizeF size;
 
@@ -1127,60 +1099,122 @@ public:
             return;
         }
 
-        if (Q_UNLIKELY(sourceImage.isNull())) {
-            image = manager->resolve(image, QImage::Format_RGB30, pixelSize);
-        } else {
-            image = manager->resolve(image, sourceImage.format(), pixelSize);
+        // Not shared with the other nodes, it must keep the last frame of this node
+        const auto format = Q_UNLIKELY(sourceImage.isNull()) ? QImage::Format_RGB30 : sourceImage.format();
+        if (image.format() != format || image.size() != pixelSize) {
+            texture()->setImage(QImage());
+            image = QImage(pixelSize, format);
+            lastRenderer = nullptr;
         }
 
-        auto image = this->image.lock();
-        painter.begin(image->data);
-        painter.setRenderHint(QPainter::SmoothPixmapTransform);
-        painter.setCompositionMode(QPainter::CompositionMode_Source);
         auto transform = matrix.toTransform().inverted();
         QTransform resetPos;
         resetPos.translate((dpr - 1) * transform.dx(),
                            (dpr - 1) * transform.dy());
-        painter.setTransform(transform * resetPos);
+        transform *= resetPos;
+
+        // The image keeps the contents of the previous frame, only copy the
+        // area repainted behind this node in the current frame.
+        QRegion copyRegion;
+        // The scene behind this node is different on every output
+        const auto bufferRenderer = window->currentRenderer();
+        const bool copyAll = !bufferRenderer || bufferRenderer != lastRenderer || transform != lastTransform
+                             || sourceImage.isNull() || !repaintedRegion(device, &copyRegion);
+        lastRenderer = bufferRenderer;
+        lastTransform = transform;
+
+        if (!copyAll) {
+            // To the pixels of the source image
+            const qreal sourceDpr = device->devicePixelRatio();
+            QRegion pixelRegion;
+            const int margin = transform.type() > QTransform::TxTranslate ? 1 : 0;
+            for (const QRect &r : copyRegion) {
+                const QRectF pixelRect(QPointF(r.topLeft()) * sourceDpr, QSizeF(r.size()) * sourceDpr);
+                pixelRegion += pixelRect.toAlignedRect().adjusted(-margin, -margin, margin, margin);
+            }
+            copyRegion = pixelRegion & sourceImage.rect();
+            // Nothing is changed behind this node
+            if (copyRegion.isEmpty())
+                return;
+        }
+
+        // Release the reference of the texture, avoid to detach the whole image
+        texture()->setImage(QImage());
+
+        painter.begin(&image);
+        painter.setRenderHint(QPainter::SmoothPixmapTransform);
+        painter.setCompositionMode(QPainter::CompositionMode_Source);
+        painter.setTransform(transform);
 
-        // TODO: copy damage area from the previous frame
         if (Q_UNLIKELY(sourceImage.isNull())) {
             painter.drawPixmap(sourcePixmap.rect(), sourcePixmap, sourcePixmap.rect());
         } else {
+            if (!copyAll)
+                painter.setClipRegion(copyRegion);
             painter.drawImage(sourceImage.rect(), sourceImage, sourceImage.rect());
         }
 
         painter.end();
 
-        texture()->setImage(*image->data);
+        // For the readers of the texture, e.g. the blur only blurs this area again
+        QRegion changedRegion;
+        if (copyAll) {
+            changedRegion = image.rect();
+        } else {
+            for (const QRect &r : std::as_const(copyRegion))
+                changedRegion += transform.mapRect(QRectF(r)).toAlignedRect();
+            changedRegion &= image.rect();
+        }
+
+        texture()->setImage(image);
+        texture()->setChangedRegion(changedRegion);
         // Ensuse always render on software renderer
         texture()->setHasAlphaChannel(true);
         doNotifyTextureChanged();
     }
 
 private:
-    inline QSGPlainTexture *texture() const {
-        return static_cast<QSGPlainTexture*>(m_texture.get());
+    inline WRenderBufferImageTexture *texture() const {
+        return static_cast<WRenderBufferImageTexture*>(m_texture.get());
+    }
+
+    // The region of the render target repainted in the current frame before
+    // this node, returns false if it's unknown.
+    bool repaintedRegion(QPaintDevice *device, QRegion *region) const {
+        auto currentRenderer = renderWindow()->currentRenderer();
+        auto sgRenderer = currentRenderer ? currentRenderer->currentRenderer() : nullptr;
+        auto softwareRenderer = dynamic_cast<QSGAbstractSoftwareRenderer*>(sgRenderer);
+        if (!softwareRenderer || softwareRenderer->renderTarget().paintDevice != device)
+            return false;
+
+        auto renderableNode = softwareRenderer->renderableNode(const_cast<SoftwareNode*>(this));
+        if (!renderableNode)
+            return false;
+
+        *region = renderableNode->dirtyRegion();
+        return true;
     }
 
     void reset(bool notifyTexture = true) {
+        lastRenderer = nullptr;
         if (!texture()->image().isNull() && notifyTexture)
             doNotifyTextureChanged();
         texture()->setTexture(nullptr);
-        if (manager)
-            manager->release(image);
-        image.reset();
+        texture()->setImage(QImage());
+        texture()->setChangedRegion(QRegion());
+        image = QImage();
     }
 
     void destroy() {
         reset(false);
-        manager = nullptr;
     }
 
     friend class WRenderBufferNode;
-    DataManagerPointer<QImageManager> manager;
-    std::weak_ptr<QImageManager::Data> image;
+    QImage image;
     QPainter painter;
+    // the output renderer and transform of the last copy
+    QPointer<WBufferRenderer> lastRenderer;
+    QTransform lastTransform;
 };
 
 WRenderBufferNode *WRenderBufferNode::createSoftwareNode(QQuickItem *item)
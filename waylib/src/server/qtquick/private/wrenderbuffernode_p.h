@@ -8,6 +8,9 @@
 #include <QPointer>
 #include <QImage>
 #include <QSGDynamicTexture>
+#include <QRegion>
+
+#include <private/qsgplaintexture_p.h>
 
 QT_BEGIN_NAMESPACE
 class QQuickItem;
@@ -17,6 +20,32 @@ QT_END_NAMESPACE
 WAYLIB_SERVER_BEGIN_NAMESPACE
 
 class WOutputRenderWindow;
+// The texture of WRenderBufferNode on the software renderer, the image keeps
+// the contents of the previous frame and every update repaints a part of it.
+class WAYLIB_SERVER_EXPORT WRenderBufferImageTexture : public QSGPlainTexture {
+    Q_OBJECT
+public:
+    WRenderBufferImageTexture() = default;
+
+    // Increased by every update of the image
+    inline quint64 serial() const {
+        return m_serial;
+    }
+    // The area changed by the update of serial(), in the pixels of the image
+    inline const QRegion &changedRegion() const {
+        return m_changedRegion;
+    }
+
+    inline void setChangedRegion(const QRegion &region) {
+        m_changedRegion = region;
+        ++m_serial;
+    }
+
+private:
+    quint64 m_serial = 0;
+    QRegion m_changedRegion;
+};
+
 class WAYLIB_SERVER_EXPORT WRenderBufferNode : public QSGRenderNode {
 public:
     inline QSizeF size() const {
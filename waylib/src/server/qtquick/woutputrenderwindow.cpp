@@ -15,6 +15,7 @@
 #include "weventjunkman.h"
 #include "winputdevice.h"
 #include "wseat.h"
+#include "wsurfaceitem.h"
 
 #include "platformplugin/qwlrootsintegration.h"
 #include "platformplugin/qwlrootscreen.h"
@@ -39,6 +40,7 @@
 #include <QOpenGLFunctions>
 #include <QLoggingCategory>
 #include <QRunnable>
+#include <QMetaProperty>
 #include <qlogging.h>
 #include <memory>
 
@@ -65,10 +67,15 @@ extern "C" {
 #include <wlr/render/vulkan.h>
 #endif
 #include <wlr/render/gles2.h>
+#include <wlr/render/pass.h>
+#include <wlr/render/wlr_texture.h>
+#include <wlr/util/transform.h>
 }
 
 #include <drm_fourcc.h>
 #include <limits>
+#include <array>
+#include <ctime>
 
 using QQuickAnimCtrl_AnimRoots_t = QHash<QAbstractAnimationJob *, QSharedPointer<QAbstractAnimationJob>>;
 W_DECLARE_PRIVATE_MEMBER(QQuickAnimCtrl_m_animationRoots_tag, QQuickAnimatorController, m_animationRoots, QQuickAnimCtrl_AnimRoots_t);
@@ -86,23 +93,54 @@ Q_LOGGING_CATEGORY(wlcRenderer, "waylib.server.renderer", QtDebugMsg)
 Q_LOGGING_CATEGORY(wlcRenderer, "waylib.server.renderer", QtWarningMsg)
 #endif
 
-// Call it before any wlroots render to clean up the GL state in Qt.
-// If you don't do this, there will be tearing, flickering and other graphics problems
-inline static void resetGlState()
+static inline qint64 monotonicNsecs()
 {
-#ifndef QT_NO_OPENGL
-    // Clear OpenGL state for wlroots, the states is set by Qt, But it is will
-    // effect to wlroots's gles renderer.
-    if (WRenderHelper::getGraphicsApi() == QSGRendererInterface::OpenGL) {
-        // If not reset, you will get a warning from Mesa(enable MESA_DEBUG):
-        // Mesa: warning: Received negative int32 vertex buffer offset. (driver limitation)
-        glBindBuffer(GL_ARRAY_BUFFER, GL_NONE);
-        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, GL_NONE);
-        glDisable(GL_DEPTH_TEST);
-    }
-#endif
+    timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return qint64(now.tv_sec) * 1000000000 + now.tv_nsec;
 }
 
+// The timing of the last frames of an output, the slots are preallocated to
+// not allocate or lock in rendering.
+class Q_DECL_HIDDEN FrameTimingRing
+{
+public:
+    using FrameTiming = WOutputRenderWindow::FrameTiming;
+    static constexpr int Capacity = 256;
+
+    inline FrameTiming &append(const FrameTiming &timing) {
+        auto &slot = m_frames[m_count % Capacity];
+        slot = timing;
+        ++m_count;
+        return slot;
+    }
+
+    // The presentation feedback is for one of the last frames, search from the newest
+    FrameTiming *find(quint32 commitSeq) {
+        const int size = static_cast<int>(std::min<quint64>(m_count, Capacity));
+        for (int i = 1; i <= size; ++i) {
+            auto &frame = m_frames[(m_count - i) % Capacity];
+            if (frame.commitSeq == commitSeq && frame.state != FrameTiming::CommitFailed)
+                return &frame;
+        }
+        return nullptr;
+    }
+
+    QList<FrameTiming> last(int maxCount) const {
+        const int size = static_cast<int>(std::min<quint64>(m_count, Capacity));
+        const int count = maxCount < 0 ? size : std::min(size, maxCount);
+        QList<FrameTiming> frames;
+        frames.reserve(count);
+        for (int i = count; i > 0; --i)
+            frames.append(m_frames[(m_count - i) % Capacity]);
+        return frames;
+    }
+
+private:
+    std::array<FrameTiming, Capacity> m_frames;
+    quint64 m_count = 0;
+};
+
 class Q_DECL_HIDDEN BufferRendererProxy : public WQuickTextureProxy
 {
 public:
@@ -177,7 +215,7 @@ public:
         : WOutputHelper(output->output(), contentIsDirty, parent)
         , m_output(output)
     {
-
+        connect(qwoutput(), &qw_output::notify_present, this, &OutputHelper::onPresent);
     }
 
     ~OutputHelper()
@@ -218,11 +256,61 @@ public:
         return m_layers;
     }
 
+    // All requests from outside of the scene graph can't know the damage
+    // area, so damage the whole buffer. WOutputHelper::update is not virtual,
+    // use it directly when only the damage collected by the scene is needed.
+    inline void fullUpdate() {
+        m_wholeDamage = true;
+        WOutputHelper::update();
+    }
+
+    void addSceneDamage(const QRegion &damage);
+    void applyDamage(WBufferRenderer *renderer);
+
+    static bool disableDirectScanout() {
+        static bool on = qEnvironmentVariableIsSet("WAYLIB_DISABLE_DIRECT_SCANOUT");
+        return on;
+    }
+
+    // Attach the client's buffer to the output state if it covers the whole output,
+    // returns false if the scene needs to be rendered.
+    bool tryScanout();
+    inline const WOutputRenderWindow::ScanoutStatistics &scanoutStatistics() const {
+        return m_scanoutStatistics;
+    }
+
+    static bool disableMirror() {
+        static bool on = qEnvironmentVariableIsSet("WAYLIB_DISABLE_MIRROR");
+        return on;
+    }
+
+    // Show the buffer committed by the mirror source of the output, returns
+    // false if the scene needs to be rendered. Nothing to commit if the source
+    // has not committed a new buffer since the last frame.
+    bool tryMirror();
+    // Render the scene again if the output shows the buffer of the source
+    void mirrorSourceDetached(OutputHelper *source);
+
+    inline WOutputRenderWindow::FrameTiming &frameTiming() {
+        return m_frameTiming;
+    }
+    inline QList<WOutputRenderWindow::FrameTiming> frameTimings(int maxCount) const {
+        return m_frameTimings.last(maxCount);
+    }
+
+    inline void resetState() {
+        m_scanoutBuffer = nullptr;
+        m_mirrorBuffer = nullptr;
+        WOutputHelper::resetState();
+    }
+
     inline void invalidate() {
         m_output = nullptr;
         cleanLayerCompositor();
         cleanCursorRender();
         qDeleteAll(m_layers);
+        delete m_mirrorSwapchain;
+        m_mirrorSwapchain = nullptr;
     }
 
     inline qreal devicePixelRatio() const {
@@ -257,6 +345,16 @@ public:
     bool tryToHardwareCursor(const LayerData *layer);
 
 private:
+    bool commitBuffer(WBufferRenderer *buffer);
+    void onPresent(wlr_output_event_present *event);
+    QRectF mapToBuffer(QQuickItem *item, const QRectF &rect) const;
+    QQuickItem *topmostItem(QQuickItem *item, const QRect &bufferRect, bool isRoot) const;
+    WSurfaceItemContent *scanoutCandidate() const;
+    void cancelScanout();
+    qw_buffer *blitMirror(qw_buffer *source, wl_output_transform sourceTransform);
+    bool stopMirror();
+    void setFrontBuffer(qw_buffer *buffer);
+
     WOutputViewport *m_output = nullptr;
     QList<LayerData*> m_layers;
     WBufferRenderer *m_lastCommitBuffer = nullptr;
@@ -266,6 +364,33 @@ private:
     bool m_cursorDirty = false;
     bool m_hardwareCursorRenderComplete = false;
 
+    // damage in the buffer coordinates since the last render
+    QRegion m_damage;
+    bool m_wholeDamage = true;
+
+    // the client's buffer to commit instead of the rendered buffer
+    QPointer<qw_buffer> m_scanoutBuffer;
+    QPointer<WSurfaceItemContent> m_lastScanoutContent;
+    WOutputRenderWindow::ScanoutStatistics m_scanoutStatistics;
+
+    // the buffer committed last time, it's shown by the outputs mirroring this one
+    QPointer<qw_buffer> m_frontBuffer;
+    quint64 m_frontSerial = 0;
+    // the buffer of the mirror source to commit instead of the rendered buffer
+    QPointer<qw_buffer> m_mirrorBuffer;
+    // for the copy of the mirror source
+    qw_swapchain *m_mirrorSwapchain = nullptr;
+    // the front buffer of the source shown by this output
+    QPointer<OutputHelper> m_mirroredSource;
+    quint64 m_mirroredSerial = 0;
+    QPointer<OutputHelper> m_pendingMirroredSource;
+    quint64 m_pendingMirroredSerial = 0;
+    bool m_mirroring = false;
+
+    // the frame in rendering, is moved to m_frameTimings when committing
+    WOutputRenderWindow::FrameTiming m_frameTiming;
+    FrameTimingRing m_frameTimings;
+
     // for compositeLayers
     QPointer<WOutputViewport> m_output2;
     QPointer<QQuickItem> m_layerPorxyContainer;
@@ -379,6 +504,206 @@ public:
     QWindow *m_renderWindow = nullptr;
 };
 
+class Q_DECL_HIDDEN SceneDamageCollector
+{
+public:
+    static bool disabled() {
+        static bool on = qEnvironmentVariableIsSet("WAYLIB_DISABLE_SCENE_DAMAGE");
+        return on;
+    }
+
+    // Collect the damage of the dirty items in the scene coordinates, must call
+    // it before QQuickRenderControl::sync. Returns false if can't know the damage
+    // area, in this case the whole scene should be repainted.
+    bool collect(QQuickWindowPrivate *wd, const QSet<QQuickItem*> &renderSources,
+                 const QSet<QQuickItem*> &layerSources, QRegion *damage);
+
+private:
+    enum class Owner {
+        Scene,
+        Layer,
+        Unknown,
+    };
+
+    struct ItemRect {
+        QRectF rect;
+        // false if the item maybe draw outside of the rect
+        bool exact = true;
+    };
+
+    Owner ownerOf(QQuickItem *item, const QSet<QQuickItem*> &renderSources,
+                  const QSet<QQuickItem*> &layerSources) const;
+    QRectF paintedRect(QQuickItem *item, bool *exact);
+    ItemRect updateItemRect(QQuickItem *item);
+    void growAncestorRects(QQuickItem *item, const ItemRect &rect);
+
+    // the painted rect in the scene of the item and its children in the last frame,
+    // the rect of an item maybe larger than it, but never smaller
+    QHash<QQuickItem*, ItemRect> itemRects;
+    // the painted rects of the destroyed items
+    QRegion destroyedDamage;
+    // the index of the "boundingRect" property of the item types, -1 if not exists
+    QHash<const QMetaObject*, int> paintedRectProperties;
+};
+
+SceneDamageCollector::Owner SceneDamageCollector::ownerOf(QQuickItem *item,
+                                                          const QSet<QQuickItem*> &renderSources,
+                                                          const QSet<QQuickItem*> &layerSources) const
+{
+    for (auto i = item; i; i = i->parentItem()) {
+        auto d = QQuickItemPrivate::get(i);
+        if (!d->extra.isAllocated() || d->extra->effectRefCount == 0)
+            continue;
+        // The input of WOutputViewport is rendered in the same coordinates as the scene
+        if (renderSources.contains(i))
+            return Owner::Scene;
+        // It's drawn by the layer's WBufferRenderer, and the layer is damaged by itself
+        if (layerSources.contains(i))
+            return Owner::Layer;
+        // Maybe it's the source of ShaderEffectSource or WQuickTextureProxy,
+        // don't know where it's be drawn.
+        return Owner::Unknown;
+    }
+
+    return Owner::Scene;
+}
+
+QRectF SceneDamageCollector::paintedRect(QQuickItem *item, bool *exact)
+{
+    QRectF rect = item->boundingRect();
+
+    // The items like the shadow can declare the area they are drawn by a
+    // "boundingRect" property, e.g. XdgShadow.qml in treeland.
+    const QMetaObject *mo = item->metaObject();
+    auto it = paintedRectProperties.constFind(mo);
+    if (it == paintedRectProperties.constEnd()) {
+        int index = mo->indexOfProperty("boundingRect");
+        if (index >= 0 && mo->property(index).metaType() != QMetaType::fromType<QRectF>())
+            index = -1;
+        it = paintedRectProperties.insert(mo, index);
+    }
+
+    if (*it >= 0) {
+        rect |= mo->property(*it).read(item).toRectF();
+    } else if (item->inherits("QQuickShaderEffect")) {
+        // The vertex shader can move the vertices to anywhere
+        *exact = false;
+    }
+
+    return rect;
+}
+
+SceneDamageCollector::ItemRect SceneDamageCollector::updateItemRect(QQuickItem *item)
+{
+    ItemRect rect;
+
+    if (item->isVisible()) {
+        if (item->flags().testFlag(QQuickItem::ItemHasContents))
+            rect.rect = item->mapRectToScene(paintedRect(item, &rect.exact));
+
+        auto d = QQuickItemPrivate::get(item);
+        for (auto child : std::as_const(d->childItems)) {
+            const auto childRect = updateItemRect(child);
+            rect.rect |= childRect.rect;
+            rect.exact &= childRect.exact;
+        }
+
+        if (item->clip()) {
+            const QRectF clipRect = item->mapRectToScene(item->clipRect());
+            // Nothing can be drawn outside of the clip rect
+            rect.rect = rect.exact ? rect.rect & clipRect : clipRect;
+            rect.exact = true;
+        }
+    }
+
+    auto it = itemRects.find(item);
+    if (it == itemRects.end()) {
+        itemRects.insert(item, rect);
+        QObject::connect(item, &QObject::destroyed, item->window(), [this, item] {
+            const ItemRect rect = itemRects.take(item);
+            if (!rect.rect.isEmpty())
+                destroyedDamage += rect.rect.toAlignedRect().adjusted(-1, -1, 1, 1);
+        });
+    } else {
+        *it = rect;
+    }
+
+    return rect;
+}
+
+// The rects of the ancestors include the rects of their children, if a child is
+// drawn in a new area, the ancestors must also cover it, otherwise the area is
+// not damaged when an ancestor is moved or hidden later.
+void SceneDamageCollector::growAncestorRects(QQuickItem *item, const ItemRect &rect)
+{
+    for (auto parent = item->parentItem(); parent; parent = parent->parentItem()) {
+        auto it = itemRects.find(parent);
+        if (it == itemRects.end())
+            continue;
+        it->rect |= rect.rect;
+        it->exact &= rect.exact;
+    }
+}
+
+bool SceneDamageCollector::collect(QQuickWindowPrivate *wd, const QSet<QQuickItem*> &renderSources,
+                                   const QSet<QQuickItem*> &layerSources, QRegion *damage)
+{
+    bool ok = true;
+
+    // The area of the destroyed items, their parents maybe not dirty
+    *damage += destroyedDamage;
+    destroyedDamage = QRegion();
+
+    for (auto item = wd->dirtyItemList; item; item = QQuickItemPrivate::get(item)->nextDirtyItem) {
+        auto d = QQuickItemPrivate::get(item);
+        const bool hideStateChanged = d->dirtyAttributes & (QQuickItemPrivate::HideReference
+                                                            | QQuickItemPrivate::EffectReference);
+        const auto owner = hideStateChanged ? Owner::Scene
+                                            : ownerOf(item, renderSources, layerSources);
+        // Always take the damage of the surface, otherwise it's accumulated
+        // when the surface is drawn by a layer.
+        auto content = qobject_cast<WSurfaceItemContent*>(item);
+        QRegion surfaceDamage;
+        const bool hasSurfaceDamage = content && content->takeDamage(&surfaceDamage);
+
+        if (owner == Owner::Layer)
+            continue;
+
+        auto it = itemRects.constFind(item);
+        // Don't know where the item was drawn in the last frame
+        const bool isNewItem = it == itemRects.constEnd();
+
+        // Only the buffer of the surface is changed, use the damage of the surface
+        if (hasSurfaceDamage && !isNewItem && owner == Owner::Scene
+            && d->dirtyAttributes == QQuickItemPrivate::Content) {
+            for (const QRect &r : std::as_const(surfaceDamage))
+                *damage += item->mapRectToScene(r).toAlignedRect().adjusted(-1, -1, 1, 1);
+            continue;
+        }
+
+        const ItemRect oldRect = isNewItem ? ItemRect() : *it;
+        // Always update the rect, ensure the damage is known in the next frame
+        const ItemRect newRect = updateItemRect(item);
+        growAncestorRects(item, newRect);
+
+        // Don't know where the item is drawn, e.g. a ShaderEffect without clip.
+        // The reparented item leaves the rects of its old ancestors, repaint all.
+        if (isNewItem || owner == Owner::Unknown || !oldRect.exact || !newRect.exact
+            || (d->dirtyAttributes & QQuickItemPrivate::ParentChanged))
+            ok = false;
+        if (!ok)
+            continue;
+
+        // Reserve a pixel for the antialiasing
+        if (!oldRect.rect.isEmpty())
+            *damage += oldRect.rect.toAlignedRect().adjusted(-1, -1, 1, 1);
+        if (!newRect.rect.isEmpty())
+            *damage += newRect.rect.toAlignedRect().adjusted(-1, -1, 1, 1);
+    }
+
+    return ok;
+}
+
 class Q_DECL_HIDDEN WOutputRenderWindowPrivate : public QQuickWindowPrivate
 {
 public:
@@ -440,6 +765,7 @@ public:
     bool initRCWithRhi();
     void updateSceneDPR();
     void sortOutputs();
+    void collectSceneDamage();
 
     QVector<std::pair<OutputHelper *, WBufferRenderer *>>
     doRenderOutputs(qw_output *needsFrameOutput, const QList<OutputHelper *> &outputs,
@@ -463,6 +789,19 @@ public:
         }
     }
 
+    inline void onSceneChanged() {
+        if (inRendering)
+            return;
+
+        if (SceneDamageCollector::disabled()) {
+            q_func()->update();
+        } else {
+            // The outputs will be marked dirty in collectSceneDamage if the
+            // dirty items is visible on it.
+            scheduleDoRender();
+        }
+    }
+
     Q_DECLARE_PUBLIC(WOutputRenderWindow)
 
     bool componentCompleted = true;
@@ -475,6 +814,7 @@ public:
     QList<OutputHelper*> outputs;
     QList<OutputLayer*> layers;
     bool disableLayers = false;
+    SceneDamageCollector sceneDamage;
 
     QOpenGLContext *glContext = nullptr;
 #ifdef ENABLE_VULKAN_RENDER
@@ -482,6 +822,12 @@ public:
 #endif
 
     QStack<WBufferRenderer*> rendererList;
+    // the root renderer is used in the current frame
+    bool rootRendererIsUsed = false;
+
+    // the timestamps of the stages shared by all outputs in the current frame
+    qint64 framePolishStart = 0;
+    qint64 frameSyncStart = 0;
 };
 
 WOutputRenderWindowPrivate *OutputHelper::renderWindowD() const
@@ -601,7 +947,18 @@ qw_buffer *OutputHelper::beginRender(WBufferRenderer *renderer,
 void OutputHelper::render(WBufferRenderer *renderer, int sourceIndex, const QMatrix4x4 &renderMatrix,
                           const QRectF &sourceRect, const QRectF &targetRect, bool preserveColorContents)
 {
-    renderWindowD()->pushRenderer(renderer);
+    auto d = renderWindowD();
+    // ###: maybe Qt bug? Before executing QRhi::endOffscreenFrame, using the
+    // same QSGRenderer for multiple drawings leads to rendering the same content
+    // for different QSGRhiRenderTarget instances when using the RhiGles backend.
+    // The renderer of the root item is shared by all WBufferRenderer.
+    if (renderer->isRootItem(renderer->m_sourceList.at(sourceIndex).source)) {
+        if (d->rootRendererIsUsed && d->rhi)
+            d->rhi->finish();
+        d->rootRendererIsUsed = true;
+    }
+
+    d->pushRenderer(renderer);
     renderer->render(sourceIndex, renderMatrix, sourceRect, targetRect, preserveColorContents);
 }
 
@@ -621,6 +978,338 @@ static inline QRectF scaleRect(const QRectF &r, qreal xScale, qreal yScale) {
     return QRectF(r.x() * xScale, r.y() * yScale, r.width() * xScale, r.height() * yScale);
 }
 
+void OutputHelper::addSceneDamage(const QRegion &damage)
+{
+    // Updated when the mirror source commits
+    if (m_mirroring)
+        return;
+
+    if (m_wholeDamage) {
+        WOutputHelper::update();
+        return;
+    }
+
+    const qreal dpr = devicePixelRatio();
+    const QRect bufferRect(QPoint(0, 0), output()->output()->size());
+    auto contentItem = renderWindow()->contentItem();
+    QRegion outputDamage;
+
+    for (const QRect &rect : damage) {
+        const auto mapRect = scaleRect(output()->mapToOutput(contentItem, rect), dpr, dpr);
+        outputDamage += mapRect.toAlignedRect() & bufferRect;
+    }
+
+    if (outputDamage.isEmpty())
+        return;
+
+    m_damage += outputDamage;
+    WOutputHelper::update();
+}
+
+void OutputHelper::applyDamage(WBufferRenderer *renderer)
+{
+    // The texture of the other WOutputViewport maybe changed, its damage is unknown
+    if (!m_wholeDamage && output()->depends().isEmpty())
+        renderer->setDamageHint(m_damage);
+
+    m_damage = QRegion();
+    m_wholeDamage = false;
+}
+
+QRectF OutputHelper::mapToBuffer(QQuickItem *item, const QRectF &rect) const
+{
+    const qreal dpr = devicePixelRatio();
+    return scaleRect(output()->mapToOutput(item, rect), dpr, dpr);
+}
+
+QQuickItem *OutputHelper::topmostItem(QQuickItem *item, const QRect &bufferRect, bool isRoot) const
+{
+    if (!item->isVisible() || qFuzzyIsNull(item->opacity()))
+        return nullptr;
+
+    auto d = QQuickItemPrivate::get(item);
+    // The hidden items are rendered by the other renderer, e.g. the output layers
+    if (!isRoot && d->extra.isAllocated() && d->extra->hideRefCount > 0)
+        return nullptr;
+
+    const auto children = d->paintOrderChildItems();
+    for (auto i = children.crbegin(); i != children.crend(); ++i) {
+        if (auto top = topmostItem(*i, bufferRect, false))
+            return top;
+    }
+
+    if (item->flags() & QQuickItem::ItemHasContents
+        && mapToBuffer(item, item->boundingRect()).intersects(bufferRect)) {
+        return item;
+    }
+
+    return nullptr;
+}
+
+WSurfaceItemContent *OutputHelper::scanoutCandidate() const
+{
+    const QRect bufferRect(QPoint(0, 0), output()->output()->size());
+    QQuickItem *root = output()->input() ? output()->input() : renderWindow()->contentItem();
+    auto content = qobject_cast<WSurfaceItemContent*>(topmostItem(root, bufferRect, true));
+    if (!content)
+        return nullptr;
+
+    const auto transform = (output()->mapToViewport(content)
+                            * output()->sourceRectToTargetRectTransfrom()).toTransform();
+    if (transform.type() > QTransform::TxScale || transform.m11() <= 0 || transform.m22() <= 0)
+        return nullptr;
+
+    const QRectF targetRect(content->ignoreBufferOffset() ? QPointF() : content->bufferOffset(),
+                            content->size());
+    if (mapToBuffer(content, targetRect).toRect() != bufferRect)
+        return nullptr;
+
+    for (QQuickItem *i = content; i; i = i->parentItem()) {
+        if (i->opacity() < 1.0)
+            return nullptr;
+        if (i->clip() && !mapToBuffer(i, i->clipRect()).toAlignedRect().contains(bufferRect))
+            return nullptr;
+        if (i == root)
+            break;
+
+        // The item is used by ShaderEffectSource or the other effects
+        auto d = QQuickItemPrivate::get(i);
+        if (d->extra.isAllocated() && d->extra->effectRefCount > 0)
+            return nullptr;
+    }
+
+    return content;
+}
+
+bool OutputHelper::tryScanout()
+{
+    m_scanoutBuffer = nullptr;
+    if (disableDirectScanout() || output()->offscreen() || extraState())
+        return false;
+
+    auto viewportD = WOutputViewportPrivate::get(output());
+    if (!viewportD->depends.isEmpty() || viewportD->extraRenderSource
+        || viewportD->preserveColorContents)
+        return false;
+
+    // The rendered image of this output is used by others, e.g. the screen capture
+    if (bufferRenderer()->hasTextureConsumers())
+        return false;
+
+    if (qwoutput()->handle()->transform != WL_OUTPUT_TRANSFORM_NORMAL)
+        return false;
+
+    // The layers can't be composited on the client's buffer
+    for (LayerData *i : std::as_const(m_layers)) {
+        if (i->layer->isEnabled() && i->layer->needsComposite()
+            && !i->layer->layer->inOutputsByHardware().contains(output()))
+            return false;
+    }
+
+    auto content = scanoutCandidate();
+    auto buffer = content ? content->scanoutBuffer() : nullptr;
+    if (buffer && (buffer->handle()->width != output()->output()->size().width()
+                   || buffer->handle()->height != output()->output()->size().height())) {
+        buffer = nullptr;
+    }
+
+    if (!buffer) {
+        if (m_lastScanoutContent) {
+            qCDebug(wlcRenderer) << "Stop direct scanout of" << m_lastScanoutContent.get()
+                                 << "on" << output();
+            m_lastScanoutContent = nullptr;
+        }
+        return false;
+    }
+
+    ++m_scanoutStatistics.attempts;
+    if (!WOutputHelper::testCommit(buffer, {})) {
+        ++m_scanoutStatistics.failures;
+        m_lastScanoutContent = nullptr;
+        return false;
+    }
+
+    if (m_lastScanoutContent != content) {
+        qCDebug(wlcRenderer) << "Start direct scanout of" << content << "on" << output();
+        m_lastScanoutContent = content;
+    }
+
+    m_scanoutBuffer = buffer;
+    m_frameTiming.path = WOutputRenderWindow::FrameTiming::DirectScanout;
+    content->markScanout();
+    // The next rendering can't reuse the contents of the swapchain's buffers
+    m_wholeDamage = true;
+    m_damage = QRegion();
+
+    return true;
+}
+
+void OutputHelper::cancelScanout()
+{
+    Q_ASSERT(m_scanoutBuffer);
+    ++m_scanoutStatistics.failures;
+    m_lastScanoutContent = nullptr;
+    resetState();
+    fullUpdate();
+}
+
+bool OutputHelper::tryMirror()
+{
+    using FrameTiming = WOutputRenderWindow::FrameTiming;
+
+    m_mirrorBuffer = nullptr;
+    auto source = output()->mirrorSource();
+    if (!source || disableMirror() || output()->offscreen() || extraState())
+        return stopMirror();
+
+    auto sourceHelper = renderWindowD()->getOutputHelper(source);
+    if (!sourceHelper || !sourceHelper->m_frontBuffer)
+        return stopMirror();
+
+    // The rendered image of this output is used by others, e.g. the screen
+    // capture, the mirrored buffer wouldn't update the texture provider
+    if (bufferRenderer()->hasTextureConsumers())
+        return stopMirror();
+
+    // The layers can't be composited on the source's buffer
+    for (LayerData *i : std::as_const(m_layers)) {
+        if (i->layer->isEnabled() && i->layer->needsComposite()
+            && !i->layer->layer->inOutputsByHardware().contains(output()))
+            return stopMirror();
+    }
+
+    if (m_mirroring && m_mirroredSource == sourceHelper
+        && m_mirroredSerial == sourceHelper->m_frontSerial) {
+        return true;
+    }
+
+    qw_buffer *buffer = sourceHelper->m_frontBuffer;
+    const auto sourceTransform = sourceHelper->qwoutput()->handle()->transform;
+    const QSize bufferSize(buffer->handle()->width, buffer->handle()->height);
+    if (sourceTransform == qwoutput()->handle()->transform
+        && bufferSize == output()->output()->size()
+        && WOutputHelper::testCommit(buffer, {})) {
+        m_mirrorBuffer = buffer;
+        m_frameTiming.path = FrameTiming::MirrorShared;
+    } else if (auto copy = blitMirror(buffer, sourceTransform)) {
+        m_mirrorBuffer = copy;
+        m_frameTiming.path = FrameTiming::MirrorBlitted;
+    } else {
+        return stopMirror();
+    }
+
+    if (!m_mirroring) {
+        qCDebug(wlcRenderer) << "Start mirroring" << source << "on" << output();
+        m_mirroring = true;
+    }
+    m_pendingMirroredSource = sourceHelper;
+    m_pendingMirroredSerial = sourceHelper->m_frontSerial;
+    // The next rendering can't reuse the contents of the swapchain's buffers
+    m_wholeDamage = true;
+    m_damage = QRegion();
+
+    return true;
+}
+
+// Copy the source buffer to the center of the output in one render pass,
+// keeping the aspect ratio and the orientation shown on the source.
+qw_buffer *OutputHelper::blitMirror(qw_buffer *source, wl_output_transform sourceTransform)
+{
+    auto wOutput = output()->output();
+    const QSize size = wOutput->size();
+    if (!wOutput->configurePrimarySwapchain(size, qwoutput()->handle()->render_format,
+                                            &m_mirrorSwapchain, true)) {
+        return nullptr;
+    }
+
+    wlr_buffer *buffer = m_mirrorSwapchain->acquire();
+    if (!buffer)
+        return nullptr;
+
+    auto renderer = wOutput->renderer()->handle();
+    wlr_texture *texture = wlr_texture_from_buffer(renderer, source->handle());
+    if (!texture) {
+        wlr_buffer_unlock(buffer);
+        return nullptr;
+    }
+
+    const auto transform = qwoutput()->handle()->transform;
+    const bool sourceRotated = sourceTransform % 2;
+    const bool rotated = transform % 2;
+    const QSizeF sourceSize = sourceRotated ? QSizeF(texture->height, texture->width)
+                                            : QSizeF(texture->width, texture->height);
+    const QSize logicalSize = rotated ? size.transposed() : size;
+    const QSizeF fitSize = sourceSize.scaled(logicalSize, Qt::KeepAspectRatio);
+    wlr_box box {
+        .x = qRound((logicalSize.width() - fitSize.width()) / 2),
+        .y = qRound((logicalSize.height() - fitSize.height()) / 2),
+        .width = qRound(fitSize.width()),
+        .height = qRound(fitSize.height()),
+    };
+    wlr_box_transform(&box, &box, wlr_output_transform_invert(transform),
+                      logicalSize.width(), logicalSize.height());
+
+    WRenderHelper::resetGlState();
+    bool ok = false;
+    if (auto pass = wlr_renderer_begin_buffer_pass(renderer, buffer, nullptr)) {
+        wlr_render_rect_options clear {};
+        clear.box = { .x = 0, .y = 0, .width = size.width(), .height = size.height() };
+        clear.color = { .r = 0, .g = 0, .b = 0, .a = 1 };
+        clear.blend_mode = WLR_RENDER_BLEND_MODE_NONE;
+        wlr_render_pass_add_rect(pass, &clear);
+
+        wlr_render_texture_options options {};
+        options.texture = texture;
+        options.dst_box = box;
+        // Same as a client's buffer whose buffer transform is the source's transform
+        options.transform = wlr_output_transform_compose(wlr_output_transform_invert(sourceTransform),
+                                                         transform);
+        options.filter_mode = WLR_SCALE_FILTER_BILINEAR;
+        options.blend_mode = WLR_RENDER_BLEND_MODE_NONE;
+        wlr_render_pass_add_texture(pass, &options);
+        ok = wlr_render_pass_submit(pass);
+    }
+    WRenderHelper::resetGlState();
+    wlr_texture_destroy(texture);
+
+    // Locked by the output state when committing
+    wlr_buffer_unlock(buffer);
+    return ok ? qw_buffer::from(buffer) : nullptr;
+}
+
+bool OutputHelper::stopMirror()
+{
+    if (m_mirroring) {
+        qCDebug(wlcRenderer) << "Stop mirroring on" << output();
+        m_mirroring = false;
+        // The scene damage is ignored when mirroring
+        m_wholeDamage = true;
+    }
+    return false;
+}
+
+void OutputHelper::mirrorSourceDetached(OutputHelper *source)
+{
+    if (m_mirroredSource != source && m_pendingMirroredSource != source
+        && output()->mirrorSource() != source->output())
+        return;
+
+    m_mirrorBuffer = nullptr;
+    stopMirror();
+    fullUpdate();
+}
+
+void OutputHelper::setFrontBuffer(qw_buffer *buffer)
+{
+    m_frontBuffer = buffer;
+    ++m_frontSerial;
+
+    for (auto helper : std::as_const(renderWindowD()->outputs)) {
+        if (helper != this && helper->output() && helper->output()->mirrorSource() == output())
+            helper->WOutputHelper::update();
+    }
+}
+
 qw_buffer *OutputHelper::renderLayer(LayerData *layer, bool *dontEndRenderAndReturnNeedsEndRender)
 {
     auto source = layer->layer->layer->parent();
@@ -863,7 +1552,10 @@ WBufferRenderer *OutputHelper::afterRender()
     }
 
     static bool noHardwareLayers = qEnvironmentVariableIsSet("WAYLIB_NO_HARDWARE_LAYERS");
-    const bool ok = !noHardwareLayers && WOutputHelper::testCommit(bufferRenderer()->currentBuffer(), layers);
+    auto primaryBuffer = m_scanoutBuffer ? m_scanoutBuffer.get()
+                         : m_mirrorBuffer ? m_mirrorBuffer.get()
+                                          : bufferRenderer()->currentBuffer();
+    const bool ok = !noHardwareLayers && WOutputHelper::testCommit(primaryBuffer, layers);
     int needsSoftwareCompositeBeginIndex = -1;
     int needsSoftwareCompositeEndIndex = -1;
     bool forceShadowRender = false;
@@ -960,6 +1652,20 @@ WBufferRenderer *OutputHelper::afterRender()
         return bufferRenderer();
     }
 
+    if (m_scanoutBuffer) {
+        // Fallback to composite in the next frame
+        cancelScanout();
+        return nullptr;
+    }
+
+    if (m_mirrorBuffer) {
+        // Render the scene in the next frame
+        stopMirror();
+        resetState();
+        fullUpdate();
+        return nullptr;
+    }
+
     return compositeLayers(needsCompositeLayers, forceShadowRender);
 }
 
@@ -1059,7 +1765,7 @@ WBufferRenderer *OutputHelper::compositeLayers(const QList<LayerData*> layers, b
             // ###(zccrs): Maybe because contents is not dirty, so not do render
             // in WOutputRenderWindowPrivate::doRenderOutputs, force mark the
             // contents to dirty here to ensure can render layers in the next frame.
-            update();
+            fullUpdate();
         }
     }
 
@@ -1071,12 +1777,84 @@ bool OutputHelper::commit(WBufferRenderer *buffer)
     if (output()->offscreen())
         return true;
 
+    const auto d = renderWindowD();
+    m_frameTiming.polishStart = d->framePolishStart;
+    m_frameTiming.syncStart = d->frameSyncStart;
+    // The output increases the sequence after committed, the presentation
+    // feedback may be sent in the commit, so record it before committing.
+    m_frameTiming.commitSeq = qwoutput()->handle()->commit_seq + 1;
+    m_frameTiming.commitStart = monotonicNsecs();
+    auto &timing = m_frameTimings.append(m_frameTiming);
+    m_frameTiming = {};
+
+    const bool ok = commitBuffer(buffer);
+    timing.commitEnd = monotonicNsecs();
+    if (!ok)
+        timing.state = WOutputRenderWindow::FrameTiming::CommitFailed;
+    return ok;
+}
+
+void OutputHelper::onPresent(wlr_output_event_present *event)
+{
+    using FrameTiming = WOutputRenderWindow::FrameTiming;
+
+    auto frame = m_frameTimings.find(event->commit_seq);
+    if (!frame || frame->state != FrameTiming::Pending)
+        return;
+
+    if (event->presented) {
+        frame->state = FrameTiming::Presented;
+        // The presentation clock of the backends is CLOCK_MONOTONIC
+        frame->presented = qint64(event->when.tv_sec) * 1000000000 + event->when.tv_nsec;
+        frame->refresh = event->refresh;
+        frame->presentFlags = event->flags;
+    } else {
+        frame->state = FrameTiming::Discarded;
+    }
+
+    if (m_output)
+        Q_EMIT renderWindow()->framePresented(m_output);
+}
+
+bool OutputHelper::commitBuffer(WBufferRenderer *buffer)
+{
+    if (m_scanoutBuffer) {
+        qw_buffer *scanoutBuffer = m_scanoutBuffer;
+        setBuffer(scanoutBuffer);
+        m_scanoutBuffer = nullptr;
+        // The damage ring of the renderer doesn't know the client's buffer
+        m_lastCommitBuffer = nullptr;
+        const bool ok = WOutputHelper::commit();
+        if (ok) {
+            ++m_scanoutStatistics.scanouts;
+            setFrontBuffer(scanoutBuffer);
+        } else {
+            ++m_scanoutStatistics.failures;
+        }
+        return ok;
+    }
+
+    if (m_mirrorBuffer) {
+        qw_buffer *mirrorBuffer = m_mirrorBuffer;
+        setBuffer(mirrorBuffer);
+        m_mirrorBuffer = nullptr;
+        m_lastCommitBuffer = nullptr;
+        const bool ok = WOutputHelper::commit();
+        if (ok) {
+            m_mirroredSource = m_pendingMirroredSource;
+            m_mirroredSerial = m_pendingMirroredSerial;
+            setFrontBuffer(mirrorBuffer);
+        }
+        return ok;
+    }
+
     if (!buffer || !buffer->currentBuffer()) {
         Q_ASSERT(!this->buffer());
         return WOutputHelper::commit();
     }
 
-    setBuffer(buffer->currentBuffer());
+    qw_buffer *renderedBuffer = buffer->currentBuffer();
+    setBuffer(renderedBuffer);
 
     if (m_lastCommitBuffer == buffer) {
         if (pixman_region32_not_empty(&buffer->damageRing()->handle()->current))
@@ -1085,7 +1863,10 @@ bool OutputHelper::commit(WBufferRenderer *buffer)
 
     m_lastCommitBuffer = buffer;
 
-    return WOutputHelper::commit();
+    const bool ok = WOutputHelper::commit();
+    if (ok)
+        setFrontBuffer(renderedBuffer);
+    return ok;
 }
 
 bool OutputHelper::tryToHardwareCursor(const LayerData *layer)
@@ -1195,7 +1976,7 @@ bool OutputHelper::tryToHardwareCursor(const LayerData *layer)
             break;
         } else {
             m_hardwareCursorRenderComplete = true;
-            resetGlState();
+            WRenderHelper::resetGlState();
         }
 
         const auto pos = layer->mapToOutput.topLeft() + hotSpot;
@@ -1214,7 +1995,7 @@ bool OutputHelper::tryToHardwareCursor(const LayerData *layer)
         return true;
     } while (false);
 
-    resetGlState();
+    WRenderHelper::resetGlState();
 
     return false;
 }
@@ -1278,14 +2059,12 @@ void WOutputRenderWindowPrivate::init()
     6. QQuickRenderControlPrivate::maybeUpdate
     7. QQuickRenderControl::sceneChanged
     */
-    // TODO: Get damage regions from the Qt, and use WOutputDamage::add instead of WOutput::update.
+    // Without sync the scene can't know the damage area, so update the whole outputs.
     QObject::connect(rc(), &QQuickRenderControl::renderRequested,
                      q, qOverload<>(&WOutputRenderWindow::update));
     QObject::connect(rc(), &QQuickRenderControl::sceneChanged,
-                     q, [q, this] {
-        if (inRendering)
-            return;
-        q->update();
+                     q, [this] {
+        onSceneChanged();
     });
 
     // for WSeat::filterUnacceptedEvent
@@ -1415,6 +2194,44 @@ void WOutputRenderWindowPrivate::sortOutputs()
     });
 }
 
+void WOutputRenderWindowPrivate::collectSceneDamage()
+{
+    if (!dirtyItemList)
+        return;
+
+    if (SceneDamageCollector::disabled()) {
+        for (auto helper : std::as_const(outputs))
+            helper->fullUpdate();
+        return;
+    }
+
+    QSet<QQuickItem*> renderSources;
+    for (auto helper : std::as_const(outputs)) {
+        if (auto input = helper->output()->input())
+            renderSources.insert(input);
+    }
+
+    QSet<QQuickItem*> layerSources;
+    for (auto layer : std::as_const(layers)) {
+        // The accepted layer is hidden in the scene
+        if (layer->layer->isAccepted())
+            layerSources.insert(layer->layer->parent());
+    }
+
+    QRegion damage;
+    if (!sceneDamage.collect(this, renderSources, layerSources, &damage)) {
+        for (auto helper : std::as_const(outputs))
+            helper->fullUpdate();
+        return;
+    }
+
+    if (damage.isEmpty())
+        return;
+
+    for (auto helper : std::as_const(outputs))
+        helper->addSceneDamage(damage);
+}
+
 QVector<std::pair<OutputHelper*, WBufferRenderer*>>
 WOutputRenderWindowPrivate::doRenderOutputs(qw_output *needsFrameOutput, const QList<OutputHelper*> &outputs,
                                             bool forceRender)
@@ -1429,6 +2246,8 @@ WOutputRenderWindowPrivate::doRenderOutputs(qw_output *needsFrameOutput, const Q
                 Q_ASSERT(!helper->framePending());
         }
 
+        helper->frameTiming() = {};
+
         if (Q_LIKELY(!forceRender)) {
             if (helper->framePending())
                 continue;
@@ -1454,6 +2273,12 @@ WOutputRenderWindowPrivate::doRenderOutputs(qw_output *needsFrameOutput, const Q
 
         const auto &format = helper->qwoutput()->handle()->render_format;
         const auto renderMatrix = helper->output()->renderMatrix();
+        helper->frameTiming().renderStart = monotonicNsecs();
+
+        if (Q_LIKELY(!forceRender) && (helper->tryMirror() || helper->tryScanout())) {
+            renderResults.append(helper);
+            continue;
+        }
 
         // maybe using the other WOutputViewport's QSGTextureProvider
         if (!helper->output()->depends().isEmpty())
@@ -1463,6 +2288,7 @@ WOutputRenderWindowPrivate::doRenderOutputs(qw_output *needsFrameOutput, const Q
                                                 WBufferRenderer::RedirectOpenGLContextDefaultFrameBufferObject);
         Q_ASSERT(buffer == helper->bufferRenderer()->currentBuffer());
         if (buffer) {
+            helper->applyDamage(helper->bufferRenderer());
             helper->render(helper->bufferRenderer(), 0, renderMatrix,
                            helper->output()->effectiveSourceRect(),
                            helper->output()->targetRect(),
@@ -1475,11 +2301,13 @@ WOutputRenderWindowPrivate::doRenderOutputs(qw_output *needsFrameOutput, const Q
     needsCommit.reserve(renderResults.size());
     for (auto helper : std::as_const(renderResults)) {
         auto bufferRenderer = helper->afterRender();
+        helper->frameTiming().renderEnd = monotonicNsecs();
         if (bufferRenderer)
             needsCommit.append({helper, bufferRenderer});
     }
 
     rendererList.clear();
+    rootRendererIsUsed = false;
 
     return needsCommit;
 }
@@ -1518,10 +2346,13 @@ void WOutputRenderWindowPrivate::doRender(qw_output *needsFrameOutput,
         layer->beforeRender(q);
     }
 
+    framePolishStart = monotonicNsecs();
     rc()->polishItems();
+    collectSceneDamage();
 
     if (QSGRendererInterface::isApiRhiBased(WRenderHelper::getGraphicsApi()))
         rc()->beginFrame();
+    frameSyncStart = monotonicNsecs();
     rc()->sync();
 
     QQuickAnimatorController_advance(animationController.get());
@@ -1540,7 +2371,7 @@ void WOutputRenderWindowPrivate::doRender(qw_output *needsFrameOutput,
     // wlroots may have render operations after commit, so do
     // not move the location during the reset operation.
     // eg: screencopy ext-image-capture
-    resetGlState();
+    WRenderHelper::resetGlState();
 
     QList<QPointer<WOutput>> committedOutputs;
     if (doCommit) {
@@ -1568,7 +2399,7 @@ void WOutputRenderWindowPrivate::doRender(qw_output *needsFrameOutput,
         }
     }
 
-    resetGlState();
+    WRenderHelper::resetGlState();
 
     // On Intel&Nvidia multi-GPU environment, wlroots using Intel card do render for all
     // outputs, and blit nvidia's output buffer in drm_connector_state_update_primary_fb,
@@ -1652,7 +2483,7 @@ void WOutputRenderWindow::attach(WOutputViewport *output)
 
     d->updateSceneDPR();
     d->init(newOutput);
-    newOutput->update();
+    newOutput->fullUpdate();
 
     if (!newOutput->layers().isEmpty()) {
         if (auto od = WOutputViewportPrivate::get(output)) {
@@ -1674,6 +2505,8 @@ void WOutputRenderWindow::detach(WOutputViewport *output)
 
     auto outputHelper = d->outputs.takeAt(index);
     const auto hasLayer = !outputHelper->layers().isEmpty();
+    for (auto helper : std::as_const(d->outputs))
+        helper->mirrorSourceDetached(outputHelper);
 
     if (output->output() && !d->containsOutput(output->output())) {
         bool ok = output->output()->safeDisconnect(this);
@@ -1811,6 +2644,36 @@ WOutputHelper *WOutputRenderWindow::getOutputHelper(WOutputViewport *output) con
     return d->getOutputHelper(output);
 }
 
+WOutputRenderWindow::DamageStatistics WOutputRenderWindow::damageStatistics(WOutputViewport *output) const
+{
+    Q_D(const WOutputRenderWindow);
+    auto helper = d->getOutputHelper(output);
+    if (!helper)
+        return {};
+
+    return helper->bufferRenderer()->damageStatistics();
+}
+
+WOutputRenderWindow::ScanoutStatistics WOutputRenderWindow::scanoutStatistics(WOutputViewport *output) const
+{
+    Q_D(const WOutputRenderWindow);
+    auto helper = d->getOutputHelper(output);
+    if (!helper)
+        return {};
+
+    return helper->scanoutStatistics();
+}
+
+QList<WOutputRenderWindow::FrameTiming> WOutputRenderWindow::frameTimings(WOutputViewport *output, int maxCount) const
+{
+    Q_D(const WOutputRenderWindow);
+    auto helper = d->getOutputHelper(output);
+    if (!helper)
+        return {};
+
+    return helper->frameTimings(maxCount);
+}
+
 void WOutputRenderWindow::setOutputScale(WOutputViewport *output, float scale)
 {
     Q_D(WOutputRenderWindow);
@@ -1938,7 +2801,7 @@ void WOutputRenderWindow::update()
 {
     Q_D(WOutputRenderWindow);
     for (auto o : std::as_const(d->outputs))
-        o->update();
+        o->fullUpdate();
 }
 
 void WOutputRenderWindow::update(WOutputViewport *output)
@@ -1946,7 +2809,7 @@ void WOutputRenderWindow::update(WOutputViewport *output)
     Q_D(WOutputRenderWindow);
     int index = d->indexOfOutputHelper(output);
     Q_ASSERT(index >= 0);
-    d->outputs.at(index)->update();
+    d->outputs.at(index)->fullUpdate();
 }
 
 qreal WOutputRenderWindow::width() const
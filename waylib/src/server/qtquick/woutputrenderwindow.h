@@ -45,6 +45,66 @@ public:
 
     WOutputHelper *getOutputHelper(WOutputViewport *output) const;
 
+    struct DamageStatistics {
+        // the bytes of the damage committed to the output
+        quint64 damagedBytes = 0;
+        // the bytes repainted by the renderer
+        quint64 renderedBytes = 0;
+    };
+    DamageStatistics damageStatistics(WOutputViewport *output) const;
+
+    struct ScanoutStatistics {
+        // the frames tried to present the client's buffer directly
+        quint64 attempts = 0;
+        // the frames committed with the client's buffer
+        quint64 scanouts = 0;
+        // the frames fallback to composite after the attempt
+        quint64 failures = 0;
+    };
+    ScanoutStatistics scanoutStatistics(WOutputViewport *output) const;
+
+    struct FrameTiming {
+        enum State : quint8 {
+            // committed, waiting for the presentation feedback
+            Pending,
+            Presented,
+            // committed but replaced by the next frame before shown
+            Discarded,
+            CommitFailed,
+        };
+        // how the committed buffer is produced
+        enum Path : quint8 {
+            Composited,
+            // the client's buffer covering the whole output
+            DirectScanout,
+            // the buffer of the mirror source, see WOutputViewport::mirrorSource
+            MirrorShared,
+            // the buffer of the mirror source scaled by one blit
+            MirrorBlitted,
+        };
+
+        // the commit sequence of the output, see wlr_output::commit_seq
+        quint32 commitSeq = 0;
+        State state = Pending;
+        Path path = Composited;
+        // wlr_output_present_flag
+        quint32 presentFlags = 0;
+        // the refresh duration of the output in nanoseconds, 0 if unknown
+        qint32 refresh = 0;
+        // CLOCK_MONOTONIC in nanoseconds, the render stage is 0 if the output
+        // doesn't need to render, the render time is spent on the CPU.
+        qint64 polishStart = 0;
+        qint64 syncStart = 0;
+        qint64 renderStart = 0;
+        qint64 renderEnd = 0;
+        qint64 commitStart = 0;
+        qint64 commitEnd = 0;
+        qint64 presented = 0;
+    };
+    // Returns the timing of the last frames of the output, the oldest first,
+    // at most the last 256 frames are kept.
+    QList<FrameTiming> frameTimings(WOutputViewport *output, int maxCount = -1) const;
+
     // TODO: Deprecate these convenience methods in favor of getOutputHelper() + setExtraState()
     // for atomic multi-property operations. These are kept for simple QML use cases.
     void setOutputScale(WOutputViewport *output, float scale);
@@ -82,6 +142,7 @@ Q_SIGNALS:
     void initialized();
     void disableLayersChanged();
     void renderEnd(QList<QPointer<WOutput>> committedOutputs);
+    void framePresented(WAYLIB_SERVER_NAMESPACE::WOutputViewport *output);
     void effectiveDevicePixelRatioChanged(qreal scale);
 
 private:
@@ -491,6 +491,23 @@ void WOutputViewport::setDepends(const QList<WOutputViewport *> &newDepends)
     Q_EMIT dependsChanged();
 }
 
+WOutputViewport *WOutputViewport::mirrorSource() const
+{
+    W_DC(WOutputViewport);
+    return d->mirrorSource;
+}
+
+void WOutputViewport::setMirrorSource(WOutputViewport *newMirrorSource)
+{
+    W_D(WOutputViewport);
+    Q_ASSERT(newMirrorSource != this);
+    if (d->mirrorSource == newMirrorSource)
+        return;
+    d->mirrorSource = newMirrorSource;
+    d->update();
+    Q_EMIT mirrorSourceChanged();
+}
+
 void WOutputViewport::setOutputScale(float scale)
 {
     W_D(WOutputViewport);
@@ -35,6 +35,7 @@ class WAYLIB_SERVER_EXPORT WOutputViewport : public QQuickItem, public virtual W
     Q_PROPERTY(QList<WAYLIB_SERVER_NAMESPACE::WOutputLayer*> layers READ layers NOTIFY layersChanged FINAL)
     Q_PROPERTY(QList<WAYLIB_SERVER_NAMESPACE::WOutputLayer*> hardwareLayers READ hardwareLayers NOTIFY hardwareLayersChanged FINAL)
     Q_PROPERTY(QList<WAYLIB_SERVER_NAMESPACE::WOutputViewport*> depends READ depends WRITE setDepends NOTIFY dependsChanged FINAL)
+    Q_PROPERTY(WAYLIB_SERVER_NAMESPACE::WOutputViewport* mirrorSource READ mirrorSource WRITE setMirrorSource NOTIFY mirrorSourceChanged FINAL)
     QML_NAMED_ELEMENT(OutputViewport)
 
 public:
@@ -103,6 +104,11 @@ public:
     QList<WOutputViewport *> depends() const;
     void setDepends(const QList<WOutputViewport *> &newDepends);
 
+    // Show the buffer committed by the source instead of rendering the scene,
+    // the scene is rendered only if the buffer can't be shown on this output.
+    WOutputViewport *mirrorSource() const;
+    void setMirrorSource(WOutputViewport *newMirrorSource);
+
 public Q_SLOTS:
     void setOutputScale(float scale);
     void rotateOutput(WOutput::Transform t);
@@ -126,6 +132,7 @@ Q_SIGNALS:
     void layersChanged();
     void hardwareLayersChanged();
     void dependsChanged();
+    void mirrorSourceChanged();
 
 private:
     void componentComplete() override;
@@ -19,6 +19,7 @@
 #include <qwrendererinterface.h>
 
 #include <QSGTexture>
+#include <QOpenGLFunctions>
 #include <private/qquickrendercontrol_p.h>
 #include <private/qquickwindow_p.h>
 #include <private/qrhi_p.h>
@@ -304,6 +305,23 @@ QSGRendererInterface::GraphicsApi WRenderHelper::getGraphicsApi()
     return api;
 }
 
+// Call it before any wlroots render to clean up the GL state in Qt.
+// If you don't do this, there will be tearing, flickering and other graphics problems
+void WRenderHelper::resetGlState()
+{
+#ifndef QT_NO_OPENGL
+    // Clear OpenGL state for wlroots, the states is set by Qt, But it is will
+    // effect to wlroots's gles renderer.
+    if (getGraphicsApi() == QSGRendererInterface::OpenGL) {
+        // If not reset, you will get a warning from Mesa(enable MESA_DEBUG):
+        // Mesa: warning: Received negative int32 vertex buffer offset. (driver limitation)
+        glBindBuffer(GL_ARRAY_BUFFER, GL_NONE);
+        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, GL_NONE);
+        glDisable(GL_DEPTH_TEST);
+    }
+#endif
+}
+
 class Q_DECL_HIDDEN GLTextureBuffer : public qw_buffer_interface
 {
 public:
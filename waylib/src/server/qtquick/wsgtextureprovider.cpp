@@ -10,6 +10,7 @@
 #include <qwbuffer.h>
 #include <qwrenderer.h>
 
+#include <QMetaMethod>
 #include <rhi/qrhi.h>
 #include <private/qsgplaintexture_p.h>
 
@@ -184,6 +185,12 @@ qw_buffer *WSGTextureProvider::qwBuffer() const
     return d->buffer;
 }
 
+bool WSGTextureProvider::isConnected() const
+{
+    static const auto signal = QMetaMethod::fromSignal(&QSGTextureProvider::textureChanged);
+    return isSignalConnected(signal);
+}
+
 bool WSGTextureProvider::smooth() const
 {
     W_DC(WSGTextureProvider);
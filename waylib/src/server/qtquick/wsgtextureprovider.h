@@ -34,6 +34,8 @@ public:
     QSGTexture *texture() const override;
     virtual QW_NAMESPACE::qw_texture *qwTexture() const;
     virtual QW_NAMESPACE::qw_buffer *qwBuffer() const;
+    // Whether any node or item is listening to textureChanged
+    bool isConnected() const;
 
     bool smooth() const;
     void setSmooth(bool newSmooth);
@@ -10,6 +10,7 @@
 #include "woutputviewport.h"
 #include "wsgtextureprovider.h"
 #include "woutputrenderwindow.h"
+#include "wtools.h"
 
 #include <qwcompositor.h>
 #include <qwsubcompositor.h>
@@ -227,6 +228,7 @@ public:
         if (dontCacheLastBuffer) {
             buffer.reset();
             cleanTextureProvider();
+            markDamageUnknown();
             q->update();
         }
     }
@@ -256,6 +258,7 @@ public:
                 } else {
                     // Live mode: update buffer immediately
                     buffer.reset(newBuffer);
+                    addSurfaceDamage();
                     q->update();
                 }
             }
@@ -316,6 +319,7 @@ public:
         const auto bOffset = surface->bufferOffset();
         if (bOffset != bufferOffset) {
             bufferOffset = surface->bufferOffset();
+            markDamageUnknown();
             Q_EMIT q->bufferOffsetChanged();
         }
 
@@ -327,6 +331,40 @@ public:
         q->setImplicitSize(s.width(), s.height());
     }
 
+    void addSurfaceDamage() {
+        if (damageIsUnknown)
+            return;
+
+        W_Q(WSurfaceItemContent);
+        const auto surfaceSize = surface->size();
+        if (surfaceSize.isEmpty() || q->width() <= 0 || q->height() <= 0) {
+            markDamageUnknown();
+            return;
+        }
+
+        // The effective damage is in the surface local coordinates, it's already
+        // applied the buffer scale, buffer transform and the viewport.
+        WPixmanRegion surfaceDamage;
+        surface->handle()->get_effective_damage(surfaceDamage);
+        if (surfaceDamage.isEmpty())
+            return;
+
+        const QPointF offset = ignoreBufferOffset ? QPointF() : QPointF(bufferOffset);
+        const qreal xScale = q->width() / surfaceSize.width();
+        const qreal yScale = q->height() / surfaceSize.height();
+
+        for (const QRect &r : WTools::fromPixmanRegion(surfaceDamage)) {
+            const QRectF itemRect(offset.x() + r.x() * xScale, offset.y() + r.y() * yScale,
+                                  r.width() * xScale, r.height() * yScale);
+            damage += itemRect.toAlignedRect();
+        }
+    }
+
+    inline void markDamageUnknown() {
+        damageIsUnknown = true;
+        damage = QRegion();
+    }
+
     inline void swapBufferIfNeeded() {
         if (pendingBuffer)
             buffer = std::move(pendingBuffer);
@@ -345,6 +383,7 @@ public:
             return;
 
         alphaModifier = alpha;
+        markDamageUnknown();
 
         W_Q(WSurfaceItemContent);
 
@@ -363,6 +402,9 @@ public:
     BufferRef buffer;
     BufferRef pendingBuffer;
     mutable QMetaObject::Connection updateTextureConnection;
+    // the damage in the item's coordinates since the last WSurfaceItemContent::takeDamage
+    QRegion damage;
+    bool damageIsUnknown = true;
     bool dontCacheLastBuffer = false;
     bool live = true;
     bool ignoreBufferOffset = false;
@@ -504,6 +546,7 @@ void WSurfaceItemContent::setLive(bool live)
     d->live = live;
     if (live) {
         d->swapBufferIfNeeded();
+        d->markDamageUnknown();
         update();
     }
     Q_EMIT liveChanged();
@@ -559,6 +602,61 @@ qreal WSurfaceItemContent::alphaModifier() const
     return d->alphaModifier;
 }
 
+bool WSurfaceItemContent::takeDamage(QRegion *damage)
+{
+    W_D(WSurfaceItemContent);
+    const bool known = !d->damageIsUnknown;
+    if (known)
+        *damage = d->damage;
+
+    d->damage = QRegion();
+    d->damageIsUnknown = false;
+
+    return known;
+}
+
+qw_buffer *WSurfaceItemContent::scanoutBuffer() const
+{
+    W_DC(WSurfaceItemContent);
+    if (!d->surface || !d->live || !qFuzzyCompare(d->alphaModifier, 1.0))
+        return nullptr;
+
+    auto buffer = d->buffer.get();
+    if (!buffer)
+        return nullptr;
+
+    auto surface = d->surface->handle()->handle();
+    if (surface->current.transform != WL_OUTPUT_TRANSFORM_NORMAL)
+        return nullptr;
+
+    const QSize bufferSize(buffer->handle()->width, buffer->handle()->height);
+    if (d->bufferSourceBox != QRectF(QPointF(0, 0), bufferSize))
+        return nullptr;
+
+    // The pixels below the buffer are visible if it's translucent
+    const QSize surfaceSize = d->surface->size();
+    pixman_box32_t surfaceBox { 0, 0, surfaceSize.width(), surfaceSize.height() };
+    if (pixman_region32_contains_rectangle(&surface->opaque_region, &surfaceBox) == PIXMAN_REGION_IN)
+        return buffer;
+
+    wlr_dmabuf_attributes attribs;
+    if (!buffer->get_dmabuf(&attribs))
+        return nullptr;
+    const auto format = WTools::toImageFormat(attribs.format);
+    if (format == QImage::Format_Invalid
+        || QImage::toPixelFormat(format).alphaUsage() != QPixelFormat::IgnoresAlpha)
+        return nullptr;
+
+    return buffer;
+}
+
+void WSurfaceItemContent::markScanout()
+{
+    W_D(WSurfaceItemContent);
+    // Let the frame done callback works like the buffer is rendered
+    d->rendered = true;
+}
+
 class Q_DECL_HIDDEN WSGRenderFootprintNode: public QSGRenderNode
 {
 public:
@@ -633,6 +731,7 @@ void WSurfaceItemContent::releaseResources()
     // Force to update the contents, avoid to render the invalid textures
     // Only mark dirty if we have a valid window to avoid crashes during window destruction
     if (window()) {
+        d->markDamageUnknown();
         QQuickItemPrivate::get(this)->dirty(QQuickItemPrivate::Content);
     }
 }
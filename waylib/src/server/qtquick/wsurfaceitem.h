@@ -63,6 +63,10 @@ public:
     qreal devicePixelRatio() const;
     qreal alphaModifier() const;
 
+    // Take the damage in the item's coordinates since the last call,
+    // returns false if the damage area is unknown.
+    bool takeDamage(QRegion *damage);
+
 Q_SIGNALS:
     void surfaceChanged();
     void cacheLastBufferChanged();
@@ -78,6 +82,13 @@ private:
     friend class WSurfaceItemPrivate;
     friend class WSGTextureProvider;
     friend class WSGRenderFootprintNode;
+    friend class OutputHelper;
+
+    // Returns the current buffer if it can be presented by the output without
+    // composition, the buffer must be opaque and not transformed or cropped.
+    QW_NAMESPACE::qw_buffer *scanoutBuffer() const;
+    // The buffer is presented by direct scanout instead of rendering
+    void markScanout();
 
     void componentComplete() override;
     QSGNode *updatePaintNode(QSGNode *, UpdatePaintNodeData *) override;
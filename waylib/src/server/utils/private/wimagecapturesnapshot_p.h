@@ -0,0 +1,43 @@
+// Copyright (C) 2026 UnionTech Software Technology Co., Ltd.
+// SPDX-License-Identifier: Apache-2.0 OR LGPL-3.0-only OR GPL-2.0-only OR GPL-3.0-only
+
+#pragma once
+
+#include <wglobal.h>
+#include <qwglobal.h>
+
+#include <QImage>
+#include <QPointer>
+
+struct wlr_buffer;
+struct wlr_renderer;
+
+QW_BEGIN_NAMESPACE
+class qw_buffer;
+QW_END_NAMESPACE
+
+WAYLIB_SERVER_BEGIN_NAMESPACE
+
+// Reads back a buffer once and copies it to the shm frames of every capture
+// session of it, until reset() is called for the new contents of the buffer.
+// Exported for the unit tests only.
+class WAYLIB_SERVER_EXPORT WImageCaptureSnapshot
+{
+public:
+    // Returns false if dst is not a shm buffer or the read back failed
+    bool copy(wlr_buffer *dst, wlr_buffer *src, wlr_renderer *renderer);
+    void reset();
+
+    // The times the source buffers were read back
+    quint64 readbacks() const;
+
+private:
+    bool ensure(wlr_buffer *src, wlr_renderer *renderer, uint32_t format);
+
+    QImage m_image;
+    QPointer<QW_NAMESPACE::qw_buffer> m_buffer;
+    uint32_t m_format = 0;
+    quint64 m_readbacks = 0;
+};
+
+WAYLIB_SERVER_END_NAMESPACE
@@ -2,11 +2,13 @@
 // SPDX-License-Identifier: Apache-2.0 OR LGPL-3.0-only OR GPL-2.0-only OR GPL-3.0-only
 
 #include "wextimagecapturesourcev1impl.h"
+#include "private/wimagecapturesnapshot_p.h"
 #include "wsurfaceitem.h"
 #include "wsgtextureprovider.h"
 #include "woutputrenderwindow.h"
 #include "woutput.h"
 #include "wtools.h"
+#include "wsurface.h"
 
 #include <qwextimagecopycapturev1.h>
 #include <qwrenderer.h>
@@ -16,6 +18,9 @@
 #include <qwcompositor.h>
 
 #include <QLoggingCategory>
+#include <QImage>
+#include <QHash>
+#include <QTimer>
 
 #include <memory>
 
@@ -24,6 +29,7 @@ Q_LOGGING_CATEGORY(qLcImageCapture, "waylib.server.imagecapture")
 extern "C" {
 #include <wlr/interfaces/wlr_output.h>
 #include <wlr/types/wlr_buffer.h>
+#include <wlr/render/wlr_texture.h>
 #include <pixman.h>
 #include <drm_fourcc.h>
 #include <sys/stat.h>
@@ -114,15 +120,240 @@ struct ConstraintBuilder {
     }
 };
 
+bool WImageCaptureSnapshot::ensure(wlr_buffer *src, wlr_renderer *renderer, uint32_t format)
+{
+    auto buffer = qw_buffer::from(src);
+    if (m_buffer == buffer && m_format == format && !m_image.isNull())
+        return true;
+
+    reset();
+
+    const auto imageFormat = WTools::toImageFormat(format);
+    if (imageFormat == QImage::Format_Invalid)
+        return false;
+
+    auto texture = wlr_texture_from_buffer(renderer, src);
+    if (!texture)
+        return false;
+
+    QImage image(texture->width, texture->height, imageFormat);
+    wlr_texture_read_pixels_options options = {};
+    options.data = image.bits();
+    options.format = format;
+    options.stride = image.bytesPerLine();
+    const bool ok = wlr_texture_read_pixels(texture, &options);
+    wlr_texture_destroy(texture);
+    ++m_readbacks;
+
+    if (!ok)
+        return false;
+
+    m_image = image;
+    m_buffer = buffer;
+    m_format = format;
+
+    return true;
+}
+
+bool WImageCaptureSnapshot::copy(wlr_buffer *dst, wlr_buffer *src, wlr_renderer *renderer)
+{
+    void *data = nullptr;
+    uint32_t format = DRM_FORMAT_INVALID;
+    size_t stride = 0;
+
+    // The dmabuf frames are blitted on GPU, nothing to share
+    if (!wlr_buffer_begin_data_ptr_access(dst, WLR_BUFFER_DATA_PTR_ACCESS_WRITE,
+                                          &data, &format, &stride)) {
+        return false;
+    }
+
+    const bool ok = ensure(src, renderer, format)
+                    && m_image.width() == dst->width
+                    && m_image.height() == dst->height;
+    if (ok) {
+        const size_t lineBytes = qMin<size_t>(stride, m_image.bytesPerLine());
+        auto bits = static_cast<uchar*>(data);
+        for (int y = 0; y < m_image.height(); ++y)
+            memcpy(bits + y * stride, m_image.constScanLine(y), lineBytes);
+    }
+    wlr_buffer_end_data_ptr_access(dst);
+
+    return ok;
+}
+
+void WImageCaptureSnapshot::reset()
+{
+    m_image = QImage();
+    m_buffer = nullptr;
+    m_format = DRM_FORMAT_INVALID;
+}
+
+quint64 WImageCaptureSnapshot::readbacks() const
+{
+    return m_readbacks;
+}
+
+// Shared by all capture sources of the same surface, only one renderEnd listener
+// for them. When several sources capture the surface, the shm frames are copied
+// from one snapshot of the buffer instead of reading back the texture for every
+// client. The frame events of the sources are emitted one by one and wlroots
+// copies each frame inside its event, so the snapshot is kept until the surface
+// commits a new buffer.
+class Q_DECL_HIDDEN WImageCaptureHub : public QObject
+{
+public:
+    static WImageCaptureHub *acquire(WSurfaceItemContent *content,
+                                     WOutputRenderWindow *window,
+                                     WExtImageCaptureSourceV1Impl *source);
+    void release(WExtImageCaptureSourceV1Impl *source);
+
+    bool copy(wlr_ext_image_copy_capture_frame_v1 *frame, wlr_buffer *src, wlr_renderer *renderer);
+
+private:
+    WImageCaptureHub(WSurfaceItemContent *content, WOutputRenderWindow *window);
+    ~WImageCaptureHub();
+
+    void handleRenderEnd();
+    void connectSurface();
+    void handleCommit(quint32 committedState);
+
+    static QHash<WSurfaceItemContent*, WImageCaptureHub*> hubs;
+
+    WSurfaceItemContent *m_content;
+    QList<WExtImageCaptureSourceV1Impl*> m_sources;
+    QMetaObject::Connection m_commitConnection;
+    QSize m_bufferSize;
+    WImageCaptureSnapshot m_snapshot;
+};
+
+QHash<WSurfaceItemContent*, WImageCaptureHub*> WImageCaptureHub::hubs;
+
+WImageCaptureHub::WImageCaptureHub(WSurfaceItemContent *content, WOutputRenderWindow *window)
+    : m_content(content)
+{
+    connect(window, &WOutputRenderWindow::renderEnd, this, &WImageCaptureHub::handleRenderEnd);
+    connect(content, &WSurfaceItemContent::surfaceChanged, this, [this] {
+        m_snapshot.reset();
+        for (auto source : std::as_const(m_sources))
+            source->markDamageUnknown();
+        connectSurface();
+    });
+    connectSurface();
+}
+
+WImageCaptureHub::~WImageCaptureHub()
+{
+    Q_ASSERT(m_sources.isEmpty());
+    hubs.remove(m_content);
+}
+
+WImageCaptureHub *WImageCaptureHub::acquire(WSurfaceItemContent *content,
+                                            WOutputRenderWindow *window,
+                                            WExtImageCaptureSourceV1Impl *source)
+{
+    auto hub = hubs.value(content);
+    if (!hub) {
+        hub = new WImageCaptureHub(content, window);
+        hubs.insert(content, hub);
+    }
+
+    Q_ASSERT(!hub->m_sources.contains(source));
+    hub->m_sources.append(source);
+    qCDebug(qLcImageCapture) << "Capture hub of" << content << "has" << hub->m_sources.size() << "sources";
+
+    return hub;
+}
+
+void WImageCaptureHub::release(WExtImageCaptureSourceV1Impl *source)
+{
+    m_sources.removeOne(source);
+    if (m_sources.isEmpty())
+        delete this;
+}
+
+void WImageCaptureHub::connectSurface()
+{
+    QObject::disconnect(m_commitConnection);
+    m_bufferSize = QSize();
+
+    if (auto surface = m_content->surface()) {
+        const auto state = surface->handle()->handle()->current;
+        m_bufferSize = QSize(state.buffer_width, state.buffer_height);
+        m_commitConnection = surface->safeConnect(&WSurface::commit,
+                                                  this, &WImageCaptureHub::handleCommit);
+    }
+}
+
+void WImageCaptureHub::handleCommit(quint32 committedState)
+{
+    if (!(committedState & WLR_SURFACE_STATE_BUFFER))
+        return;
+
+    // The client maybe reuse the same wlr_buffer with the new contents
+    m_snapshot.reset();
+
+    auto surface = m_content->surface()->handle()->handle();
+    const QSize bufferSize(surface->current.buffer_width, surface->current.buffer_height);
+
+    // The frames are copied from the whole buffer, so the buffer_damage can be used directly
+    if (bufferSize != m_bufferSize) {
+        m_bufferSize = bufferSize;
+        for (auto source : std::as_const(m_sources)) {
+            source->markDamageUnknown();
+            source->queueFrame();
+        }
+        return;
+    }
+
+    const QRegion damage = WTools::fromPixmanRegion(&surface->buffer_damage);
+    if (damage.isEmpty())
+        return;
+
+    // The frames are copied from the surface's buffer, don't wait for the
+    // renderEnd, the surface maybe hidden or not on any output.
+    for (auto source : std::as_const(m_sources)) {
+        source->addDamage(damage);
+        source->queueFrame();
+    }
+}
+
+void WImageCaptureHub::handleRenderEnd()
+{
+    // The frame event may stop the capture session and destroy this hub
+    QPointer<WImageCaptureHub> self(this);
+    const auto sources = m_sources;
+    for (auto source : sources) {
+        if (!self)
+            break;
+        if (m_sources.contains(source))
+            source->handleRenderEnd();
+    }
+}
+
+bool WImageCaptureHub::copy(wlr_ext_image_copy_capture_frame_v1 *frame, wlr_buffer *src, wlr_renderer *renderer)
+{
+    // Only one client captures this surface, the snapshot would be an extra copy for it
+    if (m_sources.size() > 1 && m_snapshot.copy(frame->buffer, src, renderer))
+        return true;
+
+    return qw_ext_image_copy_capture_frame_v1::copy_buffer(frame, src, renderer);
+}
+
 WExtImageCaptureSourceV1Impl::WExtImageCaptureSourceV1Impl(WSurfaceItemContent *surfaceContent, WOutput *output)
     : QObject(surfaceContent) // TODO: Check if Qt object tree destruction timing is appropriate
     , m_surfaceContent(surfaceContent)
     , m_output(output)
     , m_capturing(false)
-    , m_renderEndConnection()
+    , m_hub(nullptr)
+    , m_damageIsUnknown(true)
+    , m_maxFps(qMax(0, qEnvironmentVariableIntValue("WAYLIB_IMAGE_CAPTURE_MAX_FPS")))
+    , m_frameTimer(new QTimer(this))
 {
     Q_ASSERT(m_surfaceContent);
 
+    m_frameTimer->setSingleShot(true);
+    connect(m_frameTimer, &QTimer::timeout, this, &WExtImageCaptureSourceV1Impl::handleRenderEnd);
+
     // Initialize wlr_ext_image_capture_source_v1
     wlr_ext_image_capture_source_v1_init(handle(), impl());
     
@@ -158,19 +389,20 @@ WExtImageCaptureSourceV1Impl::~WExtImageCaptureSourceV1Impl()
     if (m_capturing) {
         qCDebug(qLcImageCapture) << "WExtImageCaptureSourceV1Impl destroyed while capturing";
     }
+
+    if (m_hub)
+        m_hub->release(this);
 }
 
 void WExtImageCaptureSourceV1Impl::start([[maybe_unused]] bool with_cursors)
 {
     // TODO: Implement cursor capture if needed
     m_capturing = true;
+    // The new session needs a whole frame at first
+    markDamageUnknown();
+    m_lastFrameTimer.invalidate();
     qCDebug(qLcImageCapture) << "WExtImageCaptureSourceV1Impl::start() with_cursors:" << with_cursors;
 
-    // TODO: Optimize multiple clients capturing the same window
-    // Currently each client creates its own WExtImageCaptureSourceV1Impl instance,
-    // which means multiple render listeners for the same surface. Consider implementing
-    // a manager to share render events among multiple capture sources.
-
     if (!m_surfaceContent) {
         qCWarning(qLcImageCapture) << "No surface content available for capture";
         return;
@@ -189,17 +421,10 @@ void WExtImageCaptureSourceV1Impl::start([[maybe_unused]] bool with_cursors)
         return;
     }
     
-    // Connect to renderEnd signal
-    m_renderEndConnection = connect(renderWindow,
-                                   &WOutputRenderWindow::renderEnd,
-                                   this,
-                                   &WExtImageCaptureSourceV1Impl::handleRenderEnd,
-                                   Qt::AutoConnection);
-    
-    if (!m_renderEndConnection) {
-        qCWarning(qLcImageCapture) << "Cannot connect to render end of output render window";
-    }
-    
+    // Share the renderEnd listener and the copied frame with other clients of this surface
+    if (!m_hub)
+        m_hub = WImageCaptureHub::acquire(m_surfaceContent, renderWindow, this);
+
     // If not currently rendering, trigger immediately
     if (!renderWindow->inRendering()) {
         QMetaObject::invokeMethod(this, &WExtImageCaptureSourceV1Impl::handleRenderEnd, Qt::AutoConnection);
@@ -209,12 +434,12 @@ void WExtImageCaptureSourceV1Impl::start([[maybe_unused]] bool with_cursors)
 void WExtImageCaptureSourceV1Impl::stop()
 {
     m_capturing = false;
+    m_frameTimer->stop();
     qCDebug(qLcImageCapture) << "WExtImageCaptureSourceV1Impl::stop()";
     
-    // Disconnect render end connection
-    if (m_renderEndConnection) {
-        disconnect(m_renderEndConnection);
-        m_renderEndConnection = QMetaObject::Connection();
+    if (m_hub) {
+        m_hub->release(this);
+        m_hub = nullptr;
     }
 }
 
@@ -232,47 +457,97 @@ void WExtImageCaptureSourceV1Impl::schedule_frame()
         return;
     }
     
-    // Request output update to ensure next frame will be rendered
-    wlr_output_update_needs_frame(m_output->nativeHandle());
-    
-    // Get render window to check if currently rendering
-    auto textureProvider = m_surfaceContent->wTextureProvider();
-    if (textureProvider) {
-        auto renderWindow = textureProvider->window();
-        if (renderWindow && !renderWindow->inRendering()) {
-            QMetaObject::invokeMethod(this, &WExtImageCaptureSourceV1Impl::handleRenderEnd, Qt::AutoConnection);
-        }
-    }
-    
+    // Nothing changed, the next surface commit will queue the frame event
+    if (!m_damageIsUnknown && m_damage.isEmpty())
+        return;
+
+    queueFrame();
     qCDebug(qLcImageCapture) << "Scheduled frame capture";
 }
 
+int WExtImageCaptureSourceV1Impl::maxFps() const
+{
+    return m_maxFps;
+}
+
+void WExtImageCaptureSourceV1Impl::setMaxFps(int fps)
+{
+    fps = qMax(0, fps);
+    if (m_maxFps == fps)
+        return;
+
+    m_maxFps = fps;
+    // The pending frame maybe waiting for the old interval
+    if (m_frameTimer->isActive()) {
+        m_frameTimer->stop();
+        queueFrame();
+    }
+}
+
+void WExtImageCaptureSourceV1Impl::queueFrame()
+{
+    // Merge the requests in this event loop, the timer is also used to wait for maxFps
+    if (m_capturing && !m_frameTimer->isActive())
+        m_frameTimer->start(0);
+}
+
+void WExtImageCaptureSourceV1Impl::addDamage(const QRegion &damage)
+{
+    if (!m_damageIsUnknown)
+        m_damage += damage;
+}
+
+void WExtImageCaptureSourceV1Impl::markDamageUnknown()
+{
+    m_damageIsUnknown = true;
+    m_damage = QRegion();
+}
+
 void WExtImageCaptureSourceV1Impl::handleRenderEnd()
 {
-    qCDebug(qLcImageCapture) << "WExtImageCaptureSourceV1Impl::handleRenderEnd() - triggering frame event";
-    
     if (!m_capturing) {
-        qCWarning(qLcImageCapture) << "handleRenderEnd called but not capturing";
+        qCDebug(qLcImageCapture) << "handleRenderEnd called but not capturing";
         return;
     }
-    
-    // Get surface size and validate it
-    QSize surfaceSize = m_surfaceContent->size().toSize();
-    if (surfaceSize.width() <= 0 || surfaceSize.height() <= 0) {
-        qCWarning(qLcImageCapture) << "Invalid surface size for damage region:" << surfaceSize;
+
+    // Nothing changed since the last frame event, the client's frame stays pending
+    if (!m_damageIsUnknown && m_damage.isEmpty())
         return;
+
+    if (m_maxFps > 0 && m_lastFrameTimer.isValid()) {
+        const qint64 interval = 1000 / m_maxFps;
+        const qint64 elapsed = m_lastFrameTimer.elapsed();
+        if (elapsed < interval) {
+            // Keep the damage, it's sent when the timer is timeout
+            if (!m_frameTimer->isActive())
+                m_frameTimer->start(interval - elapsed);
+            return;
+        }
     }
-    
-    // Create damage region with RAII
-    WPixmanRegion fullDamage(0, 0, surfaceSize.width(), surfaceSize.height());
-    
-    // Create frame event and Q_EMIT
+    m_frameTimer->stop();
+
+    QRect bounds(0, 0, handle()->width, handle()->height);
+    if (bounds.isEmpty())
+        bounds = QRect(QPoint(0, 0), m_surfaceContent ? m_surfaceContent->size().toSize() : QSize());
+    if (bounds.isEmpty()) {
+        qCWarning(qLcImageCapture) << "Invalid frame size for damage region:" << bounds.size();
+        return;
+    }
+
+    WPixmanRegion damage;
+    const QRegion region = m_damageIsUnknown ? QRegion(bounds) : m_damage.intersected(bounds);
+    WTools::toPixmanRegion(region, damage);
+
+    m_damage = QRegion();
+    m_damageIsUnknown = false;
+    m_lastFrameTimer.restart();
+
     wlr_ext_image_capture_source_v1_frame_event event {
-        .damage = fullDamage.get(),
+        .damage = damage.get(),
     };
     wl_signal_emit_mutable(&handle()->events.frame, &event);
-    
-    qCDebug(qLcImageCapture) << "Frame event emitted with damage region:" << surfaceSize;
+
+    qCDebug(qLcImageCapture) << "Frame event emitted with damage region:" << region.boundingRect();
 }
 
 void WExtImageCaptureSourceV1Impl::copy_frame(wlr_ext_image_copy_capture_frame_v1 *dst_frame, 
@@ -300,7 +575,10 @@ void WExtImageCaptureSourceV1Impl::copy_frame(wlr_ext_image_copy_capture_frame_v
         return;
     }
 
-    auto buffer = textureProvider->qwBuffer();
+    // The latest committed buffer, the texture provider is only updated when the surface is rendered
+    auto buffer = m_surfaceContent->surface() ? m_surfaceContent->surface()->buffer() : nullptr;
+    if (!buffer)
+        buffer = textureProvider->qwBuffer();
     if (!buffer || !buffer->handle()) {
         qCWarning(qLcImageCapture) << "No internal buffer available";
         qw_ext_image_copy_capture_frame_v1::from(dst_frame)->fail(EXT_IMAGE_COPY_CAPTURE_FRAME_V1_FAILURE_REASON_UNKNOWN);
@@ -377,8 +655,9 @@ void WExtImageCaptureSourceV1Impl::copy_frame(wlr_ext_image_copy_capture_frame_v
         qCDebug(qLcImageCapture) << "Buffer size now matches after constraint update, proceeding with copy";
     }
 
-    // Use wlroots image copy function with validated buffers
-    bool success = qw_ext_image_copy_capture_frame_v1::copy_buffer(dst_frame, src, renderer->handle());
+    // Copy through the hub, the shm frames of the clients copying the same buffer share one read back
+    bool success = m_hub ? m_hub->copy(dst_frame, src, renderer->handle())
+                         : qw_ext_image_copy_capture_frame_v1::copy_buffer(dst_frame, src, renderer->handle());
     qCDebug(qLcImageCapture) << "Copy result:" << success;
     
     if (success) {
@@ -7,9 +7,16 @@
 #include <qwextimagecapturesourcev1interface.h>
 
 #include <QObject>
+#include <QRegion>
+#include <QElapsedTimer>
+#include <QPointer>
 
 Q_DECLARE_LOGGING_CATEGORY(qLcImageCapture)
 
+QT_BEGIN_NAMESPACE
+class QTimer;
+QT_END_NAMESPACE
+
 QW_BEGIN_NAMESPACE
 class qw_buffer;
 QW_END_NAMESPACE
@@ -18,6 +25,7 @@ WAYLIB_SERVER_BEGIN_NAMESPACE
 
 class WSurfaceItemContent;
 class WOutput;
+class WImageCaptureHub;
 
 class WAYLIB_SERVER_EXPORT WExtImageCaptureSourceV1Impl : public QObject, public QW_NAMESPACE::qw_ext_image_capture_source_v1_interface
 {
@@ -33,14 +41,31 @@ public:
                  wlr_ext_image_capture_source_v1_frame_event *frame_event);
     QW_INTERFACE(get_pointer_cursor, wlr_ext_image_capture_source_v1_cursor *, wlr_seat *seat);
 
+    // The max frame rate of this capture session, 0 means no limit. It's
+    // WAYLIB_IMAGE_CAPTURE_MAX_FPS by default.
+    int maxFps() const;
+    void setMaxFps(int fps);
+
 private Q_SLOTS:
     void handleRenderEnd();
 
 private:
+    friend class WImageCaptureHub;
+
+    void addDamage(const QRegion &damage);
+    void markDamageUnknown();
+    void queueFrame();
+
     QPointer<WSurfaceItemContent> m_surfaceContent;
     WOutput *m_output;
     bool m_capturing;
-    QMetaObject::Connection m_renderEndConnection;
+    WImageCaptureHub *m_hub;
+    // the damage in the buffer coordinates since the last frame event
+    QRegion m_damage;
+    bool m_damageIsUnknown;
+    int m_maxFps;
+    QElapsedTimer m_lastFrameTimer;
+    QTimer *m_frameTimer;
 };
 
 WAYLIB_SERVER_END_NAMESPACE
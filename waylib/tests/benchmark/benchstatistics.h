@@ -0,0 +1,26 @@
+// Copyright (C) 2026 UnionTech Software Technology Co., Ltd.
+// SPDX-License-Identifier: Apache-2.0 OR LGPL-3.0-only OR GPL-2.0-only OR GPL-3.0-only
+
+#pragma once
+
+#include <QList>
+
+#include <algorithm>
+
+inline qint64 percentile(QList<qint64> list, double p)
+{
+    if (list.isEmpty())
+        return 0;
+    std::sort(list.begin(), list.end());
+    return list.at(qMin<qsizetype>(list.size() - 1, list.size() * p));
+}
+
+inline qint64 average(const QList<qint64> &list)
+{
+    if (list.isEmpty())
+        return 0;
+    qint64 sum = 0;
+    for (auto i : list)
+        sum += i;
+    return sum / list.size();
+}
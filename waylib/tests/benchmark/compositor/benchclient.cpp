@@ -0,0 +1,271 @@
+// Copyright (C) 2026 UnionTech Software Technology Co., Ltd.
+// SPDX-License-Identifier: Apache-2.0 OR LGPL-3.0-only OR GPL-2.0-only OR GPL-3.0-only
+
+#include "benchclient.h"
+
+#include "xdg-shell-client-protocol.h"
+
+#include <wayland-client.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+
+#include <poll.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+const wl_registry_listener BenchClient::registryListener = {
+    .global = BenchClient::handleGlobal,
+    .global_remove = BenchClient::handleGlobalRemove,
+};
+
+const xdg_wm_base_listener BenchClient::wmBaseListener = {
+    .ping = BenchClient::handlePing,
+};
+
+const xdg_surface_listener BenchClient::xdgSurfaceListener = {
+    .configure = BenchClient::handleSurfaceConfigure,
+};
+
+const wl_buffer_listener BenchClient::bufferListener = {
+    .release = BenchClient::handleBufferRelease,
+};
+
+BenchClient::BenchClient(int fd, const QSize &size, int rate)
+    : m_fd(fd)
+    , m_size(size)
+    , m_rate(std::max(1, rate))
+{
+
+}
+
+BenchClient::~BenchClient()
+{
+    stop();
+}
+
+void BenchClient::start()
+{
+    m_running = true;
+    m_thread = std::thread(&BenchClient::run, this);
+}
+
+void BenchClient::stop()
+{
+    m_running = false;
+    if (m_thread.joinable())
+        m_thread.join();
+}
+
+void BenchClient::run()
+{
+    if (!init()) {
+        fprintf(stderr, "Failed to initialize the benchmark client\n");
+        cleanup();
+        return;
+    }
+
+    const auto interval = std::chrono::nanoseconds(1000000000 / m_rate);
+    auto next = Clock::now();
+    quint32 frame = 0;
+
+    while (m_running) {
+        commitFrame(frame++);
+        next += interval;
+        // Don't catch up the frames missed
+        if (Clock::now() - next > interval)
+            next = Clock::now();
+        if (!dispatchUntil(next))
+            break;
+    }
+
+    cleanup();
+}
+
+// Returns false if the connection is broken
+bool BenchClient::dispatchUntil(Clock::time_point deadline)
+{
+    while (m_running) {
+        const auto now = Clock::now();
+        if (now >= deadline)
+            return true;
+
+        wl_display_flush(m_display);
+        while (wl_display_prepare_read(m_display) != 0)
+            wl_display_dispatch_pending(m_display);
+
+        pollfd pfd = { wl_display_get_fd(m_display), POLLIN, 0 };
+        const auto wait = std::chrono::duration_cast<std::chrono::nanoseconds>(deadline - now);
+        const timespec timeout = { static_cast<time_t>(wait.count() / 1000000000),
+                                   static_cast<long>(wait.count() % 1000000000) };
+        if (ppoll(&pfd, 1, &timeout, nullptr) > 0)
+            wl_display_read_events(m_display);
+        else
+            wl_display_cancel_read(m_display);
+
+        if (wl_display_dispatch_pending(m_display) < 0)
+            return false;
+    }
+
+    return true;
+}
+
+bool BenchClient::init()
+{
+    m_display = wl_display_connect_to_fd(m_fd);
+    // The display owns the fd, it's closed even if failed to connect
+    m_fd = -1;
+    if (!m_display)
+        return false;
+
+    m_registry = wl_display_get_registry(m_display);
+    wl_registry_add_listener(m_registry, &registryListener, this);
+    wl_display_roundtrip(m_display);
+    if (!m_compositor || !m_shm || !m_wmBase)
+        return false;
+
+    xdg_wm_base_add_listener(m_wmBase, &wmBaseListener, this);
+    m_surface = wl_compositor_create_surface(m_compositor);
+    m_xdgSurface = xdg_wm_base_get_xdg_surface(m_wmBase, m_surface);
+    xdg_surface_add_listener(m_xdgSurface, &xdgSurfaceListener, this);
+    m_toplevel = xdg_surface_get_toplevel(m_xdgSurface);
+    xdg_toplevel_set_title(m_toplevel, "bench-client");
+    wl_surface_commit(m_surface);
+
+    while (!m_configured && m_running) {
+        if (!dispatchUntil(Clock::now() + std::chrono::milliseconds(100)))
+            return false;
+    }
+    if (!m_configured)
+        return false;
+
+    const int stride = m_size.width() * 4;
+    const size_t bufferSize = size_t(stride) * m_size.height();
+    m_memorySize = bufferSize * 2;
+
+    const int fd = memfd_create("bench-client", MFD_CLOEXEC);
+    if (fd < 0)
+        return false;
+    if (ftruncate(fd, m_memorySize) < 0) {
+        close(fd);
+        return false;
+    }
+    m_memory = mmap(nullptr, m_memorySize, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    if (m_memory == MAP_FAILED) {
+        m_memory = nullptr;
+        close(fd);
+        return false;
+    }
+
+    auto pool = wl_shm_create_pool(m_shm, fd, m_memorySize);
+    for (int i = 0; i < 2; ++i) {
+        auto &buffer = m_buffers[i];
+        buffer.buffer = wl_shm_pool_create_buffer(pool, i * bufferSize,
+                                                  m_size.width(), m_size.height(),
+                                                  stride, WL_SHM_FORMAT_XRGB8888);
+        buffer.data = static_cast<char*>(m_memory) + i * bufferSize;
+        wl_buffer_add_listener(buffer.buffer, &bufferListener, &buffer);
+    }
+    wl_shm_pool_destroy(pool);
+    close(fd);
+
+    return true;
+}
+
+void BenchClient::cleanup()
+{
+    if (!m_display) {
+        if (m_fd >= 0)
+            close(m_fd);
+        m_fd = -1;
+        return;
+    }
+
+    for (auto &buffer : m_buffers) {
+        if (buffer.buffer)
+            wl_buffer_destroy(buffer.buffer);
+        buffer = {};
+    }
+    if (m_memory)
+        munmap(m_memory, m_memorySize);
+    m_memory = nullptr;
+
+    if (m_toplevel)
+        xdg_toplevel_destroy(m_toplevel);
+    if (m_xdgSurface)
+        xdg_surface_destroy(m_xdgSurface);
+    if (m_surface)
+        wl_surface_destroy(m_surface);
+    if (m_wmBase)
+        xdg_wm_base_destroy(m_wmBase);
+    if (m_shm)
+        wl_shm_destroy(m_shm);
+    if (m_compositor)
+        wl_compositor_destroy(m_compositor);
+    if (m_registry)
+        wl_registry_destroy(m_registry);
+
+    wl_display_flush(m_display);
+    wl_display_disconnect(m_display);
+    m_display = nullptr;
+}
+
+void BenchClient::commitFrame(quint32 frame)
+{
+    auto buffer = std::find_if(std::begin(m_buffers), std::end(m_buffers), [] (const Buffer &b) {
+        return !b.busy;
+    });
+    if (buffer == std::end(m_buffers)) {
+        m_skippedFrames.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+
+    const quint32 color = 0xff000000 | ((frame * 0x030507) & 0xffffff);
+    std::fill_n(static_cast<quint32*>(buffer->data), m_size.width() * m_size.height(), color);
+
+    wl_surface_attach(m_surface, buffer->buffer, 0, 0);
+    wl_surface_damage_buffer(m_surface, 0, 0, m_size.width(), m_size.height());
+    wl_surface_commit(m_surface);
+    buffer->busy = true;
+    m_commits.fetch_add(1, std::memory_order_relaxed);
+}
+
+void BenchClient::handleGlobal(void *data, wl_registry *registry, uint32_t name,
+                               const char *interface, uint32_t version)
+{
+    auto client = static_cast<BenchClient*>(data);
+    if (strcmp(interface, wl_compositor_interface.name) == 0) {
+        client->m_compositor = static_cast<wl_compositor*>(
+            wl_registry_bind(registry, name, &wl_compositor_interface, std::min(version, 4u)));
+    } else if (strcmp(interface, wl_shm_interface.name) == 0) {
+        client->m_shm = static_cast<wl_shm*>(
+            wl_registry_bind(registry, name, &wl_shm_interface, 1));
+    } else if (strcmp(interface, xdg_wm_base_interface.name) == 0) {
+        client->m_wmBase = static_cast<xdg_wm_base*>(
+            wl_registry_bind(registry, name, &xdg_wm_base_interface, 1));
+    }
+}
+
+void BenchClient::handleGlobalRemove(void *, wl_registry *, uint32_t)
+{
+
+}
+
+void BenchClient::handlePing(void *, xdg_wm_base *wmBase, uint32_t serial)
+{
+    xdg_wm_base_pong(wmBase, serial);
+}
+
+void BenchClient::handleSurfaceConfigure(void *data, xdg_surface *surface, uint32_t serial)
+{
+    auto client = static_cast<BenchClient*>(data);
+    xdg_surface_ack_configure(surface, serial);
+    client->m_configured = true;
+}
+
+void BenchClient::handleBufferRelease(void *data, wl_buffer *)
+{
+    static_cast<Buffer*>(data)->busy = false;
+}
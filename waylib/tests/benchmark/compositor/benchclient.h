@@ -0,0 +1,95 @@
+// Copyright (C) 2026 UnionTech Software Technology Co., Ltd.
+// SPDX-License-Identifier: Apache-2.0 OR LGPL-3.0-only OR GPL-2.0-only OR GPL-3.0-only
+
+#pragma once
+
+#include <QSize>
+
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+struct wl_display;
+struct wl_registry;
+struct wl_registry_listener;
+struct wl_buffer_listener;
+struct xdg_wm_base_listener;
+struct xdg_surface_listener;
+struct wl_compositor;
+struct wl_shm;
+struct wl_surface;
+struct wl_buffer;
+struct xdg_wm_base;
+struct xdg_surface;
+struct xdg_toplevel;
+
+// A xdg toplevel client runs in its own thread, commits a new shm buffer of
+// the size at the rate, every frame repaints the whole buffer.
+class BenchClient
+{
+public:
+    // The fd is the client side of a socket pair
+    BenchClient(int fd, const QSize &size, int rate);
+    ~BenchClient();
+
+    void start();
+    void stop();
+
+    inline quint64 commits() const {
+        return m_commits.load(std::memory_order_relaxed);
+    }
+    // The frames skipped because the compositor doesn't release the buffers
+    inline quint64 skippedFrames() const {
+        return m_skippedFrames.load(std::memory_order_relaxed);
+    }
+
+private:
+    struct Buffer {
+        wl_buffer *buffer = nullptr;
+        void *data = nullptr;
+        bool busy = false;
+    };
+
+    using Clock = std::chrono::steady_clock;
+
+    void run();
+    bool dispatchUntil(Clock::time_point deadline);
+    bool init();
+    void cleanup();
+    void commitFrame(quint32 frame);
+
+    static void handleGlobal(void *data, wl_registry *registry, uint32_t name,
+                             const char *interface, uint32_t version);
+    static void handleGlobalRemove(void *data, wl_registry *registry, uint32_t name);
+    static void handlePing(void *data, xdg_wm_base *wmBase, uint32_t serial);
+    static void handleSurfaceConfigure(void *data, xdg_surface *surface, uint32_t serial);
+    static void handleBufferRelease(void *data, wl_buffer *buffer);
+
+    static const wl_registry_listener registryListener;
+    static const xdg_wm_base_listener wmBaseListener;
+    static const xdg_surface_listener xdgSurfaceListener;
+    static const wl_buffer_listener bufferListener;
+
+    int m_fd;
+    QSize m_size;
+    int m_rate;
+
+    wl_display *m_display = nullptr;
+    wl_registry *m_registry = nullptr;
+    wl_compositor *m_compositor = nullptr;
+    wl_shm *m_shm = nullptr;
+    xdg_wm_base *m_wmBase = nullptr;
+    wl_surface *m_surface = nullptr;
+    xdg_surface *m_xdgSurface = nullptr;
+    xdg_toplevel *m_toplevel = nullptr;
+    bool m_configured = false;
+
+    void *m_memory = nullptr;
+    size_t m_memorySize = 0;
+    Buffer m_buffers[2];
+
+    std::thread m_thread;
+    std::atomic_bool m_running = false;
+    std::atomic<quint64> m_commits = 0;
+    std::atomic<quint64> m_skippedFrames = 0;
+};
@@ -0,0 +1,461 @@
+// Copyright (C) 2026 UnionTech Software Technology Co., Ltd.
+// SPDX-License-Identifier: Apache-2.0 OR LGPL-3.0-only OR GPL-2.0-only OR GPL-3.0-only
+
+// Boot a compositor on the headless backend with the pixman renderer, connect
+// synthetic shm clients and replay the pointer motions, then report the
+// frame rate and the time of the render stages, the latency from the client
+// commit and the input to the output commit, and the memory usage. e.g.
+//   bench_compositor --clients 16 --rate 60 --size 800x600 --seconds 10
+// The input file has a motion per line: "<msec> <dx> <dy>", it's replayed in a
+// loop, the motions are moving in a circle if not set.
+
+#include "benchclient.h"
+#include "benchstatistics.h"
+
+#include <WServer>
+#include <WBackend>
+#include <WOutput>
+#include <WSeat>
+#include <WCursor>
+#include <WXdgShell>
+#include <winputdevice.h>
+#include <woutputlayout.h>
+#include <wrenderhelper.h>
+#include <woutputrenderwindow.h>
+#include <woutputviewport.h>
+#include <wsurface.h>
+#include <wxdgtoplevelsurface.h>
+#include <wxdgtoplevelsurfaceitem.h>
+
+#include <qwbackend.h>
+#include <qwcompositor.h>
+#include <qwsubcompositor.h>
+#include <qwdisplay.h>
+#include <qwoutput.h>
+#include <qwlogging.h>
+#include <qwrenderer.h>
+#include <qwallocator.h>
+#include <qwinputdevice.h>
+
+#include <QGuiApplication>
+#include <QCommandLineParser>
+#include <QQuickItem>
+#include <QSGSimpleRectNode>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QTimer>
+
+#include <algorithm>
+#include <cmath>
+#include <ctime>
+
+#include <sys/socket.h>
+#include <wayland-server-core.h>
+
+extern "C" {
+#include <wlr/interfaces/wlr_pointer.h>
+}
+
+WAYLIB_SERVER_USE_NAMESPACE
+QW_USE_NAMESPACE
+
+static const wlr_pointer_impl benchPointerImpl = {
+    .name = "bench-pointer",
+};
+
+struct InputMotion
+{
+    int msec = 0;
+    double dx = 0;
+    double dy = 0;
+};
+
+// Stands for the cursor image, the replayed motions move it and damage the outputs
+class CursorItem : public QQuickItem
+{
+public:
+    explicit CursorItem(QQuickItem *parent)
+        : QQuickItem(parent)
+    {
+        setFlag(ItemHasContents);
+        setSize(QSizeF(16, 16));
+        setZ(1);
+    }
+
+protected:
+    QSGNode *updatePaintNode(QSGNode *oldNode, UpdatePaintNodeData *) override
+    {
+        if (oldNode)
+            return oldNode;
+        return new QSGSimpleRectNode(boundingRect(), Qt::white);
+    }
+};
+
+struct OutputStatistics
+{
+    WOutput *output = nullptr;
+    WOutputViewport *viewport = nullptr;
+    // the commit time of the surfaces shown on the output, waiting for its next frame
+    QHash<WSurface*, qint64> pendingCommits;
+    quint64 frames = 0;
+    // the render stages of WOutputRenderWindow::FrameTiming
+    QList<qint64> polishTimes;
+    QList<qint64> syncTimes;
+    QList<qint64> renderTimes;
+    QList<qint64> commitTimes;
+};
+
+static qint64 monotonicNsecs()
+{
+    timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return qint64(now.tv_sec) * 1000000000 + now.tv_nsec;
+}
+
+// In kB, e.g. VmRSS or VmHWM
+static qint64 memoryStatus(const QByteArray &field)
+{
+    QFile file("/proc/self/status");
+    if (!file.open(QIODevice::ReadOnly))
+        return 0;
+
+    const QByteArray prefix = field + ':';
+    while (!file.atEnd()) {
+        const QByteArray line = file.readLine();
+        if (line.startsWith(prefix))
+            return line.mid(prefix.size()).trimmed().split(' ').first().toLongLong();
+    }
+    return 0;
+}
+
+static QList<InputMotion> loadInput(const QString &fileName, int rate)
+{
+    QList<InputMotion> motions;
+    if (!fileName.isEmpty()) {
+        QFile file(fileName);
+        if (!file.open(QIODevice::ReadOnly | QIODevice::Text))
+            qFatal("Failed to open the input file %s", qPrintable(fileName));
+        while (!file.atEnd()) {
+            const auto fields = file.readLine().simplified().split(' ');
+            if (fields.size() != 3)
+                continue;
+            motions.append({ fields[0].toInt(), fields[1].toDouble(), fields[2].toDouble() });
+        }
+        return motions;
+    }
+
+    // One second of the motions in a circle
+    for (int i = 0; i < rate; ++i) {
+        const double angle = 2 * M_PI * i / rate;
+        motions.append({ i * 1000 / rate, std::cos(angle) * 4, std::sin(angle) * 4 });
+    }
+    return motions;
+}
+
+int main(int argc, char *argv[])
+{
+    QCommandLineParser parser;
+    QCommandLineOption outputsOption("outputs", "The number of the headless outputs (1-4).", "count", "1");
+    QCommandLineOption clientsOption("clients", "The number of the clients.", "count", "8");
+    QCommandLineOption rateOption("rate", "The commits per second of every client.", "hz", "60");
+    QCommandLineOption sizeOption("size", "The buffer size of the clients.", "WxH", "640x480");
+    QCommandLineOption inputRateOption("input-rate", "The pointer motions per second, 0 to disable.", "hz", "1000");
+    QCommandLineOption inputOption("input", "The recorded pointer motions to replay.", "file");
+    QCommandLineOption secondsOption("seconds", "The duration of the benchmark.", "seconds", "5");
+    parser.addOptions({outputsOption, clientsOption, rateOption, sizeOption,
+                       inputRateOption, inputOption, secondsOption});
+    parser.addHelpOption();
+
+    QStringList arguments;
+    for (int i = 0; i < argc; ++i)
+        arguments << QString::fromLocal8Bit(argv[i]);
+    parser.process(arguments);
+
+    const int outputCount = qBound(1, parser.value(outputsOption).toInt(), 4);
+    const int clientCount = qMax(0, parser.value(clientsOption).toInt());
+    const int rate = qMax(1, parser.value(rateOption).toInt());
+    const int inputRate = qMax(0, parser.value(inputRateOption).toInt());
+    const int seconds = qMax(1, parser.value(secondsOption).toInt());
+    const auto sizeValue = parser.value(sizeOption).split('x');
+    const QSize clientSize = sizeValue.size() == 2
+        ? QSize(sizeValue[0].toInt(), sizeValue[1].toInt()) : QSize();
+    if (clientSize.isEmpty())
+        qFatal("Invalid client size %s", qPrintable(parser.value(sizeOption)));
+
+    const bool replayInput = inputRate > 0 || parser.isSet(inputOption);
+    const auto motions = replayInput ? loadInput(parser.value(inputOption), qMax(1, inputRate))
+                                     : QList<InputMotion>();
+    const int motionLoopMsec = motions.isEmpty() ? 0 : motions.last().msec + 1;
+
+    qputenv("WLR_BACKENDS", "headless");
+    qputenv("WLR_HEADLESS_OUTPUTS", QByteArray::number(outputCount));
+    if (!qEnvironmentVariableIsSet("WLR_RENDERER"))
+        qputenv("WLR_RENDERER", "pixman");
+
+    qw_log::init();
+    WServer::initializeQPA();
+    QGuiApplication::setQuitOnLastWindowClosed(false);
+    QGuiApplication app(argc, argv);
+
+    WServer server;
+    auto backend = server.attach<WBackend>();
+    auto seat = server.attach<WSeat>();
+    server.start();
+
+    auto renderer = WRenderHelper::createRenderer(backend->handle());
+    if (!renderer)
+        qFatal("Failed to create renderer");
+    auto allocator = qw_allocator::autocreate(*backend->handle(), *renderer);
+    renderer->init_wl_display(*server.handle());
+    qw_compositor::create(*server.handle(), 6, *renderer);
+    qw_subcompositor::create(*server.handle());
+    auto xdgShell = server.attach<WXdgShell>(5);
+
+    WOutputRenderWindow window;
+    auto layout = new WOutputLayout(&server);
+    auto cursor = new WCursor(&window);
+    cursor->setEventWindow(&window);
+    cursor->setLayout(layout);
+    seat->setCursor(cursor);
+    auto cursorItem = new CursorItem(window.contentItem());
+    QObject::connect(cursor, &WCursor::positionChanged, cursorItem, [cursor, cursorItem] {
+        cursorItem->setPosition(cursor->position());
+    });
+
+    // The measuring starts after the clients are connected
+    bool measuring = false;
+    QList<OutputStatistics*> statistics;
+    QList<qint64> commitLatencies;
+    qint64 pendingInput = -1;
+    QList<qint64> inputLatencies;
+    quint64 inputEvents = 0;
+    int x = 0;
+
+    QObject::connect(backend, &WBackend::outputAdded, &window, [&] (WOutput *output) {
+        auto s = new OutputStatistics;
+        s->output = output;
+        statistics.append(s);
+
+        s->viewport = new WOutputViewport(window.contentItem());
+        s->viewport->setOutput(output);
+        s->viewport->setX(x);
+        layout->add(output, QPoint(x, 0));
+        x += output->size().width();
+    });
+
+    QObject::connect(&window, &WOutputRenderWindow::outputViewportInitialized,
+                     &window, [] (WOutputViewport *viewport) {
+        auto qwoutput = viewport->output()->handle();
+        qw_output_state newState;
+        if (!qwoutput->handle()->current_mode) {
+            if (auto mode = qwoutput->preferred_mode())
+                newState.set_mode(mode);
+        }
+        newState.set_enabled(true);
+        if (!qwoutput->commit_state(newState))
+            qCritical("commit failed on output %s", qwoutput->handle()->name);
+    });
+
+    QHash<WXdgToplevelSurface*, WXdgToplevelSurfaceItem*> surfaceItems;
+    QObject::connect(xdgShell, &WXdgShell::toplevelSurfaceAdded,
+                     &window, [&] (WXdgToplevelSurface *surface) {
+        const int index = surfaceItems.size();
+        auto item = new WXdgToplevelSurfaceItem(window.contentItem());
+        item->setShellSurface(surface);
+        item->setPosition(QPointF((index * 48) % 1280, (index * 32) % 600));
+        surfaceItems.insert(surface, item);
+
+        auto wsurface = surface->surface();
+        QObject::connect(wsurface, &WSurface::commit, item, [&, item, wsurface] {
+            if (!measuring)
+                return;
+            const qint64 now = monotonicNsecs();
+            const QRectF rect = item->mapRectToScene(item->boundingRect());
+            for (auto s : std::as_const(statistics)) {
+                const QRectF outputRect = s->viewport->mapRectToScene(s->viewport->boundingRect());
+                if (outputRect.intersects(rect) && !s->pendingCommits.contains(wsurface))
+                    s->pendingCommits.insert(wsurface, now);
+            }
+        });
+    });
+
+    QObject::connect(xdgShell, &WXdgShell::toplevelSurfaceRemoved,
+                     &window, [&] (WXdgToplevelSurface *surface) {
+        for (auto s : std::as_const(statistics))
+            s->pendingCommits.remove(surface->surface());
+        delete surfaceItems.take(surface);
+    });
+
+    QObject::connect(&window, &WOutputRenderWindow::renderEnd,
+                     &window, [&] (const QList<QPointer<WOutput>> &committedOutputs) {
+        if (!measuring || committedOutputs.isEmpty())
+            return;
+
+        const qint64 now = monotonicNsecs();
+        for (auto s : std::as_const(statistics)) {
+            if (!committedOutputs.contains(s->output))
+                continue;
+
+            ++s->frames;
+            const auto timings = window.frameTimings(s->viewport, 1);
+            if (timings.isEmpty())
+                continue;
+            const auto &frame = timings.first();
+            s->polishTimes.append(frame.syncStart - frame.polishStart);
+            s->syncTimes.append((frame.renderStart ? frame.renderStart : frame.commitStart)
+                                - frame.syncStart);
+            if (frame.renderStart)
+                s->renderTimes.append(frame.renderEnd - frame.renderStart);
+            s->commitTimes.append(frame.commitEnd - frame.commitStart);
+        }
+
+        for (auto s : std::as_const(statistics)) {
+            if (!committedOutputs.contains(s->output))
+                continue;
+
+            for (auto commit : std::as_const(s->pendingCommits))
+                commitLatencies.append(now - commit);
+            s->pendingCommits.clear();
+
+            // Only the output showing the cursor presents the motions
+            const QRectF outputRect = s->viewport->mapRectToScene(s->viewport->boundingRect());
+            if (pendingInput >= 0 && outputRect.contains(cursor->position())) {
+                inputLatencies.append(now - pendingInput);
+                pendingInput = -1;
+            }
+        }
+    });
+
+    window.init(renderer, allocator);
+    backend->handle()->start();
+
+    wlr_pointer pointer;
+    wlr_pointer_init(&pointer, &benchPointerImpl, "bench-pointer");
+    auto device = new WInputDevice(qw_input_device::from(&pointer.base));
+    seat->attachInputDevice(device);
+
+    QList<BenchClient*> clients;
+    for (int i = 0; i < clientCount; ++i) {
+        int fds[2];
+        if (socketpair(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0, fds) < 0)
+            qFatal("Failed to create the socket pair");
+        if (!wl_client_create(server.handle()->handle(), fds[0]))
+            qFatal("Failed to create the client");
+        auto client = new BenchClient(fds[1], clientSize, rate);
+        client->start();
+        clients.append(client);
+    }
+
+    // Replay the motions by the time elapsed, as libinput reads them in batch
+    QElapsedTimer inputTimer;
+    QTimer replayTimer;
+    replayTimer.setTimerType(Qt::PreciseTimer);
+    replayTimer.setInterval(4);
+    qsizetype nextMotion = 0;
+    qint64 loopStart = 0;
+    QObject::connect(&replayTimer, &QTimer::timeout, &app, [&] {
+        const qint64 elapsed = inputTimer.elapsed();
+        bool sent = false;
+        while (loopStart + motions.at(nextMotion).msec <= elapsed) {
+            const auto &motion = motions.at(nextMotion);
+            wlr_pointer_motion_event event = {};
+            event.pointer = &pointer;
+            event.time_msec = static_cast<uint32_t>(loopStart + motion.msec);
+            event.delta_x = event.unaccel_dx = motion.dx;
+            event.delta_y = event.unaccel_dy = motion.dy;
+            wl_signal_emit_mutable(&pointer.events.motion, &event);
+            wl_signal_emit_mutable(&pointer.events.frame, &pointer);
+            ++inputEvents;
+            sent = true;
+
+            if (++nextMotion == motions.size()) {
+                nextMotion = 0;
+                loopStart += motionLoopMsec;
+            }
+        }
+
+        if (sent && pendingInput < 0)
+            pendingInput = monotonicNsecs();
+    });
+
+    QElapsedTimer measureTimer;
+    auto beginMeasure = [&] {
+        measuring = true;
+        measureTimer.start();
+        for (auto s : std::as_const(statistics)) {
+            s->pendingCommits.clear();
+            s->frames = 0;
+            s->polishTimes.clear();
+            s->syncTimes.clear();
+            s->renderTimes.clear();
+            s->commitTimes.clear();
+        }
+        if (!motions.isEmpty()) {
+            cursor->setPosition(QPointF(640, 360));
+            inputTimer.start();
+            replayTimer.start();
+        }
+    };
+
+    auto endMeasure = [&] {
+        replayTimer.stop();
+        measuring = false;
+        const double duration = measureTimer.nsecsElapsed() / 1e9;
+
+        printf("clients %d, rate %d Hz, size %dx%d, input %llu motions, %.1f s\n",
+               clientCount, rate, clientSize.width(), clientSize.height(),
+               static_cast<unsigned long long>(inputEvents), duration);
+
+        printf("%-12s %8s %8s %12s %12s %12s %12s %12s\n", "output", "frames", "fps",
+               "polish(us)", "sync(us)", "render(us)", "render p99", "commit(us)");
+        for (auto s : std::as_const(statistics)) {
+            printf("%-12s %8llu %8.1f %12lld %12lld %12lld %12lld %12lld\n",
+                   qPrintable(s->output->name()),
+                   static_cast<unsigned long long>(s->frames),
+                   s->frames / duration,
+                   static_cast<long long>(average(s->polishTimes) / 1000),
+                   static_cast<long long>(average(s->syncTimes) / 1000),
+                   static_cast<long long>(average(s->renderTimes) / 1000),
+                   static_cast<long long>(percentile(s->renderTimes, 0.99) / 1000),
+                   static_cast<long long>(average(s->commitTimes) / 1000));
+        }
+
+        quint64 commits = 0;
+        quint64 skipped = 0;
+        for (auto client : std::as_const(clients)) {
+            commits += client->commits();
+            skipped += client->skippedFrames();
+        }
+
+        printf("%-24s %12s %12s\n", "latency", "average(us)", "p99(us)");
+        printf("%-24s %12lld %12lld\n", "client commit to output",
+               static_cast<long long>(average(commitLatencies) / 1000),
+               static_cast<long long>(percentile(commitLatencies, 0.99) / 1000));
+        printf("%-24s %12lld %12lld\n", "input to output",
+               static_cast<long long>(average(inputLatencies) / 1000),
+               static_cast<long long>(percentile(inputLatencies, 0.99) / 1000));
+        printf("client commits %llu, skipped frames %llu (buffer not released)\n",
+               static_cast<unsigned long long>(commits),
+               static_cast<unsigned long long>(skipped));
+        printf("RSS %lld kB, peak %lld kB (including the clients)\n",
+               static_cast<long long>(memoryStatus("VmRSS")),
+               static_cast<long long>(memoryStatus("VmHWM")));
+
+        for (auto client : std::as_const(clients))
+            client->stop();
+        qDeleteAll(clients);
+        clients.clear();
+
+        seat->detachInputDevice(device);
+        device->safeDeleteLater();
+        qDeleteAll(statistics);
+        statistics.clear();
+        app.quit();
+    };
+
+    // Wait the outputs are enabled and the clients are mapped
+    QTimer::singleShot(1000, &app, beginMeasure);
+    QTimer::singleShot(1000 + seconds * 1000, &app, endMeasure);
+
+    return app.exec();
+}
@@ -0,0 +1,188 @@
+// Copyright (C) 2026 UnionTech Software Technology Co., Ltd.
+// SPDX-License-Identifier: Apache-2.0 OR LGPL-3.0-only OR GPL-2.0-only OR GPL-3.0-only
+
+// Measure the frame time of every output on the headless backend, every
+// output shows an animation to keep it busy. e.g.
+//   bench_outputs --outputs 4 --seconds 10
+// Set WLR_RENDERER=pixman to measure the software renderer.
+
+#include "benchstatistics.h"
+
+#include <WServer>
+#include <WBackend>
+#include <WOutput>
+#include <wrenderhelper.h>
+#include <woutputrenderwindow.h>
+#include <woutputviewport.h>
+
+#include <qwbackend.h>
+#include <qwoutput.h>
+#include <qwlogging.h>
+#include <qwrenderer.h>
+#include <qwallocator.h>
+
+#include <QGuiApplication>
+#include <QCommandLineParser>
+#include <QQmlEngine>
+#include <QQmlComponent>
+#include <QQuickItem>
+#include <QElapsedTimer>
+#include <QTimer>
+
+#include <algorithm>
+
+WAYLIB_SERVER_USE_NAMESPACE
+QW_USE_NAMESPACE
+
+static const char contentQml[] = R"(
+import QtQuick
+
+Rectangle {
+    color: "black"
+
+    Rectangle {
+        width: parent.width / 4
+        height: width
+        anchors.centerIn: parent
+        color: "red"
+
+        NumberAnimation on rotation {
+            from: 0
+            to: 360
+            duration: 2000
+            loops: Animation.Infinite
+        }
+    }
+}
+)";
+
+struct OutputStatistics
+{
+    WOutput *output = nullptr;
+    qint64 frameBegin = -1;
+    qint64 lastCommit = -1;
+    // from the frame event to the end of the commit
+    QList<qint64> renderTimes;
+    // between the two commits
+    QList<qint64> frameIntervals;
+};
+
+int main(int argc, char *argv[])
+{
+    QCommandLineParser parser;
+    QCommandLineOption outputsOption("outputs", "The number of the headless outputs (1-4).", "count", "1");
+    QCommandLineOption secondsOption("seconds", "The duration of the benchmark.", "seconds", "5");
+    parser.addOptions({outputsOption, secondsOption});
+    parser.addHelpOption();
+
+    QStringList arguments;
+    for (int i = 0; i < argc; ++i)
+        arguments << QString::fromLocal8Bit(argv[i]);
+    parser.process(arguments);
+
+    const int outputCount = qBound(1, parser.value(outputsOption).toInt(), 4);
+    const int seconds = qMax(1, parser.value(secondsOption).toInt());
+
+    qputenv("WLR_BACKENDS", "headless");
+    qputenv("WLR_HEADLESS_OUTPUTS", QByteArray::number(outputCount));
+
+    qw_log::init();
+    WServer::initializeQPA();
+    QGuiApplication::setQuitOnLastWindowClosed(false);
+    QGuiApplication app(argc, argv);
+
+    QQmlEngine engine;
+    QQmlComponent contentComponent(&engine);
+    contentComponent.setData(contentQml, QUrl());
+    if (contentComponent.isError())
+        qFatal("%s", qPrintable(contentComponent.errorString()));
+
+    WServer server;
+    auto backend = server.attach<WBackend>();
+    server.start();
+
+    auto renderer = WRenderHelper::createRenderer(backend->handle());
+    if (!renderer)
+        qFatal("Failed to create renderer");
+    auto allocator = qw_allocator::autocreate(*backend->handle(), *renderer);
+    renderer->init_wl_display(*server.handle());
+
+    WOutputRenderWindow window;
+    QElapsedTimer timer;
+    timer.start();
+    QList<OutputStatistics*> statistics;
+    qreal x = 0;
+
+    QObject::connect(backend, &WBackend::outputAdded, &window, [&] (WOutput *output) {
+        auto s = new OutputStatistics;
+        s->output = output;
+        statistics.append(s);
+
+        // Connect before WOutputRenderWindow, ensure it's called before rendering
+        QObject::connect(output->handle(), &qw_output::notify_frame, &window, [s, &timer] {
+            s->frameBegin = timer.nsecsElapsed();
+        });
+
+        auto content = qobject_cast<QQuickItem*>(contentComponent.create());
+        Q_ASSERT(content);
+        content->setParentItem(window.contentItem());
+        content->setX(x);
+        content->setSize(output->size());
+        x += output->size().width();
+
+        auto viewport = new WOutputViewport(window.contentItem());
+        viewport->setInput(content);
+        viewport->setOutput(output);
+    });
+
+    QObject::connect(&window, &WOutputRenderWindow::outputViewportInitialized,
+                     &window, [] (WOutputViewport *viewport) {
+        auto qwoutput = viewport->output()->handle();
+        qw_output_state newState;
+        if (!qwoutput->handle()->current_mode) {
+            if (auto mode = qwoutput->preferred_mode())
+                newState.set_mode(mode);
+        }
+        newState.set_enabled(true);
+        if (!qwoutput->commit_state(newState))
+            qCritical("commit failed on output %s", qwoutput->handle()->name);
+    });
+
+    QObject::connect(&window, &WOutputRenderWindow::renderEnd,
+                     &window, [&] (const QList<QPointer<WOutput>> &committedOutputs) {
+        const qint64 now = timer.nsecsElapsed();
+        for (auto s : std::as_const(statistics)) {
+            if (!committedOutputs.contains(s->output))
+                continue;
+            if (s->frameBegin >= 0)
+                s->renderTimes.append(now - s->frameBegin);
+            if (s->lastCommit >= 0)
+                s->frameIntervals.append(now - s->lastCommit);
+            s->frameBegin = -1;
+            s->lastCommit = now;
+        }
+    });
+
+    window.init(renderer, allocator);
+    backend->handle()->start();
+
+    QTimer::singleShot(seconds * 1000, &app, [&] {
+        printf("%-12s %8s %8s %12s %12s %12s %12s\n", "output", "frames", "fps",
+               "render(us)", "render p99", "interval(us)", "interval p99");
+        for (auto s : std::as_const(statistics)) {
+            printf("%-12s %8lld %8.1f %12lld %12lld %12lld %12lld\n",
+                   qPrintable(s->output->name()),
+                   static_cast<long long>(s->renderTimes.size()),
+                   s->renderTimes.size() / double(seconds),
+                   static_cast<long long>(average(s->renderTimes) / 1000),
+                   static_cast<long long>(percentile(s->renderTimes, 0.99) / 1000),
+                   static_cast<long long>(average(s->frameIntervals) / 1000),
+                   static_cast<long long>(percentile(s->frameIntervals, 0.99) / 1000));
+        }
+        qDeleteAll(statistics);
+        statistics.clear();
+        app.quit();
+    });
+
+    return app.exec();
+}
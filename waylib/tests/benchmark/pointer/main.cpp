@@ -0,0 +1,226 @@
+// Copyright (C) 2026 UnionTech Software Technology Co., Ltd.
+// SPDX-License-Identifier: Apache-2.0 OR LGPL-3.0-only OR GPL-2.0-only OR GPL-3.0-only
+
+// Replay the pointer motions of a high rate mouse through WCursor and WSeat on
+// the headless backend, with and without the motion coalescing. e.g.
+//   bench_pointer --events 200000 --batch 64
+// The batch is the number of motions read from libinput in one dispatching,
+// a 8 kHz mouse produces about 130 motions in a 16 ms frame.
+
+#include <WServer>
+#include <WBackend>
+#include <WOutput>
+#include <WSeat>
+#include <WCursor>
+#include <winputdevice.h>
+#include <woutputlayout.h>
+#include <wrenderhelper.h>
+#include <woutputrenderwindow.h>
+#include <woutputviewport.h>
+
+#include <qwbackend.h>
+#include <qwoutput.h>
+#include <qwlogging.h>
+#include <qwrenderer.h>
+#include <qwallocator.h>
+#include <qwinputdevice.h>
+
+#include <QGuiApplication>
+#include <QCommandLineParser>
+#include <QQmlEngine>
+#include <QQmlComponent>
+#include <QQuickItem>
+#include <QElapsedTimer>
+#include <QTimer>
+
+#include <cmath>
+#include <ctime>
+
+extern "C" {
+#include <wlr/interfaces/wlr_pointer.h>
+}
+
+WAYLIB_SERVER_USE_NAMESPACE
+QW_USE_NAMESPACE
+
+// Many hover handlers to make the hit-testing of the event delivery measurable
+static const char contentQml[] = R"(
+import QtQuick
+
+Grid {
+    columns: 16
+
+    Repeater {
+        model: 16 * 9
+
+        Rectangle {
+            width: 120
+            height: 120
+            color: hover.hovered ? "red" : "gray"
+
+            HoverHandler {
+                id: hover
+            }
+        }
+    }
+}
+)";
+
+static const wlr_pointer_impl benchPointerImpl = {
+    .name = "bench-pointer",
+};
+
+class MotionCounter : public QObject
+{
+public:
+    using QObject::QObject;
+
+    bool eventFilter(QObject *watched, QEvent *event) override {
+        if (event->type() == QEvent::MouseMove)
+            ++count;
+        return QObject::eventFilter(watched, event);
+    }
+
+    quint64 count = 0;
+};
+
+static qint64 cpuTime()
+{
+    timespec ts;
+    clock_gettime(CLOCK_PROCESS_CPUTIME_ID, &ts);
+    return qint64(ts.tv_sec) * 1000000000 + ts.tv_nsec;
+}
+
+int main(int argc, char *argv[])
+{
+    QCommandLineParser parser;
+    QCommandLineOption eventsOption("events", "The number of the motion events to replay.", "count", "100000");
+    QCommandLineOption batchOption("batch", "The number of the motion events in one dispatching.", "count", "64");
+    parser.addOptions({eventsOption, batchOption});
+    parser.addHelpOption();
+
+    QStringList arguments;
+    for (int i = 0; i < argc; ++i)
+        arguments << QString::fromLocal8Bit(argv[i]);
+    parser.process(arguments);
+
+    const int eventCount = qMax(1, parser.value(eventsOption).toInt());
+    const int batch = qMax(1, parser.value(batchOption).toInt());
+
+    qputenv("WLR_BACKENDS", "headless");
+    qputenv("WLR_HEADLESS_OUTPUTS", "1");
+
+    qw_log::init();
+    WServer::initializeQPA();
+    QGuiApplication::setQuitOnLastWindowClosed(false);
+    QGuiApplication app(argc, argv);
+
+    QQmlEngine engine;
+    QQmlComponent contentComponent(&engine);
+    contentComponent.setData(contentQml, QUrl());
+    if (contentComponent.isError())
+        qFatal("%s", qPrintable(contentComponent.errorString()));
+
+    WServer server;
+    auto backend = server.attach<WBackend>();
+    auto seat = server.attach<WSeat>();
+    server.start();
+
+    auto renderer = WRenderHelper::createRenderer(backend->handle());
+    if (!renderer)
+        qFatal("Failed to create renderer");
+    auto allocator = qw_allocator::autocreate(*backend->handle(), *renderer);
+    renderer->init_wl_display(*server.handle());
+
+    WOutputRenderWindow window;
+    auto layout = new WOutputLayout(&server);
+    auto cursor = new WCursor(&window);
+    cursor->setEventWindow(&window);
+    cursor->setLayout(layout);
+    seat->setCursor(cursor);
+
+    MotionCounter counter;
+    window.installEventFilter(&counter);
+
+    QObject::connect(backend, &WBackend::outputAdded, &window, [&] (WOutput *output) {
+        auto content = qobject_cast<QQuickItem*>(contentComponent.create());
+        Q_ASSERT(content);
+        content->setParentItem(window.contentItem());
+
+        auto viewport = new WOutputViewport(window.contentItem());
+        viewport->setInput(content);
+        viewport->setOutput(output);
+        layout->add(output, QPoint(0, 0));
+    });
+
+    QObject::connect(&window, &WOutputRenderWindow::outputViewportInitialized,
+                     &window, [] (WOutputViewport *viewport) {
+        auto qwoutput = viewport->output()->handle();
+        qw_output_state newState;
+        if (!qwoutput->handle()->current_mode) {
+            if (auto mode = qwoutput->preferred_mode())
+                newState.set_mode(mode);
+        }
+        newState.set_enabled(true);
+        if (!qwoutput->commit_state(newState))
+            qCritical("commit failed on output %s", qwoutput->handle()->name);
+    });
+
+    window.init(renderer, allocator);
+    backend->handle()->start();
+
+    wlr_pointer pointer;
+    wlr_pointer_init(&pointer, &benchPointerImpl, "bench-pointer");
+    auto device = new WInputDevice(qw_input_device::from(&pointer.base));
+    seat->attachInputDevice(device);
+
+    auto replay = [&] (bool coalesce) {
+        cursor->setCoalesceMotion(coalesce);
+        cursor->setPosition(QPointF(960, 540));
+        app.processEvents();
+
+        const quint64 deliveredBefore = counter.count;
+        QElapsedTimer timer;
+        timer.start();
+        const qint64 cpuBegin = cpuTime();
+
+        uint32_t time = 0;
+        for (int i = 0; i < eventCount;) {
+            // A motion of the libinput batch, moves in a circle to hover different items
+            for (int j = 0; j < batch && i < eventCount; ++j, ++i) {
+                const double angle = i * 0.01;
+                wlr_pointer_motion_event event = {};
+                event.pointer = &pointer;
+                event.time_msec = time;
+                event.delta_x = event.unaccel_dx = std::cos(angle) * 4;
+                event.delta_y = event.unaccel_dy = std::sin(angle) * 4;
+                wl_signal_emit_mutable(&pointer.events.motion, &event);
+                wl_signal_emit_mutable(&pointer.events.frame, &pointer);
+                time += (i % 8) == 0;
+            }
+            // Back to the event loop, the end of the dispatching
+            app.processEvents();
+        }
+
+        const qint64 cpu = cpuTime() - cpuBegin;
+        const qint64 elapsed = timer.nsecsElapsed();
+        const quint64 delivered = counter.count - deliveredBefore;
+        printf("%-12s %10d %10llu %14.0f %14.3f\n", coalesce ? "coalesce" : "immediate",
+               eventCount, static_cast<unsigned long long>(delivered),
+               eventCount / (elapsed / 1e9), cpu / 1000.0 / eventCount);
+    };
+
+    // Wait the output is enabled and placed in the layout
+    QTimer::singleShot(500, &app, [&] {
+        printf("%-12s %10s %10s %14s %14s\n", "mode", "events", "delivered",
+               "events/s", "cpu(us)/event");
+        replay(false);
+        replay(true);
+
+        seat->detachInputDevice(device);
+        device->safeDeleteLater();
+        app.quit();
+    });
+
+    return app.exec();
+}
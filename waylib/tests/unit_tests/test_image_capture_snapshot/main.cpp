@@ -0,0 +1,135 @@
+// Copyright (C) 2026 UnionTech Software Technology Co., Ltd.
+// SPDX-License-Identifier: Apache-2.0 OR LGPL-3.0-only OR GPL-2.0-only OR GPL-3.0-only
+
+// The capture sessions of one surface copy their shm frames from one read back
+// of the client buffer.
+
+#include <wimagecapturesnapshot_p.h>
+#include <wtools.h>
+
+#include <qwbuffer.h>
+#include <qwbufferinterface.h>
+
+#include <QTest>
+
+#include <memory>
+
+extern "C" {
+#include <wlr/render/pixman.h>
+#include <wlr/render/wlr_renderer.h>
+}
+
+WAYLIB_SERVER_USE_NAMESPACE
+QW_USE_NAMESPACE
+
+// Stands for the client buffer and the shm buffers of the capture frames
+class ImageBuffer : public qw_buffer_interface
+{
+public:
+    explicit ImageBuffer(const QImage &image)
+        : m_image(image) {}
+
+    QImage m_image;
+
+    QW_INTERFACE(begin_data_ptr_access, bool, uint32_t flags, void **data, uint32_t *format, size_t *stride)
+    {
+        Q_UNUSED(flags);
+        *data = m_image.bits();
+        *format = WTools::toDrmFormat(m_image.format());
+        *stride = m_image.bytesPerLine();
+        return true;
+    }
+
+    QW_INTERFACE(end_data_ptr_access, void)
+    {
+    }
+};
+
+using BufferPointer = std::unique_ptr<qw_buffer, qw_buffer::droper>;
+
+static BufferPointer createBuffer(const QImage &image, ImageBuffer **impl = nullptr)
+{
+    auto buffer = new ImageBuffer(image);
+    if (impl)
+        *impl = buffer;
+    return BufferPointer(qw_buffer::create(buffer, image.width(), image.height()));
+}
+
+static QImage sourceImage(const QColor &color)
+{
+    QImage image(64, 32, QImage::Format_ARGB32_Premultiplied);
+    image.fill(color);
+    image.setPixelColor(3, 5, Qt::white);
+    return image;
+}
+
+class ImageCaptureSnapshotTest : public QObject
+{
+    Q_OBJECT
+
+    wlr_renderer *m_renderer = nullptr;
+
+private Q_SLOTS:
+    void initTestCase()
+    {
+        m_renderer = wlr_pixman_renderer_create();
+        QVERIFY(m_renderer);
+    }
+
+    void twoSessionsReadBackOnce()
+    {
+        auto src = createBuffer(sourceImage(Qt::red));
+        ImageBuffer *frame1 = nullptr;
+        ImageBuffer *frame2 = nullptr;
+        auto dst1 = createBuffer(sourceImage(Qt::black), &frame1);
+        auto dst2 = createBuffer(sourceImage(Qt::black), &frame2);
+
+        WImageCaptureSnapshot snapshot;
+        QVERIFY(snapshot.copy(dst1->handle(), src->handle(), m_renderer));
+        QVERIFY(snapshot.copy(dst2->handle(), src->handle(), m_renderer));
+        QCOMPARE(snapshot.readbacks(), quint64(1));
+
+        const QImage expected = sourceImage(Qt::red);
+        QCOMPARE(frame1->m_image, expected);
+        QCOMPARE(frame2->m_image, expected);
+    }
+
+    void newContentsReadBackAgain()
+    {
+        ImageBuffer *client = nullptr;
+        auto src = createBuffer(sourceImage(Qt::red), &client);
+        ImageBuffer *frame1 = nullptr;
+        ImageBuffer *frame2 = nullptr;
+        auto dst1 = createBuffer(sourceImage(Qt::black), &frame1);
+        auto dst2 = createBuffer(sourceImage(Qt::black), &frame2);
+
+        WImageCaptureSnapshot snapshot;
+        QVERIFY(snapshot.copy(dst1->handle(), src->handle(), m_renderer));
+        QVERIFY(snapshot.copy(dst2->handle(), src->handle(), m_renderer));
+
+        // The client reuses its buffer for the next commit
+        client->m_image.fill(Qt::blue);
+        snapshot.reset();
+
+        QVERIFY(snapshot.copy(dst1->handle(), src->handle(), m_renderer));
+        QVERIFY(snapshot.copy(dst2->handle(), src->handle(), m_renderer));
+        QCOMPARE(snapshot.readbacks(), quint64(2));
+        QCOMPARE(frame1->m_image.pixelColor(0, 0), QColor(Qt::blue));
+        QCOMPARE(frame2->m_image.pixelColor(0, 0), QColor(Qt::blue));
+
+        // Another buffer is attached
+        auto other = createBuffer(sourceImage(Qt::green));
+        QVERIFY(snapshot.copy(dst1->handle(), other->handle(), m_renderer));
+        QCOMPARE(snapshot.readbacks(), quint64(3));
+        QCOMPARE(frame1->m_image.pixelColor(0, 0), QColor(Qt::green));
+    }
+
+    void cleanupTestCase()
+    {
+        wlr_renderer_destroy(m_renderer);
+        m_renderer = nullptr;
+    }
+};
+
+QTEST_MAIN(ImageCaptureSnapshotTest)
+#include "main.moc"